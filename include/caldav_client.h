@@ -27,7 +27,11 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <stdbool.h>
-#include <string>
+#include <time.h>
+
+#include <esp_http_client.h>
+
+#include "caldav_types.h"
 
 /** @brief CalDAV error codes.
  */
@@ -41,8 +45,27 @@ typedef enum {
     CALDAV_ERROR_HTTP,              /**< HTTP protocol error. */
     CALDAV_ERROR_TIMEOUT,           /**< Operation timeout. */
     CALDAV_ERROR_NOT_FOUND,         /**< Resource not found. */
+    CALDAV_ERROR_INVALID_TOKEN,     /**< Sync token not accepted by the server, a full sync is required. */
+    CALDAV_ERROR_IN_PROGRESS,       /**< Asynchronous request has not finished yet. */
+    CALDAV_ERROR_NOT_MODIFIED,      /**< Resource has not changed since the given ETag (HTTP 304). */
+    CALDAV_ERROR_PRECONDITION,      /**< Resource has been changed or created on the server (HTTP 412). */
 } CalDAV_Error_t;
 
+/** @brief Event properties requested from the server. Combine them for CalDAV_Config_t.EventProperties.
+ */
+typedef enum {
+    CALDAV_EVENT_PROPERTY_UID = (1 << 0),           /**< Event unique identifier. */
+    CALDAV_EVENT_PROPERTY_SUMMARY = (1 << 1),       /**< Event title/summary. */
+    CALDAV_EVENT_PROPERTY_DESCRIPTION = (1 << 2),   /**< Event description. */
+    CALDAV_EVENT_PROPERTY_LOCATION = (1 << 3),      /**< Event location. */
+    CALDAV_EVENT_PROPERTY_DTSTART = (1 << 4),       /**< Start time. */
+    CALDAV_EVENT_PROPERTY_DTEND = (1 << 5),         /**< End time. */
+} CalDAV_Event_Property_t;
+
+/** @brief Maximum length of a calendar home including the terminator.
+ */
+#define CALDAV_CALENDAR_HOME_LENGTH         256
+
 /** @brief CalDAV client configuration.
  */
 typedef struct {
@@ -50,15 +73,62 @@ typedef struct {
     char Username[64];              /**< Username for authentication. */
     char Password[64];              /**< Password for authentication. */
     uint32_t TimeoutMs;             /**< Timeout in milliseconds. */
+    uint32_t EventProperties;       /**< Requested event properties (CalDAV_Event_Property_t) or 0 for all data. */
 } CalDAV_Config_t;
 
+/** @brief Asynchronous request of a CalDAV client (opaque).
+ */
+typedef struct CalDAV_Request_t CalDAV_Request_t;
+
+/** @brief          Completion callback of an asynchronous request. It is called from CalDAV_Client_Poll after the
+ *                  request has been released, so the next request can be started from the callback.
+ *  @param Error    Result of the request
+ *  @param p_Arg    User argument
+ */
+typedef void (*CalDAV_Request_Callback_t)(CalDAV_Error_t Error, void *p_Arg);
+
+/** @brief Request statistics of a client, collected with CONFIG_ESP32_CALDAV_STATS (all zero without it).
+ *         The times are in microseconds and belong to the last request. DNS lookup, TCP connect and TLS handshake
+ *         can not be told apart with esp_http_client and are reported together as ConnectUs.
+ */
+typedef struct {
+    uint32_t Requests;              /**< Number of finished requests. */
+    uint32_t Connections;           /**< Number of requests that had to establish a connection. */
+    uint64_t BytesReceived;         /**< Response bytes received from the network (compressed size). */
+    size_t PeakBufferLength;        /**< Largest response buffer of a request. */
+    size_t MinimumFreeHeap;         /**< Lowest free heap since boot, sampled after each request. */
+    uint32_t ConnectUs;             /**< Connection setup (DNS, TCP, TLS) or 0 if the connection was reused. */
+    uint32_t FirstByteUs;           /**< From sending the request to the first response header. */
+    uint32_t TransferUs;            /**< From the first response header to the end of the response body. */
+    uint32_t ParseUs;               /**< Time in the parser (within TransferUs for streamed responses). */
+    uint32_t TotalUs;               /**< From the start of the request until the response has been parsed. */
+    size_t ReceivedLength;          /**< Response bytes received from the network. */
+    size_t BufferLength;            /**< Size of the response buffer (working buffer or retained body). */
+    uint32_t Allocations;           /**< Heap allocations during the request. */
+    uint32_t Reallocations;         /**< Heap reallocations during the request. */
+} CalDAV_Stats_t;
+
 /** @brief CalDAV client handle.
  */
 typedef struct {
-    std::string ServerURL;          /**< CalDAV server URL. */
-    std::string Username;           /**< Username for authentication. */
-    std::string Password;           /**< Password for authentication. */
+    char ServerURL[256];            /**< CalDAV server URL. */
+    char Username[64];              /**< Username for authentication. */
+    char Password[64];              /**< Password for authentication. */
     uint32_t TimeoutMs;             /**< Timeout in milliseconds. */
+    uint32_t EventProperties;       /**< Requested event properties (CalDAV_Event_Property_t) or 0 for all data. */
+    size_t BaseLength;              /**< Length of the scheme and host part of the server URL. */
+    char Authorization[184];        /**< Value of the "Authorization" header, encoded once. */
+    char CalendarData[448];         /**< calendar-data element of a REPORT for the event properties. */
+    size_t CalendarDataLength;      /**< Length of the calendar-data element. */
+    esp_http_client_handle_t HTTP_Client;   /**< Persistent keep-alive HTTP client (created on first request). */
+    char CalendarHome[CALDAV_CALENDAR_HOME_LENGTH]; /**< Discovered calendar home (empty until discovered). */
+    CalDAV_Request_t *p_Request;    /**< Active asynchronous request or NULL. */
+    char *p_Buffer;                 /**< Parser working buffer of the fixed memory profile or NULL. */
+    char *p_Document;               /**< Request buffer of the fixed memory profile or NULL. */
+    void *p_Inflater;               /**< Inflater of the fixed memory profile or NULL. */
+    CalDAV_Request_t *p_Reserved;   /**< Request of the fixed memory profile or NULL. */
+    CalDAV_Stats_t Stats;           /**< Request statistics (CONFIG_ESP32_CALDAV_STATS). */
+    uint32_t RetryAfter;            /**< Seconds from the "Retry-After" header of the last response or 0. */
     bool IsInitialized;             /**< Indicates if the client is initialized. */
 } CalDAV_Client_t;
 
@@ -70,6 +140,8 @@ typedef struct {
     char *DisplayName;              /**< Display name for UI. */
     char *Description;              /**< Calendar description (optional). */
     char *Color;                    /**< Calendar color in hex format (optional). */
+    char *CTag;                     /**< Collection tag, changes with the content (optional). */
+    char *SyncToken;                /**< WebDAV sync token (RFC 6578) of the collection (optional). */
 } CalDAV_Calendar_t;
 
 /** @brief Calendar list data structure.
@@ -79,25 +151,125 @@ typedef struct {
     size_t Length;                  /**< Number of calendars in the array. */
 } CalDAV_Calendar_List_t;
 
-/** @brief Calendar event data structure.
+/** @brief Events of several calendars fetched with CalDAV_Calendars_Events_List_Multi.
+ */
+typedef struct {
+    CalDAV_Calendar_Event_t *Events;    /**< Pointer to an array of the events of all calendars. */
+    size_t *Calendar;                   /**< Index of the calendar path of each event. */
+    size_t Length;                      /**< Number of events in the arrays. */
+} CalDAV_Event_List_t;
+
+/** @brief Busy period reported by CalDAV_Calendars_Free_Busy.
+ */
+typedef struct {
+    time_t Start;                   /**< Start time in seconds since 1970 (UTC). */
+    time_t End;                     /**< End time in seconds since 1970 (UTC). */
+} CalDAV_Busy_Period_t;
+
+/** @brief Entry of an event index. It only holds the times of an event, so queries never touch the strings.
+ */
+typedef struct {
+    time_t Start;                   /**< Start time in seconds since 1970 (UTC). */
+    time_t End;                     /**< End time in seconds since 1970 (UTC). */
+    time_t Reach;                   /**< Latest end of this and all earlier entries (internal). */
+    uint32_t Event;                 /**< Position of the event in the indexed event array. */
+    uint16_t Calendar;              /**< Index of the calendar of the event (0 without calendar indices). */
+} CalDAV_Event_Index_Entry_t;
+
+/** @brief Events sorted by their start time, built with CalDAV_Event_Index_Build.
+ */
+typedef struct {
+    CalDAV_Event_Index_Entry_t *p_Entries;  /**< Entries sorted by start time. */
+    size_t Length;                          /**< Number of entries. */
+} CalDAV_Event_Index_t;
+
+/** @brief Slot of a calendar index (internal).
+ */
+typedef struct {
+    uint32_t Hash;                  /**< Hash of the name. */
+    uint16_t Calendar;              /**< Index of the calendar + 1 or 0 for an empty slot. */
+} CalDAV_Calendar_Index_Slot_t;
+
+/** @brief Hash table of the names and display names of a calendar list, built with CalDAV_Calendar_Index_Build.
+ */
+typedef struct {
+    const CalDAV_Calendar_List_t *p_Calendars;  /**< Indexed calendar list. */
+    CalDAV_Calendar_Index_Slot_t *p_Slots;      /**< Slots of the hash table. */
+    size_t Size;                                /**< Number of slots (power of two). */
+} CalDAV_Calendar_Index_t;
+
+/** @brief          Callback for each event delivered by CalDAV_Calendar_Events_Foreach.
+ *                  The event and its strings are only valid during the callback.
+ *  @param p_Event  Parsed event
+ *  @param p_Arg    User argument
+ *  @return         true to receive the next event, false to stop
+ */
+typedef bool (*CalDAV_Event_Callback_t)(const CalDAV_Calendar_Event_t *p_Event, void *p_Arg);
+
+/** @brief Recommended size of the sync token buffer for CalDAV_Calendar_Sync.
+ */
+#define CALDAV_SYNC_TOKEN_LENGTH            256
+
+/** @brief Recommended size of the ETag buffer for CalDAV_Calendar_Event_Get.
+ */
+#define CALDAV_ETAG_LENGTH                  96
+
+/** @brief Change of a calendar resource reported by CalDAV_Calendar_Sync.
+ *         All strings are only valid during the callback.
+ */
+typedef struct {
+    const char *Href;                       /**< Path of the changed resource. */
+    const char *ETag;                       /**< Entity tag of the new version (NULL if unknown). */
+    bool IsDeleted;                         /**< The resource has been deleted. */
+    const CalDAV_Calendar_Event_t *p_Event; /**< Event of the new version or NULL (deleted or no event in it). */
+} CalDAV_Sync_Change_t;
+
+/** @brief          Callback for each change delivered by CalDAV_Calendar_Sync.
+ *                  A changed resource with several events (e.g. recurrence overrides) is reported once per event.
+ *  @param p_Change Change
+ *  @param p_Arg    User argument
+ *  @return         true to receive the next change, false to stop
+ */
+typedef bool (*CalDAV_Sync_Callback_t)(const CalDAV_Sync_Change_t *p_Change, void *p_Arg);
+
+/** @brief Change of a calendar resource written by CalDAV_Events_Write_Multi.
+ */
+typedef struct {
+    const char *Href;                       /**< Path of the resource (e.g. "/calendars/user/personal/<UID>.ics"). */
+    const CalDAV_Calendar_Event_t *p_Event; /**< Event to store or NULL to delete the resource. */
+    char ETag[CALDAV_ETAG_LENGTH];          /**< Known ETag or empty for a new resource, receives the new ETag. */
+    CalDAV_Error_t Result;                  /**< Result of the change. */
+} CalDAV_Event_Change_t;
+
+/** @brief Resource of a calendar held by an event cache.
+ */
+typedef struct {
+    char *Href;                             /**< Path of the resource. */
+    char *ETag;                             /**< Entity tag of the cached version (NULL if not fetched yet). */
+    CalDAV_Calendar_Event_t *p_Events;      /**< Events of the resource (NULL if none). */
+    size_t Length;                          /**< Number of events. */
+    bool IsSeen;                            /**< Reported by the server during the current refresh (internal). */
+    bool IsStale;                           /**< The cached version is outdated (internal). */
+} CalDAV_Event_Cache_Entry_t;
+
+/** @brief Bounded local copy of the events of a calendar, indexed by the href and ETag of each resource.
  */
 typedef struct {
-    char *UID;                      /**< Event unique identifier. */
-    char *Summary;                  /**< Event title/summary. */
-    char *Description;              /**< Event description (optional). */
-    char *StartTime;                /**< Start time in ISO 8601 format. */
-    char *EndTime;                  /**< End time in ISO 8601 format. */
-    char *Location;                 /**< Event location (optional). */
-} CalDAV_Calendar_Event_t;
+    CalDAV_Event_Cache_Entry_t *p_Entries;  /**< Cached resources. */
+    size_t Length;                          /**< Number of cached resources. */
+    size_t MaxEntries;                      /**< Maximum number of cached resources. */
+} CalDAV_Event_Cache_t;
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 /** @brief          Initializes the CalDAV client with given configuration.
+ *                  With CONFIG_ESP32_CALDAV_FIXED_MEMORY the buffers of the client are allocated here once.
  *  @param p_Config Pointer to configuration structure (must not be NULL)
  *  @param p_Client Pointer to CalDAV client handle to initialize
- *  @return         CALDAV_ERROR_OK on success, error code otherwise
+ *  @return         CALDAV_ERROR_OK on success, CALDAV_ERROR_NO_MEM if the buffers can not be allocated,
+ *                  error code otherwise
  */
 CalDAV_Error_t CalDAV_Client_Init(const CalDAV_Config_t *p_Config, CalDAV_Client_t *p_Client);
 
@@ -112,14 +284,109 @@ void CalDAV_Client_Deinit(CalDAV_Client_t *p_Client);
  */
 CalDAV_Error_t CalDAV_Test_Connection(CalDAV_Client_t *p_Client);
 
+/** @brief              Returns the request statistics of a client.
+ *                      The counters are cumulative since CalDAV_Client_Init, the times and the per request values
+ *                      belong to the last finished request. The allocation counters cover the whole library, so
+ *                      with several clients running concurrently a request is also charged with the others.
+ *  @param p_Client     CalDAV client handle (must not be NULL)
+ *  @param p_Stats      Pointer to store the statistics
+ *  @return             CALDAV_ERROR_OK on success, CALDAV_ERROR_INVALID_ARG if parameters are NULL,
+ *                      CALDAV_ERROR_NOT_INITIALIZED if the client is not initialized
+ */
+CalDAV_Error_t CalDAV_Client_Get_Stats(const CalDAV_Client_t *p_Client, CalDAV_Stats_t *p_Stats);
+
+/** @brief              Returns the calendar home discovered by CalDAV_Calendars_List.
+ *                      Store it (e.g. in NVS) and restore it with CalDAV_Client_Set_Calendar_Home after a reboot
+ *                      to skip the discovery.
+ *  @param p_Client     CalDAV client handle (must not be NULL)
+ *  @param p_Buffer     Buffer for the calendar home (path or URL)
+ *  @param Size         Size of the buffer
+ *  @return             CALDAV_ERROR_OK on success, CALDAV_ERROR_NOT_FOUND if nothing has been discovered yet,
+ *                      CALDAV_ERROR_NO_MEM if the buffer is too small
+ */
+CalDAV_Error_t CalDAV_Client_Get_Calendar_Home(const CalDAV_Client_t *p_Client, char *p_Buffer, size_t Size);
+
+/** @brief                  Sets the calendar home of a client, e.g. one stored from CalDAV_Client_Get_Calendar_Home.
+ *                          If the server does not know the calendar home anymore, it is discovered again.
+ *  @param p_Client         CalDAV client handle (must not be NULL)
+ *  @param p_CalendarHome   Calendar home (path or URL) or NULL to discover it with the next list
+ *  @return                 CALDAV_ERROR_OK on success, CALDAV_ERROR_INVALID_ARG if the calendar home is longer
+ *                          than CALDAV_CALENDAR_HOME_LENGTH - 1 characters, error code otherwise
+ */
+CalDAV_Error_t CalDAV_Client_Set_Calendar_Home(CalDAV_Client_t *p_Client, const char *p_CalendarHome);
+
+/** @brief          Advances the asynchronous request of a client as far as possible without waiting.
+ *                  With CONFIG_ESP32_CALDAV_ASYNC the HTTP client runs in asynchronous mode and the call returns
+ *                  as soon as the request has to wait for the network. Without it, the first call completes
+ *                  the request. Call it from the main loop until it returns something else than
+ *                  CALDAV_ERROR_IN_PROGRESS.
+ *  @param p_Client CalDAV client handle (must not be NULL)
+ *  @return         CALDAV_ERROR_IN_PROGRESS while the request runs, the result of the request when it has
+ *                  finished, CALDAV_ERROR_OK if no request is active
+ */
+CalDAV_Error_t CalDAV_Client_Poll(CalDAV_Client_t *p_Client);
+
+/** @brief          Cancels the asynchronous request of a client.
+ *                  The connection is closed and the partial result is released. The completion callback is not called.
+ *  @param p_Client CalDAV client handle (must not be NULL)
+ */
+void CalDAV_Client_Cancel(CalDAV_Client_t *p_Client);
+
 /** @brief              Lists all available calendars from the CalDAV server.
+ *                      On the first call the calendar home is discovered (current-user-principal and
+ *                      calendar-home-set) and kept in the client, later calls list it directly.
  *  @param p_Client     CalDAV client handle (must not be NULL)
  *  @param p_Calendars  Pointer to calendar list (will be allocated, caller must free with CalDAV_Calendars_Free)
+ *                      The calendars and all strings share one memory arena.
  *  @return             CALDAV_ERROR_OK on success, error code otherwise
  */
 CalDAV_Error_t CalDAV_Calendars_List(CalDAV_Client_t *p_Client,
                                      CalDAV_Calendar_List_t *p_Calendars);
 
+/** @brief              Starts listing the calendars without blocking. The request is advanced with CalDAV_Client_Poll.
+ *                      A client runs one request at a time, blocking calls fail while the request is active.
+ *  @param p_Client     CalDAV client handle (must not be NULL)
+ *  @param p_Calendars  Pointer to calendar list, filled when the request has finished (must stay valid until then,
+ *                      caller must free with CalDAV_Calendars_Free)
+ *  @param on_Complete  Completion callback (optional)
+ *  @param p_Arg        User argument for the completion callback
+ *  @return             CALDAV_ERROR_OK if the request has been started, error code otherwise
+ */
+CalDAV_Error_t CalDAV_Calendars_List_Async(CalDAV_Client_t *p_Client,
+                                           CalDAV_Calendar_List_t *p_Calendars,
+                                           CalDAV_Request_Callback_t on_Complete,
+                                           void *p_Arg);
+
+/** @brief              Checks if a calendar has changed since it was listed.
+ *                      Uses a Depth: 0 PROPFIND for the sync-token and ctag of the calendar only and compares
+ *                      them with the values stored in the calendar. If the server offers neither, the calendar
+ *                      is always reported as changed. The stored values are not updated, list the calendars
+ *                      again after processing a change.
+ *  @param p_Client     CalDAV client handle (must not be NULL)
+ *  @param p_Calendar   Calendar from CalDAV_Calendars_List (must not be NULL)
+ *  @param p_Changed    Pointer to store the result (true if the calendar has changed)
+ *  @return             CALDAV_ERROR_OK on success, CALDAV_ERROR_NOT_FOUND if the calendar does not exist anymore,
+ *                      error code otherwise
+ */
+CalDAV_Error_t CalDAV_Calendar_Has_Changed(CalDAV_Client_t *p_Client,
+                                           const CalDAV_Calendar_t *p_Calendar,
+                                           bool *p_Changed);
+
+/** @brief                  Reads the change tag of a calendar with a Depth: 0 PROPFIND. The tag is the sync-token or
+ *                          the ctag if the server offers no sync-token, so it changes with every modification of
+ *                          the calendar and can be compared with the tag of an earlier call.
+ *  @param p_Client         CalDAV client handle (must not be NULL)
+ *  @param p_CalendarPath   Path to the calendar resource (e.g. "/calendars/user/calendar-name/")
+ *  @param p_Tag            Buffer for the tag, empty if the server offers neither tag (must not be NULL)
+ *  @param TagSize          Size of the tag buffer (see CALDAV_SYNC_TOKEN_LENGTH)
+ *  @return                 CALDAV_ERROR_OK on success, CALDAV_ERROR_NOT_FOUND if the calendar does not exist,
+ *                          CALDAV_ERROR_NO_MEM if the tag does not fit, error code otherwise
+ */
+CalDAV_Error_t CalDAV_Calendar_Get_Tag(CalDAV_Client_t *p_Client,
+                                       const char *p_CalendarPath,
+                                       char *p_Tag,
+                                       size_t TagSize);
+
 /** @brief              Finds a calendar by name or display name in the calendar list.
  *  @param p_Calendars  Pointer to calendar list (must not be NULL)
  *  @param p_Name       Calendar name to search for (searches both Name and DisplayName fields)
@@ -134,6 +401,7 @@ CalDAV_Error_t CalDAV_Calendar_Find_By_Name(const CalDAV_Calendar_List_t *p_Cale
 /** @brief                  Lists all events from the configured calendar.
  *  @param p_Client         CalDAV client handle (must not be NULL, calendar_path must be set in config)
  *  @param p_Events         Pointer to event array pointer (will be allocated, caller must free with CalDAV_Events_Free)
+ *                          The events and all strings share one memory arena.
  *  @param p_Length         Pointer to store the number of events found
  *  @param p_CalendarPath   Path to the calendar resource (e.g. "/calendars/user/calendar-name/")
  *  @param p_StartTime      Pointer to time range filter start as UTC time
@@ -147,12 +415,390 @@ CalDAV_Error_t CalDAV_Calendar_Events_List(CalDAV_Client_t *p_Client,
                                            const struct tm* p_StartTime,
                                            const struct tm* p_EndTime);
 
+/** @brief                  Starts listing the events of a calendar without blocking. The request is advanced with
+ *                          CalDAV_Client_Poll. A client runs one request at a time, blocking calls fail while the
+ *                          request is active.
+ *  @param p_Client         CalDAV client handle (must not be NULL)
+ *  @param p_Events         Pointer to event array pointer, set when the request has finished (caller must free
+ *                          with CalDAV_Events_Free)
+ *  @param p_Length         Pointer to store the number of events found
+ *  @param p_CalendarPath   Path to the calendar resource (e.g. "/calendars/user/calendar-name/")
+ *  @param p_StartTime      Pointer to time range filter start as UTC time
+ *  @param p_EndTime        Pointer to time range filter end as UTC time
+ *  @param on_Complete      Completion callback (optional)
+ *  @param p_Arg            User argument for the completion callback
+ *  @return                 CALDAV_ERROR_OK if the request has been started, error code otherwise
+ */
+CalDAV_Error_t CalDAV_Calendar_Events_List_Async(CalDAV_Client_t *p_Client,
+                                                 CalDAV_Calendar_Event_t **p_Events,
+                                                 size_t *p_Length,
+                                                 const char *p_CalendarPath,
+                                                 const struct tm *p_StartTime,
+                                                 const struct tm *p_EndTime,
+                                                 CalDAV_Request_Callback_t on_Complete,
+                                                 void *p_Arg);
+
+/** @brief                  Lists all events from a calendar into a caller-supplied buffer.
+ *                          No heap memory is used for the result. The events are placed at the start and the
+ *                          strings at the end of the buffer. The result is valid as long as the buffer is.
+ *  @param p_Client         CalDAV client handle (must not be NULL)
+ *  @param p_Buffer         Buffer for the result (must not be NULL)
+ *  @param Size             Size of the buffer
+ *  @param p_Events         Pointer to event array pointer (points into p_Buffer)
+ *  @param p_Length         Pointer to store the number of events found
+ *  @param p_CalendarPath   Path to the calendar resource (e.g. "/calendars/user/calendar-name/")
+ *  @param p_StartTime      Pointer to time range filter start as UTC time
+ *  @param p_EndTime        Pointer to time range filter end as UTC time
+ *  @return                 CALDAV_ERROR_OK on success, CALDAV_ERROR_NO_MEM if the buffer is too small,
+ *                          error code otherwise
+ */
+CalDAV_Error_t CalDAV_Calendar_Events_List_Static(CalDAV_Client_t *p_Client,
+                                                  void *p_Buffer,
+                                                  size_t Size,
+                                                  CalDAV_Calendar_Event_t **p_Events,
+                                                  size_t *p_Length,
+                                                  const char *p_CalendarPath,
+                                                  const struct tm *p_StartTime,
+                                                  const struct tm *p_EndTime);
+
+/** @brief                  Lists the events of several calendars in one call.
+ *                          The request body is built once and the REPORTs are sent one after another over the
+ *                          kept-alive connection. All events share one memory arena.
+ *  @param p_Client         CalDAV client handle (must not be NULL)
+ *  @param pp_CalendarPaths Array of calendar paths (must not be NULL)
+ *  @param Count            Number of calendar paths
+ *  @param p_StartTime      Pointer to time range filter start as UTC time
+ *  @param p_EndTime        Pointer to time range filter end as UTC time
+ *  @param Sort             true to sort the events of all calendars by start time, false to keep them grouped
+ *                          by calendar in the order of the paths
+ *  @param p_List           Pointer to the event list (caller must free with CalDAV_Event_List_Free)
+ *  @param p_Errors         Array of Count results for each calendar or NULL. If given, a failed calendar is
+ *                          reported here and the other calendars are still listed, otherwise the first failed
+ *                          calendar fails the call.
+ *  @return                 CALDAV_ERROR_OK on success, error code otherwise
+ */
+CalDAV_Error_t CalDAV_Calendars_Events_List_Multi(CalDAV_Client_t *p_Client,
+                                                  const char *const *pp_CalendarPaths,
+                                                  size_t Count,
+                                                  const struct tm *p_StartTime,
+                                                  const struct tm *p_EndTime,
+                                                  bool Sort,
+                                                  CalDAV_Event_List_t *p_List,
+                                                  CalDAV_Error_t *p_Errors);
+
+/** @brief                  Queries the busy time of several calendars with free-busy-query REPORTs (RFC 4791, 7.10).
+ *                          The server answers each REPORT with a single VFREEBUSY instead of the events, so no event
+ *                          strings are received or stored. The busy periods of all calendars are merged into a
+ *                          sorted array of periods that neither overlap nor touch.
+ *  @param p_Client         CalDAV client handle (must not be NULL)
+ *  @param pp_CalendarPaths Array of calendar paths (must not be NULL)
+ *  @param Count            Number of calendar paths
+ *  @param p_StartTime      Pointer to time range start as UTC time
+ *  @param p_EndTime        Pointer to time range end as UTC time
+ *  @param p_Periods        Array to store the merged busy periods (must not be NULL)
+ *  @param Max              Size of the array
+ *  @param p_Length         Pointer to store the number of stored periods
+ *  @param p_Errors         Array of Count results for each calendar or NULL. If given, a failed calendar is
+ *                          reported here, none of its periods are stored and the other calendars are still
+ *                          queried, otherwise the first failed calendar fails the call.
+ *  @return                 CALDAV_ERROR_OK on success, CALDAV_ERROR_NO_MEM if the array is too small (the earliest
+ *                          periods are stored), error code otherwise
+ */
+CalDAV_Error_t CalDAV_Calendars_Free_Busy(CalDAV_Client_t *p_Client,
+                                          const char *const *pp_CalendarPaths,
+                                          size_t Count,
+                                          const struct tm *p_StartTime,
+                                          const struct tm *p_EndTime,
+                                          CalDAV_Busy_Period_t *p_Periods,
+                                          size_t Max,
+                                          size_t *p_Length,
+                                          CalDAV_Error_t *p_Errors);
+
+/** @brief                  Calls a callback for each event of a calendar while the response is received.
+ *                          No event array is allocated. The callback can stop the iteration early, the rest
+ *                          of the response is then skipped so the kept-alive connection stays usable.
+ *  @param p_Client         CalDAV client handle (must not be NULL)
+ *  @param p_CalendarPath   Path to the calendar resource (e.g. "/calendars/user/calendar-name/")
+ *  @param p_StartTime      Pointer to time range filter start as UTC time
+ *  @param p_EndTime        Pointer to time range filter end as UTC time
+ *  @param Callback         Callback for each event (must not be NULL)
+ *  @param p_Arg            User argument for the callback
+ *  @return                 CALDAV_ERROR_OK on success (also when stopped by the callback), error code otherwise
+ */
+CalDAV_Error_t CalDAV_Calendar_Events_Foreach(CalDAV_Client_t *p_Client,
+                                              const char *p_CalendarPath,
+                                              const struct tm *p_StartTime,
+                                              const struct tm *p_EndTime,
+                                              CalDAV_Event_Callback_t Callback,
+                                              void *p_Arg);
+
+/** @brief                  Fetches a single calendar object resource with a conditional GET.
+ *                          With a stored ETag the request carries an If-None-Match header, so an unchanged resource
+ *                          is answered with an empty 304 response. The events of the resource are passed to the
+ *                          callback while the response is received, recurring events are reported once.
+ *  @param p_Client         CalDAV client handle (must not be NULL)
+ *  @param p_Href           Path of the resource (e.g. the href of a sync change)
+ *  @param p_ETag           ETag of the stored copy or empty string, receives the new ETag (optional)
+ *  @param ETagSize         Size of the ETag buffer (see CALDAV_ETAG_LENGTH)
+ *  @param Callback         Callback for each event (must not be NULL)
+ *  @param p_Arg            User argument for the callback
+ *  @return                 CALDAV_ERROR_OK on success, CALDAV_ERROR_NOT_MODIFIED if the resource still has the
+ *                          given ETag (the callback is not called), CALDAV_ERROR_NOT_FOUND if the resource does
+ *                          not exist, error code otherwise
+ */
+CalDAV_Error_t CalDAV_Calendar_Event_Get(CalDAV_Client_t *p_Client,
+                                         const char *p_Href,
+                                         char *p_ETag,
+                                         size_t ETagSize,
+                                         CalDAV_Event_Callback_t Callback,
+                                         void *p_Arg);
+
+/** @brief              Creates or replaces a calendar object resource with a single event.
+ *                      The event is serialized as iCalendar directly into the request body. Without an ETag the
+ *                      resource is created with "If-None-Match: *", so an existing resource is never overwritten.
+ *                      With an ETag it is replaced with "If-Match", so a change on the server is never lost.
+ *                      A replace writes the whole calendar object: only UID, SUMMARY, DESCRIPTION, LOCATION and
+ *                      the start and end in UTC are written, every other property of the stored object (RRULE,
+ *                      EXDATE, RECURRENCE-ID overrides, VALARM, ATTENDEE, ORGANIZER, TZID, ...) is lost. A
+ *                      recurring event becomes a single event. Only replace resources written by this client.
+ *  @param p_Client     CalDAV client handle (must not be NULL)
+ *  @param p_Href       Path of the resource (e.g. "/calendars/user/personal/<UID>.ics")
+ *  @param p_Event      Event to store, UID and a start time are required (must not be NULL)
+ *  @param p_ETag       Known ETag or empty string for a new resource, receives the new ETag (optional). The ETag
+ *                      is empty if the server has not returned one, e.g. because it has modified the event.
+ *  @param ETagSize     Size of the ETag buffer (see CALDAV_ETAG_LENGTH)
+ *  @return             CALDAV_ERROR_OK on success, CALDAV_ERROR_PRECONDITION if the resource exists (create) or
+ *                      has been changed on the server (replace), CALDAV_ERROR_HTTP if the connection was lost
+ *                      after the request was sent (the request is not repeated and the resource may have been
+ *                      stored, so it has to be checked again), error code otherwise
+ */
+CalDAV_Error_t CalDAV_Event_Put(CalDAV_Client_t *p_Client,
+                                const char *p_Href,
+                                const CalDAV_Calendar_Event_t *p_Event,
+                                char *p_ETag,
+                                size_t ETagSize);
+
+/** @brief              Deletes a calendar object resource.
+ *  @param p_Client     CalDAV client handle (must not be NULL)
+ *  @param p_Href       Path of the resource
+ *  @param p_ETag       Known ETag to delete only this version ("If-Match") or NULL / empty string to delete
+ *                      any version
+ *  @return             CALDAV_ERROR_OK on success, CALDAV_ERROR_PRECONDITION if the resource has been changed on
+ *                      the server, CALDAV_ERROR_NOT_FOUND if it does not exist, CALDAV_ERROR_HTTP if the
+ *                      connection was lost after the request was sent (the resource may have been deleted),
+ *                      error code otherwise
+ */
+CalDAV_Error_t CalDAV_Event_Delete(CalDAV_Client_t *p_Client, const char *p_Href, const char *p_ETag);
+
+/** @brief              Writes several changes one after another over the kept-alive connection.
+ *                      Each change is a CalDAV_Event_Put or CalDAV_Event_Delete and the request body buffer is
+ *                      shared by all of them. A failed change does not stop the others. A replaced resource loses
+ *                      all properties the event structure has no field for, see CalDAV_Event_Put.
+ *  @param p_Client     CalDAV client handle (must not be NULL)
+ *  @param p_Changes    Array of changes, the ETag and the result of each change are updated (must not be NULL)
+ *  @param Count        Number of changes
+ *  @return             CALDAV_ERROR_OK if all changes were written, the result of the first failed change
+ *                      otherwise
+ */
+CalDAV_Error_t CalDAV_Events_Write_Multi(CalDAV_Client_t *p_Client, CalDAV_Event_Change_t *p_Changes, size_t Count);
+
+/** @brief                  Synchronizes a calendar incrementally with a sync-collection REPORT (RFC 6578).
+ *                          Only resources that were added, changed or deleted since the sync token was issued
+ *                          are transferred. With an empty token all resources are reported (initial sync).
+ *                          The token is replaced with the new token when all changes have been delivered.
+ *  @param p_Client         CalDAV client handle (must not be NULL)
+ *  @param p_CalendarPath   Path to the calendar resource (e.g. "/calendars/user/calendar-name/")
+ *  @param p_SyncToken      Sync token of the last sync or empty string, receives the new token (must not be NULL)
+ *  @param TokenSize        Size of the token buffer (see CALDAV_SYNC_TOKEN_LENGTH)
+ *  @param Callback         Callback for each change (must not be NULL)
+ *  @param p_Arg            User argument for the callback
+ *  @return                 CALDAV_ERROR_OK on success (also when stopped by the callback, the token is then kept),
+ *                          CALDAV_ERROR_INVALID_TOKEN if the token has expired (the token is cleared and a full sync
+ *                          is required), CALDAV_ERROR_NO_MEM if the new token does not fit, error code otherwise
+ */
+CalDAV_Error_t CalDAV_Calendar_Sync(CalDAV_Client_t *p_Client,
+                                    const char *p_CalendarPath,
+                                    char *p_SyncToken,
+                                    size_t TokenSize,
+                                    CalDAV_Sync_Callback_t Callback,
+                                    void *p_Arg);
+
+/** @brief              Initializes an event cache.
+ *                      The entry table is allocated once, the cache never holds more than MaxEntries resources.
+ *  @param p_Cache      Event cache to initialize (must not be NULL)
+ *  @param MaxEntries   Maximum number of cached resources (must not be 0)
+ *  @return             CALDAV_ERROR_OK on success, error code otherwise
+ */
+CalDAV_Error_t CalDAV_Event_Cache_Init(CalDAV_Event_Cache_t *p_Cache, size_t MaxEntries);
+
+/** @brief          Releases an event cache and all cached events.
+ *  @param p_Cache  Event cache
+ */
+void CalDAV_Event_Cache_Deinit(CalDAV_Event_Cache_t *p_Cache);
+
+/** @brief                  Brings an event cache up to date with a calendar.
+ *                          A calendar-query REPORT without calendar data lists the href and ETag of every resource
+ *                          in the time range first. Only new and changed resources are fetched afterwards with
+ *                          calendar-multiget REPORTs, resources that are gone are removed from the cache.
+ *  @param p_Client         CalDAV client handle (must not be NULL)
+ *  @param p_Cache          Event cache (must not be NULL)
+ *  @param p_CalendarPath   Path to the calendar resource (e.g. "/calendars/user/calendar-name/")
+ *  @param p_StartTime      Pointer to time range filter start as UTC time
+ *  @param p_EndTime        Pointer to time range filter end as UTC time
+ *  @param p_Changed        Pointer to store the number of added, changed and removed resources (optional)
+ *  @return                 CALDAV_ERROR_OK on success, CALDAV_ERROR_NO_MEM if the calendar has more resources
+ *                          than the cache can hold (the cache is still updated as far as possible),
+ *                          error code otherwise
+ */
+CalDAV_Error_t CalDAV_Event_Cache_Refresh(CalDAV_Client_t *p_Client,
+                                          CalDAV_Event_Cache_t *p_Cache,
+                                          const char *p_CalendarPath,
+                                          const struct tm *p_StartTime,
+                                          const struct tm *p_EndTime,
+                                          size_t *p_Changed);
+
+/** @brief          Calls a callback for each cached event.
+ *  @param p_Cache  Event cache (must not be NULL)
+ *  @param Callback Callback for each event (must not be NULL)
+ *  @param p_Arg    User argument for the callback
+ *  @return         CALDAV_ERROR_OK on success (also when stopped by the callback), error code otherwise
+ */
+CalDAV_Error_t CalDAV_Event_Cache_Foreach(const CalDAV_Event_Cache_t *p_Cache,
+                                          CalDAV_Event_Callback_t Callback,
+                                          void *p_Arg);
+
+/** @brief              Writes an event cache to a file, e.g. on a mounted SPIFFS or LittleFS partition.
+ *                      The file can be loaded after a reboot, so the next refresh only fetches the changes.
+ *                      The data is written to "<p_FilePath>.tmp" first, which replaces the previous file when it is
+ *                      complete, so an interrupted save keeps the previous file.
+ *  @param p_Cache      Event cache (must not be NULL)
+ *  @param p_FilePath   Path of the file (e.g. "/littlefs/calendar.bin", at most 123 characters)
+ *  @return             CALDAV_ERROR_OK on success, CALDAV_ERROR_INVALID_ARG if the path is too long,
+ *                      CALDAV_ERROR_FAIL if the file cannot be written (the previous file is kept)
+ */
+CalDAV_Error_t CalDAV_Event_Cache_Save(const CalDAV_Event_Cache_t *p_Cache, const char *p_FilePath);
+
+/** @brief              Replaces the content of an event cache with a file written by CalDAV_Event_Cache_Save.
+ *                      Without the file, the temporary file of an interrupted save is loaded if it is complete.
+ *  @param p_Cache      Initialized event cache (must not be NULL)
+ *  @param p_FilePath   Path of the file
+ *  @return             CALDAV_ERROR_OK on success, CALDAV_ERROR_NOT_FOUND if the file does not exist,
+ *                      CALDAV_ERROR_NO_MEM if the file has more resources than the cache can hold,
+ *                      CALDAV_ERROR_FAIL if the file is invalid, incomplete or damaged (the cache is then empty)
+ */
+CalDAV_Error_t CalDAV_Event_Cache_Load(CalDAV_Event_Cache_t *p_Cache, const char *p_FilePath);
+
+/** @brief              Writes a calendar list with the ctags and sync tokens to a file.
+ *                      Loaded after a reboot, the calendars can be shown at once and checked with
+ *                      CalDAV_Calendar_Has_Changed instead of being listed again. Like CalDAV_Event_Cache_Save,
+ *                      the previous file is only replaced by a complete file.
+ *  @param p_Calendars  Calendar list (must not be NULL)
+ *  @param p_FilePath   Path of the file (e.g. "/littlefs/calendars.bin", at most 123 characters)
+ *  @return             CALDAV_ERROR_OK on success, CALDAV_ERROR_INVALID_ARG if the path is too long,
+ *                      CALDAV_ERROR_FAIL if the file cannot be written (the previous file is kept)
+ */
+CalDAV_Error_t CalDAV_Calendars_Save(const CalDAV_Calendar_List_t *p_Calendars, const char *p_FilePath);
+
+/** @brief              Reads a calendar list written by CalDAV_Calendars_Save.
+ *  @param p_Calendars  Pointer to store the calendar list (caller must free with CalDAV_Calendars_Free)
+ *  @param p_FilePath   Path of the file
+ *  @return             CALDAV_ERROR_OK on success, CALDAV_ERROR_NOT_FOUND if the file does not exist,
+ *                      CALDAV_ERROR_NO_MEM if out of memory, CALDAV_ERROR_FAIL if the file is invalid, incomplete
+ *                      or damaged
+ */
+CalDAV_Error_t CalDAV_Calendars_Load(CalDAV_Calendar_List_t *p_Calendars, const char *p_FilePath);
+
+/** @brief              Builds an index of events sorted by start time, e.g. of the result of
+ *                      CalDAV_Calendar_Events_List or CalDAV_Calendars_Events_List_Multi.
+ *                      Events without a start time are not indexed. The index does not reference the events, the
+ *                      position of an entry in the event array identifies the event.
+ *  @param p_Events     Event array (must not be NULL if Length is not 0)
+ *  @param Length       Number of events
+ *  @param p_Calendar   Index of the calendar of each event (e.g. CalDAV_Event_List_t.Calendar) or NULL
+ *  @param p_Index      Index to build (caller must free with CalDAV_Event_Index_Free)
+ *  @return             CALDAV_ERROR_OK on success, error code otherwise
+ */
+CalDAV_Error_t CalDAV_Event_Index_Build(const CalDAV_Calendar_Event_t *p_Events,
+                                        size_t Length,
+                                        const size_t *p_Calendar,
+                                        CalDAV_Event_Index_t *p_Index);
+
+/** @brief              Finds the events that overlap a time range in O(log n), ordered by start time.
+ *                      An event overlaps when it starts before the end and ends after the start of the range.
+ *                      Events without duration overlap when they start inside the range.
+ *  @param p_Index      Event index (must not be NULL)
+ *  @param Start        Start of the range in seconds since 1970 (UTC)
+ *  @param End          End of the range in seconds since 1970 (UTC)
+ *  @param p_Entries    Array to store the entries
+ *  @param Max          Size of the array
+ *  @param p_Count      Pointer to store the number of stored entries
+ *  @return             CALDAV_ERROR_OK on success, error code otherwise
+ */
+CalDAV_Error_t CalDAV_Event_Index_Find_Range(const CalDAV_Event_Index_t *p_Index,
+                                             time_t Start,
+                                             time_t End,
+                                             CalDAV_Event_Index_Entry_t *p_Entries,
+                                             size_t Max,
+                                             size_t *p_Count);
+
+/** @brief              Finds the next events that start at or after a point in time in O(log n).
+ *                      Events that are already running are not included, see CalDAV_Event_Index_Find_Range.
+ *  @param p_Index      Event index (must not be NULL)
+ *  @param Now          Point in time in seconds since 1970 (UTC)
+ *  @param p_Entries    Array to store the entries
+ *  @param Max          Size of the array (number of events to find)
+ *  @param p_Count      Pointer to store the number of stored entries
+ *  @return             CALDAV_ERROR_OK on success, error code otherwise
+ */
+CalDAV_Error_t CalDAV_Event_Index_Find_Next(const CalDAV_Event_Index_t *p_Index,
+                                            time_t Now,
+                                            CalDAV_Event_Index_Entry_t *p_Entries,
+                                            size_t Max,
+                                            size_t *p_Count);
+
+/** @brief          Frees memory allocated for an event index.
+ *  @param p_Index  Event index to free
+ */
+void CalDAV_Event_Index_Free(CalDAV_Event_Index_t *p_Index);
+
+/** @brief              Builds a hash table of the names and display names of a calendar list.
+ *                      The calendar list must be kept as long as the index is used.
+ *  @param p_Calendars  Calendar list (must not be NULL)
+ *  @param p_Index      Index to build (caller must free with CalDAV_Calendar_Index_Free)
+ *  @return             CALDAV_ERROR_OK on success, CALDAV_ERROR_INVALID_ARG if the list has more than 65535
+ *                      calendars, error code otherwise
+ */
+CalDAV_Error_t CalDAV_Calendar_Index_Build(const CalDAV_Calendar_List_t *p_Calendars, CalDAV_Calendar_Index_t *p_Index);
+
+/** @brief              Finds a calendar by name or display name in O(1), like CalDAV_Calendar_Find_By_Name.
+ *  @param p_Index      Calendar index (must not be NULL)
+ *  @param p_Name       Calendar name to search for (searches both Name and DisplayName fields)
+ *  @param pp_Calendar  Pointer to store the found calendar pointer (NULL if not found)
+ *  @return             CALDAV_ERROR_OK if found, CALDAV_ERROR_NOT_FOUND if calendar doesn't exist,
+ *                      CALDAV_ERROR_INVALID_ARG if parameters are NULL
+ */
+CalDAV_Error_t CalDAV_Calendar_Index_Find(const CalDAV_Calendar_Index_t *p_Index,
+                                          const char *p_Name,
+                                          CalDAV_Calendar_t **pp_Calendar);
+
+/** @brief          Frees memory allocated for a calendar index.
+ *  @param p_Index  Calendar index to free
+ */
+void CalDAV_Calendar_Index_Free(CalDAV_Calendar_Index_t *p_Index);
+
 /** @brief          Frees memory allocated for event data.
+ *                  The events and their strings are released at once. For results of
+ *                  CalDAV_Calendar_Events_List_Static the call does nothing.
  *  @param p_Events Event array to free
- *  @param Length   Number of events in the array
+ *  @param Length   Number of events in the array (unused, kept for compatibility)
  */
 void CalDAV_Events_Free(CalDAV_Calendar_Event_t *p_Events, size_t Length);
 
+/** @brief          Frees memory allocated for an event list of CalDAV_Calendars_Events_List_Multi.
+ *  @param p_List   Event list to free
+ */
+void CalDAV_Event_List_Free(CalDAV_Event_List_t *p_List);
+
 /** @brief              Frees memory allocated for calendar data.
  *  @param p_Calendars  Calendar list to free
  */
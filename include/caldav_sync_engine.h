@@ -0,0 +1,129 @@
+/*
+ * caldav_sync_engine.h
+ *
+ *  Copyright (C) Daniel Kampert, 2026
+ *  Website: www.kampis-elektroecke.de
+ *  File info: Background sync engine for the CalDAV client.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#ifndef ESP32_CALDAV_SYNC_ENGINE_H_
+#define ESP32_CALDAV_SYNC_ENGINE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "caldav_client.h"
+
+/** @brief Sync engine handle.
+ */
+typedef struct CalDAV_Sync_Engine_t CalDAV_Sync_Engine_t;
+
+/** @brief Published result of a refresh. A snapshot does not change while it is acquired.
+ */
+typedef struct {
+    CalDAV_Event_List_t List;       /**< Events of all registered calendars, sorted by start time. */
+    uint32_t Generation;            /**< Number of the refresh, increases with every published snapshot. */
+    time_t Updated;                 /**< Time of the refresh. */
+} CalDAV_Sync_Snapshot_t;
+
+/** @brief          Callback after every refresh and failed change check of the sync engine. It runs in the sync task.
+ *  @param Error    Result of the refresh or check (a new snapshot is only published after a successful refresh)
+ *  @param p_Arg    User argument
+ */
+typedef void (*CalDAV_Sync_Engine_Callback_t)(CalDAV_Error_t Error, void *p_Arg);
+
+/** @brief Sync engine configuration.
+ */
+typedef struct {
+    const char *const *pp_CalendarPaths;    /**< Calendars to refresh (copied by the engine). */
+    size_t Count;                           /**< Number of calendars. */
+    uint32_t IntervalMs;                    /**< Time between two refreshes in milliseconds (not 0). */
+    int32_t WindowStart;                    /**< Start of the time range relative to the refresh in seconds. */
+    uint32_t WindowLength;                  /**< Length of the time range in seconds (not 0). */
+    CalDAV_Sync_Engine_Callback_t on_Update;    /**< Callback after every refresh (optional). */
+    void *p_Arg;                            /**< User argument for the callback. */
+    uint32_t MaxIntervalMs;                 /**< Longest poll interval of an unchanged calendar in milliseconds,
+                                                 at least IntervalMs, or 0 to refresh at the fixed interval
+                                                 (adaptive polling). */
+} CalDAV_Sync_Engine_Config_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief              Starts a sync task that refreshes calendars on a schedule.
+ *                      The task is created with the stack size, priority and core from the Kconfig. Every refresh
+ *                      is published as a new snapshot, readers never wait for the network. The client is used by
+ *                      the task exclusively until the engine is stopped.
+ *                      With MaxIntervalMs above IntervalMs each calendar is polled with a change check only, the
+ *                      poll interval doubles while the calendar is unchanged and returns to IntervalMs on a change
+ *                      or when an event of the calendar starts within it. Failed requests are repeated with an
+ *                      exponential backoff that respects a "Retry-After" header of the server.
+ *                      Requires CONFIG_ESP32_CALDAV_SYNC_ENGINE.
+ *  @param p_Client     Initialized CalDAV client handle (must not be NULL)
+ *  @param p_Config     Engine configuration (must not be NULL)
+ *  @param pp_Engine    Pointer to store the engine handle
+ *  @return             CALDAV_ERROR_OK on success, CALDAV_ERROR_INVALID_ARG if IntervalMs or WindowLength is 0 or
+ *                      MaxIntervalMs is shorter than IntervalMs, error code otherwise
+ */
+CalDAV_Error_t CalDAV_Sync_Engine_Start(CalDAV_Client_t *p_Client,
+                                        const CalDAV_Sync_Engine_Config_t *p_Config,
+                                        CalDAV_Sync_Engine_t **pp_Engine);
+
+/** @brief          Stops the sync task and releases the engine.
+ *                  Waits for a running refresh and for all acquired snapshots to be released.
+ *  @param p_Engine Engine handle
+ */
+void CalDAV_Sync_Engine_Stop(CalDAV_Sync_Engine_t *p_Engine);
+
+/** @brief          Starts a refresh without waiting for the interval.
+ *  @param p_Engine Engine handle
+ */
+void CalDAV_Sync_Engine_Trigger(CalDAV_Sync_Engine_t *p_Engine);
+
+/** @brief                  Reports a change of a calendar that is known without polling, e.g. from a push
+ *                          notification received by the application. The calendar is refreshed at once without a
+ *                          change check.
+ *  @param p_Engine         Engine handle
+ *  @param p_CalendarPath   Path of a registered calendar
+ *  @return                 CALDAV_ERROR_OK on success, CALDAV_ERROR_NOT_FOUND if the calendar is not registered,
+ *                          CALDAV_ERROR_INVALID_ARG if parameters are NULL
+ */
+CalDAV_Error_t CalDAV_Sync_Engine_Notify(CalDAV_Sync_Engine_t *p_Engine, const char *p_CalendarPath);
+
+/** @brief          Acquires the current snapshot without locking.
+ *                  The snapshot stays valid until it is released, release it as soon as possible so the
+ *                  engine can reuse its buffer.
+ *  @param p_Engine Engine handle
+ *  @return         Snapshot or NULL if no refresh has been successful yet
+ */
+const CalDAV_Sync_Snapshot_t *CalDAV_Sync_Engine_Acquire(CalDAV_Sync_Engine_t *p_Engine);
+
+/** @brief              Releases a snapshot returned by CalDAV_Sync_Engine_Acquire.
+ *  @param p_Engine     Engine handle
+ *  @param p_Snapshot   Snapshot (may be NULL)
+ */
+void CalDAV_Sync_Engine_Release(CalDAV_Sync_Engine_t *p_Engine, const CalDAV_Sync_Snapshot_t *p_Snapshot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ESP32_CALDAV_SYNC_ENGINE_H_ */
@@ -0,0 +1,46 @@
+/*
+ * caldav_types.h
+ *
+ *  Copyright (C) Daniel Kampert, 2026
+ *  Website: www.kampis-elektroecke.de
+ *  File info: CalDAV data types without dependencies on the HTTP client.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#ifndef ESP32_CALDAV_TYPES_H_
+#define ESP32_CALDAV_TYPES_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+/** @brief Calendar event data structure.
+ */
+typedef struct {
+    char *UID;                      /**< Event unique identifier. */
+    char *Summary;                  /**< Event title/summary. */
+    char *Description;              /**< Event description (optional). */
+    char *StartTime;                /**< Start time in ISO 8601 format. */
+    char *EndTime;                  /**< End time in ISO 8601 format. */
+    char *Location;                 /**< Event location (optional). */
+    time_t Start;                   /**< Start time in seconds since 1970 (UTC), 0 without start time. */
+    time_t End;                     /**< End time in seconds since 1970 (UTC), from DTEND or DURATION. */
+    int32_t Offset;                 /**< UTC offset of the start time in seconds (time zone of DTSTART). */
+    bool IsAllDay;                  /**< The event starts on a date without time, Start is midnight UTC. */
+} CalDAV_Calendar_Event_t;
+
+#endif /* ESP32_CALDAV_TYPES_H_ */
@@ -21,29 +21,42 @@
  * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
  */
 
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
 #include <esp_log.h>
 #include <esp_crt_bundle.h>
 #include <esp_http_client.h>
+#include <esp_rom_crc.h>
+#include <mbedtls/base64.h>
+
+#if CONFIG_ESP32_CALDAV_COMPRESSION
+    #include <miniz.h>
+#endif
+
+#if CONFIG_ESP32_CALDAV_STATS
+#include <esp_timer.h>
+#endif
 
 #include <string.h>
+#include <strings.h>
 #include <stdlib.h>
+#include <stddef.h>
+#include <stdio.h>
 #include <time.h>
-#include <string>
+#include <unistd.h>
 
 #include "caldav_client.h"
+#include "caldav_parser.h"
+#include "caldav_memory.h"
 
-#if CONFIG_ESP32_CALDAV_USE_PSRAM
-    #define CUSTOM_MALLOC(ptr)              heap_caps_malloc(ptr, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
-    #define CUSTOM_FREE(ptr)                heap_caps_free(ptr)
-    #define CUSTOM_REALLOC(ptr, NewSize)    heap_caps_realloc(ptr, NewSize, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
-#else
-    #define CUSTOM_MALLOC(ptr)              malloc(ptr)
-    #define CUSTOM_FREE(ptr)                free(ptr)
-    #define CUSTOM_REALLOC(ptr, NewSize)    realloc(ptr, NewSize)
+#if CONFIG_ESP32_CALDAV_STATS
+std::atomic<uint32_t> _CalDAV_Allocations(0);
+std::atomic<uint32_t> _CalDAV_Reallocations(0);
 #endif
 
 /* PROPFIND request to find all calendars */
-static const char *_CalDAV_Propfind_Body =
+static const char _CalDAV_Propfind_Body[] =
     "<?xml version=\"1.0\" encoding=\"utf-8\" ?>\n"
     "<D:propfind xmlns:D=\"DAV:\" xmlns:C=\"urn:ietf:params:xml:ns:caldav\" xmlns:CS=\"http://calendarserver.org/ns/\">\n"
     "  <D:prop>\n"
@@ -51,866 +64,5316 @@ static const char *_CalDAV_Propfind_Body =
     "    <D:displayname/>\n"
     "    <C:calendar-description/>\n"
     "    <CS:getctag/>\n"
+    "    <D:sync-token/>\n"
+    "  </D:prop>\n"
+    "</D:propfind>";
+
+/* PROPFIND request for the principal and the calendar home of the user */
+static const char _CalDAV_Propfind_Discovery_Body[] =
+    "<?xml version=\"1.0\" encoding=\"utf-8\" ?>\n"
+    "<D:propfind xmlns:D=\"DAV:\" xmlns:C=\"urn:ietf:params:xml:ns:caldav\">\n"
+    "  <D:prop>\n"
+    "    <D:resourcetype/>\n"
+    "    <D:current-user-principal/>\n"
+    "    <C:calendar-home-set/>\n"
+    "  </D:prop>\n"
+    "</D:propfind>";
+
+/* PROPFIND request for the change tags of a single calendar */
+static const char _CalDAV_Propfind_Tags_Body[] =
+    "<?xml version=\"1.0\" encoding=\"utf-8\" ?>\n"
+    "<D:propfind xmlns:D=\"DAV:\" xmlns:CS=\"http://calendarserver.org/ns/\">\n"
+    "  <D:prop>\n"
+    "    <CS:getctag/>\n"
+    "    <D:sync-token/>\n"
     "  </D:prop>\n"
     "</D:propfind>";
 
+/* calendar-query REPORT with a time-range filter. The calendar-data element and the times are inserted between
+   the parts */
+static const char _CalDAV_Query_Head[] =
+    "<?xml version=\"1.0\" encoding=\"utf-8\" ?>\n"
+    "<C:calendar-query xmlns:D=\"DAV:\" xmlns:C=\"urn:ietf:params:xml:ns:caldav\">\n"
+    "  <D:prop>\n"
+    "    <D:getetag/>\n";
+
+static const char _CalDAV_Query_Filter[] =
+    "  </D:prop>\n"
+    "  <C:filter>\n"
+    "    <C:comp-filter name=\"VCALENDAR\">\n"
+    "      <C:comp-filter name=\"VEVENT\">\n"
+    "        <C:time-range start=\"";
+
+static const char _CalDAV_Query_Tail[] =
+    "\"/>\n"
+    "      </C:comp-filter>\n"
+    "    </C:comp-filter>\n"
+    "  </C:filter>\n"
+    "</C:calendar-query>";
+
+/* free-busy-query REPORT (RFC 4791, 7.10). The times are inserted between the parts */
+static const char _CalDAV_Free_Busy_Head[] =
+    "<?xml version=\"1.0\" encoding=\"utf-8\" ?>\n"
+    "<C:free-busy-query xmlns:C=\"urn:ietf:params:xml:ns:caldav\">\n"
+    "  <C:time-range start=\"";
+
+static const char _CalDAV_Free_Busy_Tail[] =
+    "\"/>\n"
+    "</C:free-busy-query>";
+
+/* Size of the buffer for a calendar-query body */
+#define CALDAV_QUERY_BODY_LENGTH            1024
+
+/* Identification of an event cache file. All integers of the file are little endian, a CRC32 of the content
+   follows the last record */
+#define CALDAV_EVENT_CACHE_MAGIC            "CDVC"
+#define CALDAV_EVENT_CACHE_VERSION          3
+
+/* Identification of a calendar list file, same layout as an event cache file */
+#define CALDAV_CALENDARS_MAGIC              "CDVL"
+#define CALDAV_CALENDARS_VERSION            2
+
+/* Suffix of the file a save writes before it replaces the previous file */
+#define CALDAV_CACHE_FILE_TEMP              ".tmp"
+
+/* Size of the path of the temporary file */
+#define CALDAV_CACHE_FILE_PATH_LENGTH       128
+
+/* Length of a NULL string in an event cache or calendar list file */
+#define CALDAV_EVENT_CACHE_NULL             0xFFFF
+
 static const char *TAG = "CalDAV-Client";
 
-/** @brief      Helper function to convert std::string to char*.
- *  @param str  The string to convert
- *  @return     Allocated char* or NULL if string is empty
+/** @brief  Block of an arena. The strings of a result set are allocated from the data that follows the block header.
  */
-static inline char *_CalDAV_String_to_cstr(const std::string &str)
-{
-    return str.empty() ? NULL : strdup(str.c_str());
-}
+typedef struct CalDAV_Arena_Block_t {
+    struct CalDAV_Arena_Block_t *p_Next;    /**< Previously allocated block. */
+    size_t Size;                            /**< Size of the data. */
+    size_t Used;                            /**< Used part of the data. */
+} CalDAV_Arena_Block_t;
 
-/** @brief Structure holding configuration and state for a CalDAV client,
- *         including server URL, credentials, calendar path, timeout, and
- *         initialization status.
+/** @brief  Header in front of every result array. It allows to release a complete result set with one call.
+ */
+typedef union {
+    struct {
+        CalDAV_Arena_Block_t *p_Blocks;     /**< String blocks of the result set. */
+        bool IsStatic;                      /**< The result set lives in a caller-supplied buffer. */
+    } Info;
+    max_align_t Align;                      /**< Keeps the following array aligned. */
+} CalDAV_Arena_Header_t;
+
+/** @brief  Bump allocator for a result set.
+ *          The result array is placed behind a CalDAV_Arena_Header_t and grows by doubling. The strings are
+ *          allocated from a chain of blocks. With a caller-supplied buffer the array grows from the start and
+ *          the strings from the end of the buffer, so no heap memory is used at all.
+ */
+typedef struct {
+    CalDAV_Arena_Header_t *p_Header;        /**< Header followed by the result array. */
+    size_t ElementSize;                     /**< Size of one array element. */
+    size_t Length;                          /**< Number of used elements. */
+    size_t Size;                            /**< Number of allocated elements. */
+    CalDAV_Arena_Block_t *p_Blocks;         /**< Current string block. */
+    char *p_Buffer;                         /**< Caller-supplied buffer or NULL. */
+    size_t BufferSize;                      /**< Size of the caller-supplied buffer. */
+    size_t BufferEnd;                       /**< Start of the strings in the caller-supplied buffer. */
+    size_t Allocated;                       /**< Heap bytes of the array and the string blocks. */
+    bool IsView;                            /**< Strings point into a retained response body instead of copies. */
+    bool IsOutOfMemory;                     /**< An allocation has failed. */
+} CalDAV_Arena_t;
+
+/** @brief  Receiver of a response body.
+ *          The body is either parsed while it is received or retained for parsing in place (zero-copy).
+ */
+typedef struct {
+    CalDAV_Parser_t *p_Parser;              /**< Parser for the body while it is received or NULL. */
+    CalDAV_Arena_Block_t *p_Body;           /**< Retained body. The data follows the block header. */
+    bool IsRetained;                        /**< Retain the body instead of parsing it while it is received. */
+    bool IsOutOfMemory;                     /**< The retained body could not be enlarged. */
+    bool IsRetried;                         /**< The request has been repeated on a fresh connection. */
+    bool HasData;                           /**< Response body data has been passed on. */
+    bool IsNotRetryable;                    /**< The request changes the server and is only repeated if it was
+                                                 not sent completely. */
+    struct CalDAV_Inflater_t *p_Inflater;   /**< Inflater of a compressed body or NULL. */
+    struct CalDAV_Inflater_t *p_Reserved;   /**< Inflater of the fixed memory profile or NULL. */
+    bool IsCorrupt;                         /**< The compressed body can not be inflated. */
+    bool IsShared;                          /**< The parser buffer belongs to the client. */
+    CalDAV_Stats_t *p_Stats;                /**< Statistics of the client or NULL. */
+    int64_t StartTime;                      /**< Start of the request (esp_timer). */
+    int64_t ConnectTime;                    /**< Connection established or 0 if the connection was reused. */
+    int64_t SentTime;                       /**< Request headers sent or 0. */
+    int64_t FirstByteTime;                  /**< First response header received or 0. */
+    int64_t FinishTime;                     /**< Response body received or 0. */
+    int64_t ParseTime;                      /**< Time spent in the parser. */
+    size_t ReceivedLength;                  /**< Response bytes received from the network. */
+    uint32_t Allocations;                   /**< Allocation counter at the start of the request. */
+    uint32_t Reallocations;                 /**< Reallocation counter at the start of the request. */
+    const char *p_IfNoneMatch;              /**< Value of the "If-None-Match" header or NULL to omit it. */
+    char *p_ETag;                           /**< Buffer for the "ETag" header of the response or NULL. */
+    size_t ETagSize;                        /**< Size of the ETag buffer. */
+    uint32_t *p_RetryAfter;                 /**< Receives the "Retry-After" header of the response or NULL. */
+    const char *p_IfMatch;                  /**< Value of the "If-Match" header or NULL to omit it. */
+    const char *p_ContentType;              /**< Content type of the request body or NULL for XML. */
+} CalDAV_Receiver_t;
+
+/** @brief  XML request body that is built piece by piece.
+ *          The body grows on the heap by doubling. In the fixed memory profile it is written to the request buffer
+ *          of the client instead and a body that does not fit is an allocation failure.
+ */
+typedef struct {
+    char *p_Data;                           /**< Body (not terminated). */
+    size_t Length;                          /**< Length of the body. */
+    size_t Size;                            /**< Size of the data. */
+    bool IsFixed;                           /**< The data is the request buffer of the client. */
+    bool IsOutOfMemory;                     /**< An append has failed. */
+} CalDAV_Document_t;
+
+/** @brief  Calendars collected from a PROPFIND response.
  */
-static thread_local esp_http_client_config_t _CalDAV_HTTP_Config;
+typedef struct {
+    CalDAV_Arena_t Arena;
+} CalDAV_Calendar_Collector_t;
 
-/** @brief  Buffer used to accumulate HTTP response data.
- *          This structure holds a dynamically allocated character buffer, its current
- *          total size, and the write position used while assembling the complete
- *          HTTP response body in the esp_http_client event callback.
+/** @brief  Result of a discovery PROPFIND.
  */
 typedef struct {
-    char *Buffer;
-    size_t Size;
-    size_t Position;
-} HTTP_Response_Buffer_t;
+    char *Principal;                        /**< Principal of the user or NULL. */
+    char *CalendarHome;                     /**< Calendar home of the principal or NULL. */
+    bool IsOutOfMemory;                     /**< An allocation has failed. */
+} CalDAV_Discovery_t;
 
-/** @brief          HTTP Event Handler
- *  @param p_Event  Pointer to HTTP Event
- *  @return         ESP_OK on success
+/** @brief  State of an incremental sync.
  */
-static esp_err_t on_HTTP_Event_Handler(esp_http_client_event_t *p_Event)
-{
-    HTTP_Response_Buffer_t *p_OutputBuffer = (HTTP_Response_Buffer_t *)p_Event->user_data;
+typedef struct {
+    CalDAV_Parser_t *p_Parser;              /**< Parser of the REPORT response. */
+    CalDAV_Sync_Callback_t Callback;        /**< User callback. */
+    void *p_Arg;                            /**< User argument. */
+    char *p_SyncToken;                      /**< Buffer for the new sync token. */
+    size_t TokenSize;                       /**< Size of the token buffer. */
+    size_t Events;                          /**< Events reported for the current response block. */
+    bool HasToken;                          /**< The new sync token has been received. */
+    bool IsTokenTruncated;                  /**< The new sync token does not fit into the buffer. */
+} CalDAV_Sync_Context_t;
+
+/** @brief  State of an event cache refresh.
+ */
+typedef struct {
+    CalDAV_Event_Cache_t *p_Cache;          /**< Refreshed cache. */
+    CalDAV_Arena_t Arena;                   /**< Events of the resource currently received. */
+    size_t Changed;                         /**< Number of added, changed and removed resources. */
+    bool IsFull;                            /**< A resource did not fit into the cache. */
+    bool IsOutOfMemory;                     /**< An allocation has failed. */
+} CalDAV_Cache_Context_t;
+
+/** @brief  Event cache or calendar list file that is written or read.
+ */
+typedef struct {
+    FILE *p_File;                           /**< Open file. */
+    uint32_t CRC;                           /**< CRC32 of the data written or read so far. */
+    bool IsOk;                              /**< All writes have succeeded. */
+    char TempPath[CALDAV_CACHE_FILE_PATH_LENGTH];   /**< Path of the temporary file. */
+} CalDAV_Cache_File_t;
 
-    switch (p_Event->event_id) {
-        case HTTP_EVENT_ON_DATA: {
-            /* Allocate buffer if not yet available */
-            if (p_OutputBuffer->Buffer == NULL) {
-                p_OutputBuffer->Buffer = (char *)CUSTOM_MALLOC(CONFIG_ESP32_CALDAV_BUFFER_LENGTH);
-                p_OutputBuffer->Size = CONFIG_ESP32_CALDAV_BUFFER_LENGTH;
-                p_OutputBuffer->Position = 0;
+/** @brief  Event with its position, used to sort the events of several calendars.
+ */
+typedef struct {
+    CalDAV_Calendar_Event_t Event;          /**< Event. */
+    size_t Calendar;                        /**< Index of the calendar of the event. */
+    size_t Position;                        /**< Position before sorting, keeps the sort stable. */
+} CalDAV_Sort_Entry_t;
 
-                if (p_OutputBuffer->Buffer == NULL) {
-                    ESP_LOGE(TAG, "Failed to allocate response buffer!");
+/** @brief  Result of a change check for a single calendar.
+ */
+typedef struct {
+    const CalDAV_Calendar_t *p_Calendar;    /**< Calendar with the known tags or NULL. */
+    bool HasResponse;                       /**< The server has answered with a response block. */
+    bool IsChanged;                         /**< The tags differ or cannot be compared. */
+    char *p_Tag;                            /**< Buffer for the current change tag or NULL. */
+    size_t TagSize;                         /**< Size of the tag buffer. */
+    bool IsTruncated;                       /**< The change tag does not fit into the buffer. */
+} CalDAV_Change_Check_t;
+
+/** @brief  Merged busy periods of free-busy-query REPORTs.
+ */
+typedef struct {
+    CalDAV_Busy_Period_t *p_Periods;        /**< Periods sorted by start time, they neither overlap nor touch. */
+    size_t Max;                             /**< Size of the period array. */
+    size_t Length;                          /**< Number of stored periods. */
+    time_t Limit;                           /**< Start of the earliest dropped period. */
+    bool IsTruncated;                       /**< A period has been dropped because the array is full. */
+} CalDAV_Free_Busy_t;
+
+/** @brief  Steps of an asynchronous request.
+ */
+typedef enum {
+    CALDAV_REQUEST_STEP_DISCOVER = 0,       /**< PROPFIND of the server URL for the calendar home. */
+    CALDAV_REQUEST_STEP_DISCOVER_PRINCIPAL, /**< PROPFIND of the principal for the calendar home. */
+    CALDAV_REQUEST_STEP_CALENDARS,          /**< PROPFIND of the calendars in the calendar home. */
+    CALDAV_REQUEST_STEP_EVENTS,             /**< calendar-query REPORT for the events of a calendar. */
+} CalDAV_Request_Step_t;
+
+/** @brief  Asynchronous request. It owns everything the HTTP exchange of the current step needs, because the
+ *          exchange continues in later calls of CalDAV_Client_Poll.
+ */
+struct CalDAV_Request_t {
+    CalDAV_Request_Step_t Step;             /**< Current step. */
+    bool IsActive;                          /**< The HTTP exchange of the current step is running. */
+    char URL[512];                          /**< URL of the current step. */
+    char Body[CALDAV_QUERY_BODY_LENGTH];    /**< calendar-query body of an event list. */
+    size_t BodyLength;                      /**< Length of the calendar-query body. */
+    CalDAV_Receiver_t Receiver;             /**< Receiver of the current step. */
+    CalDAV_Parser_t Parser;                 /**< Parser of the current step. */
+    CalDAV_Discovery_t Discovery;           /**< Result of the discovery steps. */
+    bool IsDiscovered;                      /**< The calendar home has been discovered by this request. */
+    CalDAV_Calendar_Collector_t Collector;  /**< Calendars of a calendar list. */
+    CalDAV_Calendar_List_t *p_Calendars;    /**< Result of a calendar list. */
+    CalDAV_Arena_t Arena;                   /**< Events of an event list. */
+    struct tm StartTime;                    /**< Start of the time range of an event list. */
+    struct tm EndTime;                      /**< End of the time range of an event list. */
+    CalDAV_Calendar_Event_t **pp_Events;    /**< Result of an event list. */
+    size_t *p_Length;                       /**< Number of events of an event list. */
+    CalDAV_Request_Callback_t on_Complete;  /**< Completion callback (optional). */
+    void *p_Arg;                            /**< User argument for the completion callback. */
+};
+
+/** @brief              Initializes an arena.
+ *  @param p_Arena      Arena to initialize
+ *  @param ElementSize  Size of one array element
+ *  @param p_Buffer     Caller-supplied buffer or NULL to allocate from the heap
+ *  @param Size         Size of the caller-supplied buffer
+ */
+static void _CalDAV_Arena_Init(CalDAV_Arena_t *p_Arena, size_t ElementSize, void *p_Buffer, size_t Size)
+{
+    memset(p_Arena, 0, sizeof(CalDAV_Arena_t));
 
-                    return ESP_FAIL;
-                }
-            }
+    p_Arena->ElementSize = ElementSize;
 
-            /* Expand buffer if necessary */
-            if ((p_OutputBuffer->Position + p_Event->data_len) >= p_OutputBuffer->Size) {
-                size_t NewSize = p_OutputBuffer->Size * 2;
-                while ((p_OutputBuffer->Position + p_Event->data_len) >= NewSize) {
-                    NewSize *= 2;
-                }
+    if (p_Buffer != NULL) {
+        size_t Offset;
 
-                char *p_NewBuffer = (char *)CUSTOM_REALLOC(p_OutputBuffer->Buffer, NewSize);
-                if (p_NewBuffer == NULL) {
-                    ESP_LOGE(TAG, "Failed to expand response buffer!");
+        /* Align the header for the element array */
+        Offset = (alignof(CalDAV_Arena_Header_t) - ((uintptr_t)p_Buffer % alignof(CalDAV_Arena_Header_t))) %
+                 alignof(CalDAV_Arena_Header_t);
+        if (Size < (Offset + sizeof(CalDAV_Arena_Header_t))) {
+            p_Arena->IsOutOfMemory = true;
 
-                    return ESP_FAIL;
-                }
+            return;
+        }
 
-                p_OutputBuffer->Buffer = p_NewBuffer;
-                p_OutputBuffer->Size = NewSize;
-                ESP_LOGD(TAG, "Response buffer expanded to %d bytes", NewSize);
-            }
+        p_Arena->p_Buffer = (char *)p_Buffer + Offset;
+        p_Arena->BufferSize = Size - Offset;
+        p_Arena->BufferEnd = p_Arena->BufferSize;
+        p_Arena->p_Header = (CalDAV_Arena_Header_t *)p_Arena->p_Buffer;
+        p_Arena->p_Header->Info.p_Blocks = NULL;
+        p_Arena->p_Header->Info.IsStatic = true;
+    }
+}
 
-            /* Copy data into buffer */
-            memcpy(p_OutputBuffer->Buffer + p_OutputBuffer->Position, p_Event->data, p_Event->data_len);
-            p_OutputBuffer->Position += p_Event->data_len;
-            p_OutputBuffer->Buffer[p_OutputBuffer->Position] = 0;
+/** @brief          Accounts for new heap memory of an arena.
+ *                  In the fixed memory profile the heap usage of a result set is limited to
+ *                  CONFIG_ESP32_CALDAV_MAX_RESULT_LENGTH bytes.
+ *  @param p_Arena  Arena
+ *  @param Size     Number of additional heap bytes
+ *  @return         true on success, false if the limit is exceeded
+ */
+static bool _CalDAV_Arena_Charge(CalDAV_Arena_t *p_Arena, size_t Size)
+{
+#if CONFIG_ESP32_CALDAV_FIXED_MEMORY
+    if ((p_Arena->Allocated + Size) > CONFIG_ESP32_CALDAV_MAX_RESULT_LENGTH) {
+        ESP_LOGE(TAG, "Result set exceeds %u bytes!", (unsigned int)CONFIG_ESP32_CALDAV_MAX_RESULT_LENGTH);
+        p_Arena->IsOutOfMemory = true;
 
-            break;
-        }
-        default: {
-            break;
-        }
+        return false;
     }
+#endif
 
-    return ESP_OK;
+    p_Arena->Allocated += Size;
+
+    return true;
 }
 
-/** @brief
- *  @param Data
- *  @param Field
- *  @return
+/** @brief          Appends a zeroed element to the result array of an arena.
+ *  @param p_Arena  Arena
+ *  @return         Pointer to the new element or NULL if out of memory
  */
-static std::string _CalDAV_Extract_iCal_Field(const std::string &Data, const std::string &Field)
+static void *_CalDAV_Arena_Element(CalDAV_Arena_t *p_Arena)
 {
-    size_t Start = Data.find(Field);
-    size_t End;
-    size_t ColonPos;
-    std::string Value;
+    char *p_Element;
 
-    if (Start == std::string::npos) {
-        return std::string();
+    if (p_Arena->IsOutOfMemory) {
+        return NULL;
     }
 
-    Start += Field.length();
+    if (p_Arena->p_Buffer != NULL) {
+        if ((sizeof(CalDAV_Arena_Header_t) + ((p_Arena->Length + 1) * p_Arena->ElementSize)) >
+            p_Arena->BufferEnd) {
+            p_Arena->IsOutOfMemory = true;
 
-    ColonPos = Data.find(':', Start);
-    if (ColonPos != std::string::npos) {
-        /* Check if colon is before the line end */
-        size_t LineEnd = Data.find_first_of("\n\r", Start);
-        if ((LineEnd == std::string::npos) || (ColonPos < LineEnd)) {
-            Start = ColonPos + 1;
+            return NULL;
+        }
+    } else if (p_Arena->Length == p_Arena->Size) {
+        size_t NewSize;
+        CalDAV_Arena_Header_t *p_NewHeader;
+
+        NewSize = (p_Arena->Size == 0) ? 4 : (p_Arena->Size * 2);
+        if (_CalDAV_Arena_Charge(p_Arena, ((p_Arena->Size == 0) ? sizeof(CalDAV_Arena_Header_t) : 0) +
+                                          ((NewSize - p_Arena->Size) * p_Arena->ElementSize)) == false) {
+            return NULL;
         }
-    }
 
-    End = Data.find_first_of("\n\r", Start);
-    if (End == std::string::npos) {
-        return Data.substr(Start);
-    }
+        p_NewHeader = (CalDAV_Arena_Header_t *)CUSTOM_REALLOC(p_Arena->p_Header, sizeof(CalDAV_Arena_Header_t) +
+                                                                                 (NewSize * p_Arena->ElementSize));
+        if (p_NewHeader == NULL) {
+            p_Arena->IsOutOfMemory = true;
+
+            return NULL;
+        }
 
-    /* Remove possible \r at the end */
-    Value = Data.substr(Start, End - Start);
-    if ((Value.empty() == false) && (Value.back() == '\r')) {
-        Value.pop_back();
+        p_Arena->p_Header = p_NewHeader;
+        p_Arena->Size = NewSize;
     }
 
-    return Value;
+    p_Element = (char *)(p_Arena->p_Header + 1) + (p_Arena->Length * p_Arena->ElementSize);
+    memset(p_Element, 0, p_Arena->ElementSize);
+    p_Arena->Length++;
+
+    return p_Element;
 }
 
-/** @brief
- *  @param Data
- *  @param Tag
- *  @return
+/** @brief          Copies a string into an arena.
+ *  @param p_Arena  Arena
+ *  @param p_String String to copy (may be NULL)
+ *  @param Length   Length of the string without the terminator
+ *  @return         Copy of the string or NULL if the string is NULL or out of memory
  */
-static std::string _CalDAV_Extract_XML_Tag_Value(const std::string &Data, const std::string &Tag)
+static char *_CalDAV_Arena_String(CalDAV_Arena_t *p_Arena, const char *p_String, size_t Length)
 {
-    size_t End;
-    std::string StartTag = "<" + Tag + ">";
-    std::string EndTag = "</" + Tag + ">";
-    size_t Start = Data.find(StartTag);
+    char *p_Copy;
 
-    if (Start == std::string::npos) {
-        StartTag = ":" + Tag + ">";
-        Start = Data.find(StartTag);
+    if ((p_String == NULL) || p_Arena->IsOutOfMemory) {
+        return NULL;
     }
 
-    if (Start == std::string::npos) {
-        return std::string();
-    }
+    if (p_Arena->p_Buffer != NULL) {
+        size_t ArrayEnd;
 
-    Start = Data.find('>', Start);
-    if (Start == std::string::npos) {
-        return std::string();
-    }
+        ArrayEnd = sizeof(CalDAV_Arena_Header_t) + (p_Arena->Length * p_Arena->ElementSize);
+        if ((p_Arena->BufferEnd - ArrayEnd) < (Length + 1)) {
+            p_Arena->IsOutOfMemory = true;
 
-    Start++;
-    End = Data.find(EndTag, Start);
-    if (End == std::string::npos) {
-        return std::string();
-    }
+            return NULL;
+        }
 
-    return Data.substr(Start, End - Start);
-}
+        p_Arena->BufferEnd -= Length + 1;
+        p_Copy = p_Arena->p_Buffer + p_Arena->BufferEnd;
+    } else {
+        CalDAV_Arena_Block_t *p_Block = p_Arena->p_Blocks;
 
-CalDAV_Error_t CalDAV_Client_Init(const CalDAV_Config_t *p_Config, CalDAV_Client_t *p_Client)
-{
-    if ((p_Config == NULL) || (p_Config->ServerURL[0] == '\0') || (p_Config->Username[0] == '\0') ||
-        (p_Config->Password[0] == '\0')) {
-        ESP_LOGE(TAG, "Invalid configuration!");
+        if ((p_Block == NULL) || ((p_Block->Size - p_Block->Used) < (Length + 1))) {
+            size_t Size;
 
-        return CALDAV_ERROR_INVALID_ARG;
-    }
+            Size = ((Length + 1) > CONFIG_ESP32_CALDAV_ARENA_BLOCK_SIZE) ? (Length + 1) :
+                   CONFIG_ESP32_CALDAV_ARENA_BLOCK_SIZE;
+            if (_CalDAV_Arena_Charge(p_Arena, sizeof(CalDAV_Arena_Block_t) + Size) == false) {
+                return NULL;
+            }
 
-    /* Initialize HTTP config completely to avoid garbage values */
-    memset(&_CalDAV_HTTP_Config, 0, sizeof(_CalDAV_HTTP_Config));
+            p_Block = (CalDAV_Arena_Block_t *)CUSTOM_MALLOC(sizeof(CalDAV_Arena_Block_t) + Size);
+            if (p_Block == NULL) {
+                p_Arena->IsOutOfMemory = true;
 
-    _CalDAV_HTTP_Config.transport_type = HTTP_TRANSPORT_OVER_SSL;
-    _CalDAV_HTTP_Config.crt_bundle_attach = esp_crt_bundle_attach;
+                return NULL;
+            }
 
-    p_Client->ServerURL = std::string(p_Config->ServerURL);
-    p_Client->Username = std::string(p_Config->Username);
-    p_Client->Password = std::string(p_Config->Password);
-    p_Client->TimeoutMs = p_Config->TimeoutMs;
-    p_Client->IsInitialized = true;
+            p_Block->p_Next = p_Arena->p_Blocks;
+            p_Block->Size = Size;
+            p_Block->Used = 0;
+            p_Arena->p_Blocks = p_Block;
+        }
 
-    ESP_LOGD(TAG, "CalDAV client initialized: %s", p_Config->ServerURL);
+        p_Copy = (char *)(p_Block + 1) + p_Block->Used;
+        p_Block->Used += Length + 1;
+    }
 
-    return CALDAV_ERROR_OK;
+    memcpy(p_Copy, p_String, Length);
+    p_Copy[Length] = '\0';
+
+    return p_Copy;
 }
 
-void CalDAV_Client_Deinit(CalDAV_Client_t *p_Client)
+/** @brief          Copies a NUL-terminated string into an arena.
+ *  @param p_Arena  Arena
+ *  @param p_String String to copy (may be NULL)
+ *  @return         Copy of the string or NULL if the string is NULL or out of memory
+ */
+static inline char *_CalDAV_Arena_String_Duplicate(CalDAV_Arena_t *p_Arena, const char *p_String)
 {
-    if (p_Client == NULL) {
-        return;
+    if (p_Arena->IsView) {
+        return (char *)p_String;
     }
 
-    p_Client->IsInitialized = false;
+    return (p_String == NULL) ? NULL : _CalDAV_Arena_String(p_Arena, p_String, strlen(p_String));
 }
 
-CalDAV_Error_t CalDAV_Test_Connection(CalDAV_Client_t *p_Client)
+/** @brief          Adds a retained response body to the blocks of an arena, so it is released with the result set.
+ *  @param p_Arena  Arena
+ *  @param p_Body   Retained body (may be NULL)
+ */
+static void _CalDAV_Arena_Adopt(CalDAV_Arena_t *p_Arena, CalDAV_Arena_Block_t *p_Body)
 {
-    esp_err_t Error;
-    int StatusCode;
-    HTTP_Response_Buffer_t Response;
-    esp_http_client_handle_t HTTP_Client;
-
-    if ((p_Client == NULL) || (p_Client->IsInitialized == false)) {
-        return CALDAV_ERROR_NOT_INITIALIZED;
+    if (p_Body == NULL) {
+        return;
     }
 
-    memset(&Response, 0, sizeof(Response));
+    /* The body is not used for new strings, so it is linked behind the current block */
+    if (p_Arena->p_Blocks == NULL) {
+        p_Body->p_Next = NULL;
+        p_Arena->p_Blocks = p_Body;
+    } else {
+        p_Body->p_Next = p_Arena->p_Blocks->p_Next;
+        p_Arena->p_Blocks->p_Next = p_Body;
+    }
+}
 
-    _CalDAV_HTTP_Config.timeout_ms = p_Client->TimeoutMs;
-    _CalDAV_HTTP_Config.event_handler = on_HTTP_Event_Handler;
-    _CalDAV_HTTP_Config.url = p_Client->ServerURL.c_str();
-    _CalDAV_HTTP_Config.user_data = &Response;
-    HTTP_Client = esp_http_client_init(&_CalDAV_HTTP_Config);
-    if (HTTP_Client == NULL) {
-        ESP_LOGE(TAG, "HTTP client initialization failed!");
+/** @brief          Releases a chain of arena blocks.
+ *  @param p_Block  First block (may be NULL)
+ */
+static void _CalDAV_Arena_Blocks_Free(CalDAV_Arena_Block_t *p_Block)
+{
+    while (p_Block != NULL) {
+        CalDAV_Arena_Block_t *p_Next = p_Block->p_Next;
 
-        return CALDAV_ERROR_FAIL;
+        CUSTOM_FREE(p_Block);
+        p_Block = p_Next;
     }
+}
 
-    esp_http_client_set_username(HTTP_Client, p_Client->Username.c_str());
-    esp_http_client_set_password(HTTP_Client, p_Client->Password.c_str());
-    esp_http_client_set_authtype(HTTP_Client, HTTP_AUTH_TYPE_BASIC);
+/** @brief          Releases the memory of a result array and its strings.
+ *  @param p_Array  Result array returned by _CalDAV_Arena_Finish (may be NULL)
+ */
+static void _CalDAV_Arena_Free(void *p_Array)
+{
+    CalDAV_Arena_Header_t *p_Header;
+
+    if (p_Array == NULL) {
+        return;
+    }
 
-    esp_http_client_set_header(HTTP_Client, "Depth", "0");
+    p_Header = (CalDAV_Arena_Header_t *)p_Array - 1;
 
-    Error = esp_http_client_perform(HTTP_Client);
-    StatusCode = esp_http_client_get_status_code(HTTP_Client);
+    _CalDAV_Arena_Blocks_Free(p_Header->Info.p_Blocks);
 
-    esp_http_client_cleanup(HTTP_Client);
-    if (Response.Buffer) {
-        CUSTOM_FREE(Response.Buffer);
+    if (p_Header->Info.IsStatic == false) {
+        CUSTOM_FREE(p_Header);
     }
+}
 
-    if (Error != ESP_OK) {
-        ESP_LOGE(TAG, "HTTP-Request failed: %d!", Error);
+/** @brief          Completes an arena and returns the result array.
+ *                  An empty result set is released and NULL is returned.
+ *  @param p_Arena  Arena
+ *  @return         Result array or NULL if the result set is empty
+ */
+static void *_CalDAV_Arena_Finish(CalDAV_Arena_t *p_Arena)
+{
+    void *p_Array;
 
-        return CALDAV_ERROR_CONNECTION;
+    if (p_Arena->p_Header == NULL) {
+        _CalDAV_Arena_Blocks_Free(p_Arena->p_Blocks);
+        memset(p_Arena, 0, sizeof(CalDAV_Arena_t));
+
+        return NULL;
     }
 
-    if ((StatusCode == 200) || (StatusCode == 204) || (StatusCode == 207)) {
-        ESP_LOGD(TAG, "CalDAV connection successful (Status: %d)", StatusCode);
+    p_Arena->p_Header->Info.p_Blocks = p_Arena->p_Blocks;
+    if (p_Arena->p_Buffer == NULL) {
+        p_Arena->p_Header->Info.IsStatic = false;
+    }
 
-        return CALDAV_ERROR_OK;
-    } else if (StatusCode == 401) {
-        ESP_LOGE(TAG, "Authentication failed (Status: 401)!");
+    p_Array = p_Arena->p_Header + 1;
+    if (p_Arena->Length == 0) {
+        _CalDAV_Arena_Free(p_Array);
+        p_Array = NULL;
+    }
 
-        return CALDAV_ERROR_HTTP;
-    } else {
-        ESP_LOGW(TAG, "Unexpected status code: %d!", StatusCode);
+    memset(p_Arena, 0, sizeof(CalDAV_Arena_t));
 
-        return CALDAV_ERROR_HTTP;
-    }
+    return p_Array;
 }
 
-CalDAV_Error_t CalDAV_Calendars_List(CalDAV_Client_t *p_Client,
-                                     CalDAV_Calendar_List_t *p_Calendars)
+/** @brief              Makes room for more data in a retained response body.
+ *  @param p_Receiver   Receiver
+ *  @param Length       Number of bytes that must fit behind the received data
+ *  @return             true on success, false if out of memory
+ */
+static bool _CalDAV_Receiver_Reserve(CalDAV_Receiver_t *p_Receiver, size_t Length)
 {
-    char url[512];
-    esp_err_t Error;
-    int StatusCode;
-    HTTP_Response_Buffer_t Response;
-    esp_http_client_handle_t HTTP_Client;
+    size_t Used;
+    size_t Size;
+    CalDAV_Arena_Block_t *p_Body;
 
-    if ((p_Client == NULL) || (p_Client->IsInitialized == false) || (p_Calendars == NULL)) {
-        return CALDAV_ERROR_INVALID_ARG;
+    Used = (p_Receiver->p_Body != NULL) ? p_Receiver->p_Body->Used : 0;
+    Size = (p_Receiver->p_Body != NULL) ? p_Receiver->p_Body->Size : 0;
+
+    if ((Used + Length) <= Size) {
+        return true;
     }
 
-    memset(&Response, 0, sizeof(Response));
-    memset(url, 0, sizeof(url));
+    if (Size == 0) {
+        Size = CONFIG_ESP32_CALDAV_BUFFER_LENGTH;
+    }
 
-    snprintf(url, sizeof(url), "%s", p_Client->ServerURL.c_str());
+#if CONFIG_ESP32_CALDAV_FIXED_MEMORY
+    if ((Used + Length) > CONFIG_ESP32_CALDAV_MAX_RESPONSE_LENGTH) {
+        ESP_LOGE(TAG, "Response exceeds %u bytes!", (unsigned int)CONFIG_ESP32_CALDAV_MAX_RESPONSE_LENGTH);
+        p_Receiver->IsOutOfMemory = true;
 
-    ESP_LOGD(TAG, "Searching calendars on: %s (User: %s)", url, p_Client->Username.c_str());
+        return false;
+    }
+#endif
 
-    /* First PROPFIND to find the user's principal path */
-    _CalDAV_HTTP_Config.timeout_ms = p_Client->TimeoutMs;
-    _CalDAV_HTTP_Config.event_handler = on_HTTP_Event_Handler;
-    _CalDAV_HTTP_Config.url = url;
-    _CalDAV_HTTP_Config.method = HTTP_METHOD_PROPFIND;
-    _CalDAV_HTTP_Config.user_data = &Response;
-    HTTP_Client = esp_http_client_init(&_CalDAV_HTTP_Config);
-    if (HTTP_Client == NULL) {
-        return CALDAV_ERROR_FAIL;
+    while (Size < (Used + Length)) {
+        Size *= 2;
     }
 
-    esp_http_client_set_username(HTTP_Client, p_Client->Username.c_str());
-    esp_http_client_set_password(HTTP_Client, p_Client->Password.c_str());
-    esp_http_client_set_authtype(HTTP_Client, HTTP_AUTH_TYPE_BASIC);
+#if CONFIG_ESP32_CALDAV_FIXED_MEMORY
+    if (Size > CONFIG_ESP32_CALDAV_MAX_RESPONSE_LENGTH) {
+        Size = CONFIG_ESP32_CALDAV_MAX_RESPONSE_LENGTH;
+    }
+#endif
 
-    esp_http_client_set_header(HTTP_Client, "Content-Type", "application/xml; charset=utf-8");
-    esp_http_client_set_header(HTTP_Client, "Depth", "1");
-    esp_http_client_set_method(HTTP_Client, HTTP_METHOD_PROPFIND);
+    p_Body = (CalDAV_Arena_Block_t *)CUSTOM_BUFFER_REALLOC(p_Receiver->p_Body, sizeof(CalDAV_Arena_Block_t) + Size);
+    if (p_Body == NULL) {
+        p_Receiver->IsOutOfMemory = true;
 
-    esp_http_client_set_post_field(HTTP_Client, _CalDAV_Propfind_Body, strlen(_CalDAV_Propfind_Body));
+        return false;
+    }
 
-    Error = esp_http_client_perform(HTTP_Client);
-    StatusCode = esp_http_client_get_status_code(HTTP_Client);
+    p_Body->p_Next = NULL;
+    p_Body->Size = Size;
+    p_Body->Used = Used;
+    p_Receiver->p_Body = p_Body;
 
-    esp_http_client_cleanup(HTTP_Client);
+    return true;
+}
 
-    if (Error != ESP_OK) {
-        ESP_LOGE(TAG, "Calendar PROPFIND failed: %d!", Error);
-        if (Response.Buffer) {
-            CUSTOM_FREE(Response.Buffer);
+/** @brief              Passes a chunk of the (inflated) response body to the streaming parser or retains it.
+ *  @param p_Receiver   Receiver
+ *  @param p_Data       Response data
+ *  @param Length       Length of the response data
+ */
+static void _CalDAV_Receiver_Write(CalDAV_Receiver_t *p_Receiver, const char *p_Data, size_t Length)
+{
+    if (p_Receiver->IsRetained) {
+        if (p_Receiver->IsOutOfMemory || (_CalDAV_Receiver_Reserve(p_Receiver, Length) == false)) {
+            return;
         }
 
-        return CALDAV_ERROR_HTTP;
-    }
+        memcpy((char *)(p_Receiver->p_Body + 1) + p_Receiver->p_Body->Used, p_Data, Length);
+        p_Receiver->p_Body->Used += Length;
+    } else if (p_Receiver->p_Parser != NULL) {
+#if CONFIG_ESP32_CALDAV_STATS
+        p_Receiver->ParseTime -= esp_timer_get_time();
+#endif
 
-    if ((StatusCode != 200) && (StatusCode != 207)) {
-        ESP_LOGE(TAG, "Calendar PROPFIND unexpected status: %d!", StatusCode);
-        if (Response.Buffer) {
-            CUSTOM_FREE(Response.Buffer);
-        }
+        CalDAV_Parser_Feed(p_Receiver->p_Parser, p_Data, Length);
 
-        return CALDAV_ERROR_HTTP;
+#if CONFIG_ESP32_CALDAV_STATS
+        p_Receiver->ParseTime += esp_timer_get_time();
+#endif
     }
+}
 
-    ESP_LOGD(TAG, "Calendar response received");
-    ESP_LOGD(TAG, "Response buffer: %s, position: %zu", Response.Buffer ? "available" : "NULL", Response.Position);
-
-    if (Response.Buffer) {
-        ESP_LOGD(TAG, "PROPFIND Response (first 500 chars): %.*s", 500, Response.Buffer);
-        
-        int CalendarCount = 0;
-        int CurrentCalendar = 0;
-        size_t SearchPos = 0;
-
-        std::string ResponseStr(Response.Buffer);
-        CUSTOM_FREE(Response.Buffer);
+#if CONFIG_ESP32_CALDAV_COMPRESSION
+/* Optional fields of a gzip header (RFC 1952) */
+#define CALDAV_GZIP_FHCRC                   0x02
+#define CALDAV_GZIP_FEXTRA                  0x04
+#define CALDAV_GZIP_FNAME                   0x08
+#define CALDAV_GZIP_FCOMMENT                0x10
 
-        /* Check for HTML response (indicates error) */
-        if (ResponseStr.find("<!DOCTYPE html>") != std::string::npos ||
-            ResponseStr.find("<html>") != std::string::npos ||
-            ResponseStr.find("<html ") != std::string::npos) {
-            ESP_LOGE(TAG, "Invalid XML!");
+/** @brief  Stages of an inflater.
+ */
+typedef enum {
+    CALDAV_INFLATER_GZIP_HEADER = 0,        /**< Fixed part of the gzip header. */
+    CALDAV_INFLATER_GZIP_EXTRA_LENGTH,      /**< Length of the extra field. */
+    CALDAV_INFLATER_GZIP_SKIP,              /**< Optional field with a known length. */
+    CALDAV_INFLATER_GZIP_STRING,            /**< Zero-terminated optional field (file name or comment). */
+    CALDAV_INFLATER_DATA,                   /**< Deflate data. */
+    CALDAV_INFLATER_DONE,                   /**< End of the deflate data, the gzip trailer is ignored. */
+} CalDAV_Inflater_Stage_t;
+
+/** @brief  Inflater for a gzip or deflate (zlib) compressed response body, using the tinfl inflater of the ROM.
+ *          The inflated data is written to a ring buffer that is also the dictionary of the inflater. It has the
+ *          size of the largest deflate window, because the window is chosen by the server.
+ */
+typedef struct CalDAV_Inflater_t {
+    tinfl_decompressor Decompressor;        /**< State of the inflater. */
+    CalDAV_Inflater_Stage_t Stage;          /**< Current stage. */
+    mz_uint32 Flags;                        /**< Flags for tinfl_decompress. */
+    uint8_t HeaderFlags;                    /**< Optional gzip header fields that are still to come. */
+    size_t Count;                           /**< Bytes read of the current header field. */
+    size_t Remaining;                       /**< Bytes left of the current header field. */
+    size_t Position;                        /**< Write position in the window. */
+    mz_uint8 Window[TINFL_LZ_DICT_SIZE];    /**< Inflated data. */
+} CalDAV_Inflater_t;
+
+/** @brief              Prepares the inflater of a receiver for the Content-Encoding of the response.
+ *                      After a reconnect the inflater of the first attempt is reused. The inflater of the fixed
+ *                      memory profile is used instead of a new one.
+ *  @param p_Receiver   Receiver
+ *  @param p_Encoding   Value of the "Content-Encoding" header
+ */
+static void _CalDAV_Inflater_Begin(CalDAV_Receiver_t *p_Receiver, const char *p_Encoding)
+{
+    bool IsGzip;
+    CalDAV_Inflater_t *p_Inflater;
 
-            p_Calendars->Length = 0;
-            p_Calendars->Calendar = NULL;
+    if (strcasecmp(p_Encoding, "identity") == 0) {
+        return;
+    }
 
-            return CALDAV_ERROR_HTTP;
-        }
+    IsGzip = (strcasecmp(p_Encoding, "gzip") == 0) || (strcasecmp(p_Encoding, "x-gzip") == 0);
+    if ((IsGzip == false) && (strcasecmp(p_Encoding, "deflate") != 0)) {
+        ESP_LOGE(TAG, "Unsupported content encoding: %s!", p_Encoding);
+        p_Receiver->IsCorrupt = true;
 
-        /* Count calendar tags */
-        while ((SearchPos = ResponseStr.find(":calendar", SearchPos)) != std::string::npos) {
-            bool isCalendarTag = false;
-            if (SearchPos > 0) {
-                /* Walk backwards over the namespace prefix (letters, digits) and optional '/' for end tags */
-                size_t i = SearchPos;
-                while (i > 0) {
-                    char ch = ResponseStr[i - 1];
-
-                    if (((ch >= 'A') && (ch <= 'Z')) || ((ch >= 'a') && (ch <= 'z')) ||
-                        ((ch >= '0') && (ch <= '9')) || (ch == '/')) {
-                        --i;
-                    } else {
-                        break;
-                    }
-                }
+        return;
+    }
 
-                /* Valid tag if prefix is preceded by '<', e.g. <C1:calendar> or </C1:calendar> */
-                if ((i > 0) && (ResponseStr[i - 1] == '<')) {
-                    isCalendarTag = true;
-                }
-            }
+    if (p_Receiver->p_Inflater == NULL) {
+        p_Receiver->p_Inflater = p_Receiver->p_Reserved;
+    }
 
-            if (isCalendarTag) {
-                CalendarCount++;
-                ESP_LOGD(TAG, "Found calendar tag");
-            }
+    if (p_Receiver->p_Inflater == NULL) {
+        p_Receiver->p_Inflater = (CalDAV_Inflater_t *)CUSTOM_BUFFER_MALLOC(sizeof(CalDAV_Inflater_t));
+        if (p_Receiver->p_Inflater == NULL) {
+            ESP_LOGE(TAG, "Failed to allocate inflater!");
+            p_Receiver->IsOutOfMemory = true;
 
-            /* Move past this occurrence to continue searching */
-            SearchPos += strlen(":calendar");
+            return;
         }
+    }
 
-        ESP_LOGD(TAG, "Potential calendars found: %d", CalendarCount);
-
-        if (CalendarCount == 0) {
-            p_Calendars->Length = 0;
-            p_Calendars->Calendar = NULL;
-
-            return CALDAV_ERROR_OK;
-        }
+    ESP_LOGD(TAG, "Response is %s compressed", p_Encoding);
 
-        /* Allocate memory for all calendars */
-        p_Calendars->Calendar = (CalDAV_Calendar_t *)calloc(CalendarCount, sizeof(CalDAV_Calendar_t));
-        if (p_Calendars->Calendar == NULL) {
-            p_Calendars->Length = 0;
-            p_Calendars->Calendar = NULL;
+    p_Inflater = p_Receiver->p_Inflater;
+    tinfl_init(&p_Inflater->Decompressor);
+    p_Inflater->Stage = IsGzip ? CALDAV_INFLATER_GZIP_HEADER : CALDAV_INFLATER_DATA;
+    p_Inflater->Flags = IsGzip ? 0 : TINFL_FLAG_PARSE_ZLIB_HEADER;
+    p_Inflater->HeaderFlags = 0;
+    p_Inflater->Count = 0;
+    p_Inflater->Remaining = 0;
+    p_Inflater->Position = 0;
+}
 
-            return CALDAV_ERROR_NO_MEM;
-        }
+/** @brief              Continues with the next optional field of a gzip header or the deflate data.
+ *  @param p_Inflater   Inflater
+ */
+static void _CalDAV_Inflater_Next_Field(CalDAV_Inflater_t *p_Inflater)
+{
+    p_Inflater->Count = 0;
+    p_Inflater->Remaining = 0;
+
+    if (p_Inflater->HeaderFlags & CALDAV_GZIP_FEXTRA) {
+        p_Inflater->HeaderFlags &= ~CALDAV_GZIP_FEXTRA;
+        p_Inflater->Stage = CALDAV_INFLATER_GZIP_EXTRA_LENGTH;
+    } else if (p_Inflater->HeaderFlags & CALDAV_GZIP_FNAME) {
+        p_Inflater->HeaderFlags &= ~CALDAV_GZIP_FNAME;
+        p_Inflater->Stage = CALDAV_INFLATER_GZIP_STRING;
+    } else if (p_Inflater->HeaderFlags & CALDAV_GZIP_FCOMMENT) {
+        p_Inflater->HeaderFlags &= ~CALDAV_GZIP_FCOMMENT;
+        p_Inflater->Stage = CALDAV_INFLATER_GZIP_STRING;
+    } else if (p_Inflater->HeaderFlags & CALDAV_GZIP_FHCRC) {
+        p_Inflater->HeaderFlags &= ~CALDAV_GZIP_FHCRC;
+        p_Inflater->Stage = CALDAV_INFLATER_GZIP_SKIP;
+        p_Inflater->Remaining = 2;
+    } else {
+        p_Inflater->Stage = CALDAV_INFLATER_DATA;
+    }
+}
 
-        /* Parse each calendar response block */
-        SearchPos = 0;
-        
-        std::string PrincipalPath;
+/** @brief              Consumes one byte of a gzip header.
+ *  @param p_Inflater   Inflater
+ *  @param Byte         Header byte
+ *  @return             true on success, false if the body is not gzip compressed
+ */
+static bool _CalDAV_Inflater_Header(CalDAV_Inflater_t *p_Inflater, uint8_t Byte)
+{
+    /* ID1, ID2 and CM (deflate) */
+    static const uint8_t Magic[] = {0x1F, 0x8B, 0x08};
 
-        while (((SearchPos = ResponseStr.find("<response>", SearchPos)) != std::string::npos) &&
-               (CurrentCalendar < CalendarCount)) {
-            size_t ResponseEnd = ResponseStr.find("</response>", SearchPos);
-            if (ResponseEnd == std::string::npos) {
-                break;
+    switch (p_Inflater->Stage) {
+        case CALDAV_INFLATER_GZIP_HEADER: {
+            if ((p_Inflater->Count < sizeof(Magic)) && (Byte != Magic[p_Inflater->Count])) {
+                return false;
             }
 
-            /* Extract this response block */
-            std::string ResponseBlock = ResponseStr.substr(SearchPos, ResponseEnd - SearchPos);
-
-            /* Extract and log href for debugging */
-            std::string HrefStr = _CalDAV_Extract_XML_Tag_Value(ResponseBlock, "href");
-            ESP_LOGD(TAG, "Response href: %s", HrefStr.c_str());
-
-            /* Check if this response contains a calendar (not just a collection) */
-            /* Must have <resourcetype><calendar/> tag to be a real calendar */
-            bool isCalendar = false;
-            size_t ResTypePos = ResponseBlock.find("<resourcetype>");
-            if (ResTypePos != std::string::npos) {
-                size_t ResTypeEnd = ResponseBlock.find("</resourcetype>", ResTypePos);
-                if (ResTypeEnd != std::string::npos) {
-                    std::string ResTypeBlock = ResponseBlock.substr(ResTypePos, ResTypeEnd - ResTypePos);
-                    ESP_LOGD(TAG, "ResourceType block: %s", ResTypeBlock.c_str());
-                    if ((ResTypeBlock.find(":calendar") != std::string::npos) || 
-                        (ResTypeBlock.find("<calendar") != std::string::npos)) {
-                        isCalendar = true;
-                        ESP_LOGD(TAG, "  -> Is a calendar!");
-                    } else if (ResTypeBlock.find("<principal") != std::string::npos) {
-                        /* Store principal path for recursive search */
-                        if (PrincipalPath.empty() && !HrefStr.empty()) {
-                            PrincipalPath = HrefStr;
-                            ESP_LOGD(TAG, "  -> Found principal path: %s", PrincipalPath.c_str());
-                        }
-                    } else {
-                        ESP_LOGD(TAG, "  -> Not a calendar (only collection)");
-                    }
-                }
+            if (p_Inflater->Count == 3) {
+                p_Inflater->HeaderFlags = Byte;
             }
-            
-            if (isCalendar) {
-                ESP_LOGD(TAG, "Processing calendar response block");
-
-                /* Extract href (path) */
-                std::string HrefStr = _CalDAV_Extract_XML_Tag_Value(ResponseBlock, "href");
-                if (HrefStr.empty() == false) {
-                    p_Calendars->Calendar[CurrentCalendar].Path = _CalDAV_String_to_cstr(HrefStr);
-                    ESP_LOGD(TAG, "  href: %s", HrefStr.c_str());
-
-                    /* Extract calendar name from path */
-                    size_t LastSlashPos = HrefStr.find_last_of('/');
-                    if (LastSlashPos != std::string::npos) {
-                        if ((LastSlashPos + 1) < HrefStr.length()) {
-                            /* Name after last slash */
-                            p_Calendars->Calendar[CurrentCalendar].Name = strdup(HrefStr.substr(LastSlashPos + 1).c_str());
-                        } else if (LastSlashPos > 0) {
-                            /* Path ends with /, take previous segment */
-                            size_t PrevSlashPos = HrefStr.find_last_of('/', LastSlashPos - 1);
-                            if (PrevSlashPos != std::string::npos) {
-                                std::string NamePart = HrefStr.substr(PrevSlashPos + 1, LastSlashPos - PrevSlashPos - 1);
-                                p_Calendars->Calendar[CurrentCalendar].Name = strdup(NamePart.c_str());
-                            }
-                        }
-                    }
-                }
-
-                p_Calendars->Calendar[CurrentCalendar].DisplayName = _CalDAV_String_to_cstr(
-                                                                         _CalDAV_Extract_XML_Tag_Value(ResponseBlock, "displayname"));
-                p_Calendars->Calendar[CurrentCalendar].Description = _CalDAV_String_to_cstr(
-                                                                         _CalDAV_Extract_XML_Tag_Value(ResponseBlock, "calendar-description"));
 
-                ESP_LOGD(TAG, "Calendar %d:", CurrentCalendar + 1);
-                if (p_Calendars->Calendar[CurrentCalendar].Name) {
-                    ESP_LOGD(TAG, "  Name: %s", p_Calendars->Calendar[CurrentCalendar].Name);
-                }
-
-                if (p_Calendars->Calendar[CurrentCalendar].DisplayName) {
-                    ESP_LOGD(TAG, "  Display name: %s", p_Calendars->Calendar[CurrentCalendar].DisplayName);
-                }
+            /* FLG is followed by MTIME, XFL and OS */
+            if (++p_Inflater->Count == 10) {
+                _CalDAV_Inflater_Next_Field(p_Inflater);
+            }
 
-                if (p_Calendars->Calendar[CurrentCalendar].Path) {
-                    ESP_LOGD(TAG, "  Path: %s", p_Calendars->Calendar[CurrentCalendar].Path);
+            break;
+        }
+        case CALDAV_INFLATER_GZIP_EXTRA_LENGTH: {
+            p_Inflater->Remaining |= (size_t)Byte << (8 * p_Inflater->Count);
+            if (++p_Inflater->Count == 2) {
+                p_Inflater->Stage = CALDAV_INFLATER_GZIP_SKIP;
+                if (p_Inflater->Remaining == 0) {
+                    _CalDAV_Inflater_Next_Field(p_Inflater);
                 }
-
-                CurrentCalendar++;
             }
 
-            SearchPos = ResponseEnd + 1;
+            break;
         }
+        case CALDAV_INFLATER_GZIP_SKIP: {
+            if (--p_Inflater->Remaining == 0) {
+                _CalDAV_Inflater_Next_Field(p_Inflater);
+            }
 
-        p_Calendars->Length = CurrentCalendar;
-        
-        /* If no calendars found but we found a principal, search in the principal path */
-        if ((CurrentCalendar == 0) && !PrincipalPath.empty()) {
-            ESP_LOGD(TAG, "No calendars found, searching in principal path: %s", PrincipalPath.c_str());
-            
-            /* Build full URL with principal path */
-            /* Principal path is absolute from server root, so extract scheme://host */
-            std::string BaseURL = p_Client->ServerURL;
-            size_t SchemeEnd = BaseURL.find("://");
-            if (SchemeEnd != std::string::npos) {
-                size_t PathStart = BaseURL.find('/', SchemeEnd + 3);
-                if (PathStart != std::string::npos) {
-                    BaseURL = BaseURL.substr(0, PathStart);
-                }
+            break;
+        }
+        default: {
+            if (Byte == 0) {
+                _CalDAV_Inflater_Next_Field(p_Inflater);
             }
-            
-            std::string FullURL = BaseURL + PrincipalPath;
-            ESP_LOGD(TAG, "Constructed principal URL: %s", FullURL.c_str());
-            
-            /* Create temporary client with principal URL */
-            CalDAV_Client_t TempClient = *p_Client;
-            TempClient.ServerURL = FullURL;
-            
-            /* Recursive call to search in principal path */
-            return CalDAV_Calendars_List(&TempClient, p_Calendars);
+
+            break;
         }
-    } else {
-        p_Calendars->Length = 0;
-        p_Calendars->Calendar = NULL;
     }
 
-    return CALDAV_ERROR_OK;
+    return true;
 }
 
-CalDAV_Error_t CalDAV_Calendar_Find_By_Name(const CalDAV_Calendar_List_t *p_Calendars,
-                                            const char *p_Name,
-                                            CalDAV_Calendar_t **pp_Calendar)
+/** @brief              Inflates a chunk of a compressed response body and passes the inflated data on.
+ *  @param p_Receiver   Receiver
+ *  @param p_Data       Compressed data
+ *  @param Length       Length of the compressed data
+ */
+static void _CalDAV_Inflater_Feed(CalDAV_Receiver_t *p_Receiver, const mz_uint8 *p_Data, size_t Length)
 {
-    if ((p_Calendars == NULL) || (p_Name == NULL) || (pp_Calendar == NULL)) {
-        return CALDAV_ERROR_INVALID_ARG;
+    CalDAV_Inflater_t *p_Inflater = p_Receiver->p_Inflater;
+
+    while ((Length > 0) && (p_Inflater->Stage < CALDAV_INFLATER_DATA)) {
+        if (_CalDAV_Inflater_Header(p_Inflater, *p_Data) == false) {
+            ESP_LOGE(TAG, "Invalid gzip header!");
+            p_Receiver->IsCorrupt = true;
+
+            return;
+        }
+
+        p_Data++;
+        Length--;
     }
 
-    *pp_Calendar = NULL;
+    while (p_Inflater->Stage == CALDAV_INFLATER_DATA) {
+        tinfl_status Status;
+        size_t InSize = Length;
+        size_t OutSize = TINFL_LZ_DICT_SIZE - p_Inflater->Position;
+
+        Status = tinfl_decompress(&p_Inflater->Decompressor, p_Data, &InSize, p_Inflater->Window,
+                                  p_Inflater->Window + p_Inflater->Position, &OutSize,
+                                  p_Inflater->Flags | TINFL_FLAG_HAS_MORE_INPUT);
+        p_Data += InSize;
+        Length -= InSize;
+
+        if (OutSize > 0) {
+            _CalDAV_Receiver_Write(p_Receiver, (const char *)(p_Inflater->Window + p_Inflater->Position), OutSize);
+            p_Inflater->Position = (p_Inflater->Position + OutSize) & (TINFL_LZ_DICT_SIZE - 1);
+        }
+
+        if (Status == TINFL_STATUS_DONE) {
+            /* The deflate data has its own end marker, so the gzip trailer (CRC-32 and size) is skipped */
+            p_Inflater->Stage = CALDAV_INFLATER_DONE;
+        } else if (Status < TINFL_STATUS_DONE) {
+            ESP_LOGE(TAG, "Failed to inflate the response: %d!", Status);
+            p_Receiver->IsCorrupt = true;
+        } else if ((Status == TINFL_STATUS_NEEDS_MORE_INPUT) && (Length == 0)) {
+            break;
+        }
+
+        if (p_Receiver->IsCorrupt) {
+            break;
+        }
+    }
+}
+#endif
+
+#if CONFIG_ESP32_CALDAV_STATS
+/** @brief              Starts the statistics of a request.
+ *  @param p_Client     CalDAV client handle
+ *  @param p_Receiver   Receiver of the request
+ */
+static void _CalDAV_Stats_Begin(CalDAV_Client_t *p_Client, CalDAV_Receiver_t *p_Receiver)
+{
+    p_Receiver->p_Stats = &p_Client->Stats;
+    p_Receiver->StartTime = esp_timer_get_time();
+    p_Receiver->Allocations = _CalDAV_Allocations;
+    p_Receiver->Reallocations = _CalDAV_Reallocations;
+}
+
+/** @brief              Records the time of an HTTP event of a request.
+ *                      esp_http_client reports DNS lookup, TCP connect and TLS handshake as one step, so they
+ *                      are measured together up to HTTP_EVENT_ON_CONNECTED.
+ *  @param p_Receiver   Receiver of the request
+ *  @param p_Event      HTTP event
+ */
+static void _CalDAV_Stats_Event(CalDAV_Receiver_t *p_Receiver, const esp_http_client_event_t *p_Event)
+{
+    int64_t Now;
+
+    if (p_Receiver->p_Stats == NULL) {
+        return;
+    }
+
+    Now = esp_timer_get_time();
+
+    switch (p_Event->event_id) {
+        case HTTP_EVENT_ON_CONNECTED: {
+            p_Receiver->ConnectTime = Now;
+
+            break;
+        }
+        case HTTP_EVENT_HEADERS_SENT: {
+            p_Receiver->SentTime = Now;
+
+            break;
+        }
+        case HTTP_EVENT_ON_HEADER: {
+            if (p_Receiver->FirstByteTime == 0) {
+                p_Receiver->FirstByteTime = Now;
+            }
+
+            break;
+        }
+        case HTTP_EVENT_ON_DATA: {
+            p_Receiver->ReceivedLength += p_Event->data_len;
+
+            break;
+        }
+        case HTTP_EVENT_ON_FINISH: {
+            p_Receiver->FinishTime = Now;
+
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+}
+
+/** @brief              Completes the statistics of a request and adds them to the statistics of the client.
+ *  @param p_Receiver   Receiver of the request
+ *  @param p_Body       Retained body of the request or NULL
+ */
+static void _CalDAV_Stats_End(CalDAV_Receiver_t *p_Receiver, const CalDAV_Arena_Block_t *p_Body)
+{
+    int64_t Now;
+    int64_t SentTime;
+    int64_t FinishTime;
+    CalDAV_Stats_t *p_Stats = p_Receiver->p_Stats;
+
+    if (p_Stats == NULL) {
+        return;
+    }
+
+    Now = esp_timer_get_time();
+    SentTime = (p_Receiver->SentTime != 0) ? p_Receiver->SentTime : p_Receiver->StartTime;
+    FinishTime = (p_Receiver->FinishTime != 0) ? p_Receiver->FinishTime : Now;
+
+    p_Stats->ConnectUs = (p_Receiver->ConnectTime != 0) ? (uint32_t)(p_Receiver->ConnectTime -
+                                                                     p_Receiver->StartTime) : 0;
+    p_Stats->FirstByteUs = (p_Receiver->FirstByteTime != 0) ? (uint32_t)(p_Receiver->FirstByteTime - SentTime) : 0;
+    p_Stats->TransferUs = (p_Receiver->FirstByteTime != 0) ? (uint32_t)(FinishTime - p_Receiver->FirstByteTime) : 0;
+    p_Stats->ParseUs = (uint32_t)p_Receiver->ParseTime;
+    p_Stats->TotalUs = (uint32_t)(Now - p_Receiver->StartTime);
+    p_Stats->ReceivedLength = p_Receiver->ReceivedLength;
+    p_Stats->Allocations = _CalDAV_Allocations - p_Receiver->Allocations;
+    p_Stats->Reallocations = _CalDAV_Reallocations - p_Receiver->Reallocations;
+
+    if (p_Body != NULL) {
+        p_Stats->BufferLength = p_Body->Size;
+    } else if ((p_Receiver->IsRetained == false) && (p_Receiver->p_Parser != NULL)) {
+        p_Stats->BufferLength = CONFIG_ESP32_CALDAV_BUFFER_LENGTH;
+    } else {
+        p_Stats->BufferLength = 0;
+    }
+
+    p_Stats->Requests++;
+    if (p_Receiver->ConnectTime != 0) {
+        p_Stats->Connections++;
+    }
+    p_Stats->BytesReceived += p_Receiver->ReceivedLength;
+    if (p_Stats->BufferLength > p_Stats->PeakBufferLength) {
+        p_Stats->PeakBufferLength = p_Stats->BufferLength;
+    }
+    p_Stats->MinimumFreeHeap = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+
+    p_Receiver->p_Stats = NULL;
+}
+#endif
+
+/** @brief          HTTP Event Handler
+ *                  Response data is passed to the streaming parser chunk by chunk or retained for
+ *                  parsing in place. Compressed responses are inflated first.
+ *  @param p_Event  Pointer to HTTP Event
+ *  @return         ESP_OK on success
+ */
+static esp_err_t on_HTTP_Event_Handler(esp_http_client_event_t *p_Event)
+{
+    CalDAV_Receiver_t *p_Receiver = (CalDAV_Receiver_t *)p_Event->user_data;
+
+    if (p_Receiver == NULL) {
+        return ESP_OK;
+    }
+
+#if CONFIG_ESP32_CALDAV_STATS
+    _CalDAV_Stats_Event(p_Receiver, p_Event);
+#endif
+
+    switch (p_Event->event_id) {
+        case HTTP_EVENT_ON_HEADER: {
+            /* Allocate the retained body at once if the length is known */
+            if (p_Receiver->IsRetained && (strcasecmp(p_Event->header_key, "Content-Length") == 0)) {
+                _CalDAV_Receiver_Reserve(p_Receiver, strtoul(p_Event->header_value, NULL, 10));
+            }
+
+            /* Only the delta-seconds form is used, an HTTP-date leaves the backoff to the caller */
+            if ((p_Receiver->p_RetryAfter != NULL) && (strcasecmp(p_Event->header_key, "Retry-After") == 0)) {
+                *p_Receiver->p_RetryAfter = strtoul(p_Event->header_value, NULL, 10);
+            }
+
+            /* A truncated ETag would never match, so it is dropped */
+            if ((p_Receiver->p_ETag != NULL) && (strcasecmp(p_Event->header_key, "ETag") == 0)) {
+                if (strlen(p_Event->header_value) < p_Receiver->ETagSize) {
+                    snprintf(p_Receiver->p_ETag, p_Receiver->ETagSize, "%s", p_Event->header_value);
+                } else {
+                    ESP_LOGW(TAG, "ETag too long, ignored!");
+                    p_Receiver->p_ETag[0] = '\0';
+                }
+            }
+
+#if CONFIG_ESP32_CALDAV_COMPRESSION
+            if (strcasecmp(p_Event->header_key, "Content-Encoding") == 0) {
+                _CalDAV_Inflater_Begin(p_Receiver, p_Event->header_value);
+            }
+#endif
+
+            break;
+        }
+        case HTTP_EVENT_ON_DATA: {
+            p_Receiver->HasData = true;
+
+            if (p_Receiver->IsOutOfMemory || p_Receiver->IsCorrupt) {
+                break;
+            }
+
+#if CONFIG_ESP32_CALDAV_COMPRESSION
+            if (p_Receiver->p_Inflater != NULL) {
+                _CalDAV_Inflater_Feed(p_Receiver, (const mz_uint8 *)p_Event->data, p_Event->data_len);
+
+                break;
+            }
+#endif
+
+            _CalDAV_Receiver_Write(p_Receiver, (const char *)p_Event->data, p_Event->data_len);
+
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+
+    return ESP_OK;
+}
+
+/** @brief          Extracts the calendar name (last path segment) from a calendar path.
+ *  @param p_Arena  Arena for the name
+ *  @param p_Path   Calendar path (e.g. "/calendars/user/personal/")
+ *  @return         Name or NULL if the path has no name
+ */
+static char *_CalDAV_Path_Name(CalDAV_Arena_t *p_Arena, const char *p_Path)
+{
+    size_t Start;
+    size_t End;
+
+    if (p_Path == NULL) {
+        return NULL;
+    }
+
+    /* Path ends with /, take previous segment */
+    End = strlen(p_Path);
+    while ((End > 0) && (p_Path[End - 1] == '/')) {
+        End--;
+    }
+
+    Start = End;
+    while ((Start > 0) && (p_Path[Start - 1] != '/')) {
+        Start--;
+    }
+
+    if (Start == End) {
+        return NULL;
+    }
+
+    return _CalDAV_Arena_String(p_Arena, p_Path + Start, End - Start);
+}
+
+/** @brief              Parser callback for PROPFIND response blocks.
+ *  @param p_Response   Parsed response block
+ *  @param p_Arg        Calendar collector
+ *  @return             true to continue parsing, false if out of memory
+ */
+static bool on_Calendar_Response(const CalDAV_Parser_Response_t *p_Response, void *p_Arg)
+{
+    CalDAV_Calendar_Collector_t *p_Collector = (CalDAV_Calendar_Collector_t *)p_Arg;
+    CalDAV_Calendar_t *p_Calendar;
+
+    if (p_Response->IsMultistatus) {
+        return true;
+    }
+
+    ESP_LOGD(TAG, "Response href: %s", p_Response->Href ? p_Response->Href : "");
+
+    /* Must have <resourcetype><calendar/> tag to be a real calendar */
+    if (p_Response->IsCalendar == false) {
+        ESP_LOGD(TAG, "  -> Not a calendar (only collection)");
+
+        return true;
+    }
+
+    p_Calendar = (CalDAV_Calendar_t *)_CalDAV_Arena_Element(&p_Collector->Arena);
+    if (p_Calendar == NULL) {
+        return false;
+    }
+
+    p_Calendar->Path = _CalDAV_Arena_String_Duplicate(&p_Collector->Arena, p_Response->Href);
+    p_Calendar->Name = _CalDAV_Path_Name(&p_Collector->Arena, p_Response->Href);
+    p_Calendar->DisplayName = _CalDAV_Arena_String_Duplicate(&p_Collector->Arena, p_Response->DisplayName);
+    p_Calendar->Description = _CalDAV_Arena_String_Duplicate(&p_Collector->Arena, p_Response->Description);
+    p_Calendar->CTag = _CalDAV_Arena_String_Duplicate(&p_Collector->Arena, p_Response->CTag);
+    p_Calendar->SyncToken = _CalDAV_Arena_String_Duplicate(&p_Collector->Arena, p_Response->SyncToken);
+
+    ESP_LOGD(TAG, "Calendar %u:", (unsigned int)p_Collector->Arena.Length);
+    if (p_Calendar->Name) {
+        ESP_LOGD(TAG, "  Name: %s", p_Calendar->Name);
+    }
+
+    if (p_Calendar->DisplayName) {
+        ESP_LOGD(TAG, "  Display name: %s", p_Calendar->DisplayName);
+    }
+
+    if (p_Calendar->Path) {
+        ESP_LOGD(TAG, "  Path: %s", p_Calendar->Path);
+    }
+
+    return (p_Collector->Arena.IsOutOfMemory == false);
+}
+
+/** @brief              Parser callback for discovery PROPFIND responses.
+ *  @param p_Response   Parsed response block
+ *  @param p_Arg        Discovery result
+ *  @return             true to continue parsing, false if out of memory
+ */
+static bool on_Discovery_Response(const CalDAV_Parser_Response_t *p_Response, void *p_Arg)
+{
+    CalDAV_Discovery_t *p_Discovery = (CalDAV_Discovery_t *)p_Arg;
+
+    if (p_Response->IsMultistatus) {
+        return true;
+    }
+
+    if ((p_Discovery->CalendarHome == NULL) && (p_Response->CalendarHome != NULL)) {
+        ESP_LOGD(TAG, "Found calendar home: %s", p_Response->CalendarHome);
+
+        p_Discovery->CalendarHome = _CalDAV_String_Duplicate(p_Response->CalendarHome);
+        if (p_Discovery->CalendarHome == NULL) {
+            p_Discovery->IsOutOfMemory = true;
+
+            return false;
+        }
+    }
+
+    /* Servers without current-user-principal report the principal itself */
+    if (p_Discovery->Principal == NULL) {
+        const char *p_Principal = p_Response->CurrentUserPrincipal;
+
+        if ((p_Principal == NULL) && p_Response->IsPrincipal) {
+            p_Principal = p_Response->Href;
+        }
+
+        if (p_Principal != NULL) {
+            ESP_LOGD(TAG, "Found principal: %s", p_Principal);
+
+            p_Discovery->Principal = _CalDAV_String_Duplicate(p_Principal);
+            if (p_Discovery->Principal == NULL) {
+                p_Discovery->IsOutOfMemory = true;
+
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/** @brief              Parser callback for the response of a change check.
+ *                      The sync-token is preferred, because it changes with every modification of the collection.
+ *                      The same tag is stored as the change tag.
+ *  @param p_Response   Parsed response block
+ *  @param p_Arg        Change check
+ *  @return             true to continue parsing
+ */
+static bool on_Change_Response(const CalDAV_Parser_Response_t *p_Response, void *p_Arg)
+{
+    CalDAV_Change_Check_t *p_Check = (CalDAV_Change_Check_t *)p_Arg;
+    const CalDAV_Calendar_t *p_Calendar = p_Check->p_Calendar;
+    const char *p_Tag;
+
+    /* Depth 0 returns a single response */
+    if (p_Check->HasResponse || p_Response->IsMultistatus) {
+        return true;
+    }
+
+    p_Check->HasResponse = true;
+
+    if (p_Check->p_Tag != NULL) {
+        p_Tag = (p_Response->SyncToken != NULL) ? p_Response->SyncToken : p_Response->CTag;
+        if (p_Tag == NULL) {
+            p_Tag = "";
+        }
+
+        if (strlen(p_Tag) >= p_Check->TagSize) {
+            p_Check->IsTruncated = true;
+        } else {
+            snprintf(p_Check->p_Tag, p_Check->TagSize, "%s", p_Tag);
+        }
+    }
+
+    if (p_Calendar == NULL) {
+        return true;
+    }
+
+    if ((p_Calendar->SyncToken != NULL) && (p_Response->SyncToken != NULL)) {
+        p_Check->IsChanged = (strcmp(p_Calendar->SyncToken, p_Response->SyncToken) != 0);
+    } else if ((p_Calendar->CTag != NULL) && (p_Response->CTag != NULL)) {
+        p_Check->IsChanged = (strcmp(p_Calendar->CTag, p_Response->CTag) != 0);
+    } else {
+        /* Server offers no tag, so a change can not be ruled out */
+        p_Check->IsChanged = true;
+    }
+
+    ESP_LOGD(TAG, "Calendar tags: ctag %s, sync-token %s -> %s", p_Response->CTag ? p_Response->CTag : "-",
+             p_Response->SyncToken ? p_Response->SyncToken : "-", p_Check->IsChanged ? "changed" : "unchanged");
+
+    return true;
+}
+
+/** @brief          Parser callback for VEVENTs of a sync-collection REPORT.
+ *  @param p_Event  Parsed event
+ *  @param p_Arg    Sync context
+ *  @return         Result of the user callback
+ */
+static bool on_Sync_Event(const CalDAV_Calendar_Event_t *p_Event, void *p_Arg)
+{
+    CalDAV_Sync_Context_t *p_Context = (CalDAV_Sync_Context_t *)p_Arg;
+    CalDAV_Sync_Change_t Change;
+
+    Change.Href = CalDAV_Parser_Get_Field(p_Context->p_Parser, CALDAV_PARSER_RESPONSE_HREF);
+    Change.ETag = CalDAV_Parser_Get_Field(p_Context->p_Parser, CALDAV_PARSER_RESPONSE_ETAG);
+    Change.IsDeleted = false;
+    Change.p_Event = p_Event;
+
+    p_Context->Events++;
+
+    return p_Context->Callback(&Change, p_Context->p_Arg);
+}
+
+/** @brief              Parser callback for response blocks of a sync-collection REPORT.
+ *                      Deleted resources and changed resources without an event are reported here, the
+ *                      events itself are reported by on_Sync_Event.
+ *  @param p_Response   Parsed response block
+ *  @param p_Arg        Sync context
+ *  @return             Result of the user callback
+ */
+static bool on_Sync_Response(const CalDAV_Parser_Response_t *p_Response, void *p_Arg)
+{
+    CalDAV_Sync_Context_t *p_Context = (CalDAV_Sync_Context_t *)p_Arg;
+    CalDAV_Sync_Change_t Change;
+    size_t Events;
+
+    if (p_Response->IsMultistatus) {
+        if (p_Response->SyncToken != NULL) {
+            p_Context->HasToken = true;
+            p_Context->IsTokenTruncated = (strlen(p_Response->SyncToken) >= p_Context->TokenSize);
+            if (p_Context->IsTokenTruncated == false) {
+                strcpy(p_Context->p_SyncToken, p_Response->SyncToken);
+            }
+        }
+
+        return true;
+    }
+
+    Events = p_Context->Events;
+    p_Context->Events = 0;
+
+    if (p_Response->Href == NULL) {
+        return true;
+    }
+
+    /* The server has limited the result, the remaining changes follow with the new token */
+    if (p_Response->Status == 507) {
+        ESP_LOGD(TAG, "Sync result truncated by the server");
+
+        return true;
+    }
+
+    if ((p_Response->Status != 404) && (Events > 0)) {
+        return true;
+    }
+
+    Change.Href = p_Response->Href;
+    Change.ETag = p_Response->ETag;
+    Change.IsDeleted = (p_Response->Status == 404);
+    Change.p_Event = NULL;
+
+    return p_Context->Callback(&Change, p_Context->p_Arg);
+}
+
+/** @brief          Parser callback for VEVENTs of a REPORT response.
+ *  @param p_Event  Parsed event
+ *  @param p_Arg    Event arena
+ *  @return         true to continue parsing, false if out of memory
+ */
+static bool on_Calendar_Event(const CalDAV_Calendar_Event_t *p_Event, void *p_Arg)
+{
+    CalDAV_Arena_t *p_Arena = (CalDAV_Arena_t *)p_Arg;
+    CalDAV_Calendar_Event_t *p_Target;
+
+    p_Target = (CalDAV_Calendar_Event_t *)_CalDAV_Arena_Element(p_Arena);
+    if (p_Target == NULL) {
+        return false;
+    }
+
+    p_Target->UID = _CalDAV_Arena_String_Duplicate(p_Arena, p_Event->UID);
+    p_Target->Summary = _CalDAV_Arena_String_Duplicate(p_Arena, p_Event->Summary);
+    p_Target->Description = _CalDAV_Arena_String_Duplicate(p_Arena, p_Event->Description);
+    p_Target->StartTime = _CalDAV_Arena_String_Duplicate(p_Arena, p_Event->StartTime);
+    p_Target->EndTime = _CalDAV_Arena_String_Duplicate(p_Arena, p_Event->EndTime);
+    p_Target->Location = _CalDAV_Arena_String_Duplicate(p_Arena, p_Event->Location);
+    p_Target->Start = p_Event->Start;
+    p_Target->End = p_Event->End;
+    p_Target->Offset = p_Event->Offset;
+    p_Target->IsAllDay = p_Event->IsAllDay;
+
+    return (p_Arena->IsOutOfMemory == false);
+}
+
+/** @brief          Finds the entry of a resource in an event cache.
+ *  @param p_Cache  Event cache
+ *  @param p_Href   Path of the resource
+ *  @return         Entry or NULL if the resource is not cached
+ */
+static CalDAV_Event_Cache_Entry_t *_CalDAV_Event_Cache_Find(CalDAV_Event_Cache_t *p_Cache, const char *p_Href)
+{
+    for (size_t i = 0; i < p_Cache->Length; i++) {
+        if (strcmp(p_Cache->p_Entries[i].Href, p_Href) == 0) {
+            return &p_Cache->p_Entries[i];
+        }
+    }
+
+    return NULL;
+}
+
+/** @brief          Removes an entry from an event cache. The last entry takes its place.
+ *  @param p_Cache  Event cache
+ *  @param Index    Index of the entry
+ */
+static void _CalDAV_Event_Cache_Remove(CalDAV_Event_Cache_t *p_Cache, size_t Index)
+{
+    CalDAV_Event_Cache_Entry_t *p_Entry = &p_Cache->p_Entries[Index];
+
+    CUSTOM_FREE(p_Entry->Href);
+    CUSTOM_FREE(p_Entry->ETag);
+    _CalDAV_Arena_Free(p_Entry->p_Events);
+
+    p_Cache->Length--;
+    *p_Entry = p_Cache->p_Entries[p_Cache->Length];
+}
+
+/** @brief              Parser callback for the ETag listing of an event cache refresh.
+ *                      Marks known resources as seen and adds new or changed resources as stale.
+ *  @param p_Response   Parsed response block
+ *  @param p_Arg        Cache context
+ *  @return             true to continue parsing, false if out of memory
+ */
+static bool on_Cache_ETag_Response(const CalDAV_Parser_Response_t *p_Response, void *p_Arg)
+{
+    CalDAV_Cache_Context_t *p_Context = (CalDAV_Cache_Context_t *)p_Arg;
+    CalDAV_Event_Cache_t *p_Cache = p_Context->p_Cache;
+    CalDAV_Event_Cache_Entry_t *p_Entry;
+
+    if (p_Response->IsMultistatus || (p_Response->Href == NULL) || (p_Response->ETag == NULL) ||
+        (p_Response->Status == 404)) {
+        return true;
+    }
+
+    p_Entry = _CalDAV_Event_Cache_Find(p_Cache, p_Response->Href);
+    if (p_Entry != NULL) {
+        p_Entry->IsSeen = true;
+        if ((p_Entry->ETag == NULL) || (strcmp(p_Entry->ETag, p_Response->ETag) != 0)) {
+            p_Entry->IsStale = true;
+            p_Context->Changed++;
+        }
+
+        return true;
+    }
+
+    if (p_Cache->Length == p_Cache->MaxEntries) {
+        p_Context->IsFull = true;
+
+        return true;
+    }
+
+    p_Entry = &p_Cache->p_Entries[p_Cache->Length];
+    memset(p_Entry, 0, sizeof(CalDAV_Event_Cache_Entry_t));
+    p_Entry->Href = _CalDAV_String_Duplicate(p_Response->Href);
+    if (p_Entry->Href == NULL) {
+        p_Context->IsOutOfMemory = true;
+
+        return false;
+    }
+
+    p_Entry->IsSeen = true;
+    p_Entry->IsStale = true;
+    p_Cache->Length++;
+    p_Context->Changed++;
+
+    return true;
+}
+
+/** @brief          Parser callback for VEVENTs of a calendar-multiget REPORT.
+ *  @param p_Event  Parsed event
+ *  @param p_Arg    Cache context
+ *  @return         true to continue parsing, false if out of memory
+ */
+static bool on_Cache_Event(const CalDAV_Calendar_Event_t *p_Event, void *p_Arg)
+{
+    CalDAV_Cache_Context_t *p_Context = (CalDAV_Cache_Context_t *)p_Arg;
+
+    if (on_Calendar_Event(p_Event, &p_Context->Arena) == false) {
+        p_Context->IsOutOfMemory = true;
+
+        return false;
+    }
+
+    return true;
+}
+
+/** @brief              Parser callback for response blocks of a calendar-multiget REPORT.
+ *                      Replaces the events of a stale cache entry with the events received for it.
+ *  @param p_Response   Parsed response block
+ *  @param p_Arg        Cache context
+ *  @return             Always true
+ */
+static bool on_Cache_Multiget_Response(const CalDAV_Parser_Response_t *p_Response, void *p_Arg)
+{
+    CalDAV_Cache_Context_t *p_Context = (CalDAV_Cache_Context_t *)p_Arg;
+    CalDAV_Event_Cache_Entry_t *p_Entry = NULL;
+    char *p_ETag;
+
+    if (p_Response->IsMultistatus) {
+        return true;
+    }
+
+    if (p_Response->Href != NULL) {
+        p_Entry = _CalDAV_Event_Cache_Find(p_Context->p_Cache, p_Response->Href);
+    }
+
+    /* Unknown or missing resources stay stale and are removed after the refresh */
+    if ((p_Entry == NULL) || (p_Entry->IsStale == false) || (p_Response->Status != 0) ||
+        (p_Response->ETag == NULL)) {
+        _CalDAV_Arena_Free(_CalDAV_Arena_Finish(&p_Context->Arena));
+        _CalDAV_Arena_Init(&p_Context->Arena, sizeof(CalDAV_Calendar_Event_t), NULL, 0);
+
+        return true;
+    }
+
+    p_ETag = _CalDAV_String_Duplicate(p_Response->ETag);
+    if (p_ETag == NULL) {
+        p_Context->IsOutOfMemory = true;
+        _CalDAV_Arena_Free(_CalDAV_Arena_Finish(&p_Context->Arena));
+        _CalDAV_Arena_Init(&p_Context->Arena, sizeof(CalDAV_Calendar_Event_t), NULL, 0);
+
+        return true;
+    }
+
+    CUSTOM_FREE(p_Entry->ETag);
+    _CalDAV_Arena_Free(p_Entry->p_Events);
+
+    p_Entry->ETag = p_ETag;
+    p_Entry->Length = p_Context->Arena.Length;
+    p_Entry->p_Events = (CalDAV_Calendar_Event_t *)_CalDAV_Arena_Finish(&p_Context->Arena);
+    p_Entry->IsStale = false;
+    _CalDAV_Arena_Init(&p_Context->Arena, sizeof(CalDAV_Calendar_Event_t), NULL, 0);
+
+    return true;
+}
+
+/** @brief          Parser callback for busy periods of a free-busy-query REPORT.
+ *                  Merges the period into the sorted period array. When the array is full, the latest periods
+ *                  are dropped, so the stored periods stay complete up to the earliest dropped one.
+ *  @param Start    Start of the period in seconds since 1970 (UTC)
+ *  @param End      End of the period in seconds since 1970 (UTC)
+ *  @param p_Arg    Free busy context
+ *  @return         Always true
+ */
+static bool on_Free_Busy_Period(time_t Start, time_t End, void *p_Arg)
+{
+    CalDAV_Free_Busy_t *p_FreeBusy = (CalDAV_Free_Busy_t *)p_Arg;
+    CalDAV_Busy_Period_t *p_Periods = p_FreeBusy->p_Periods;
+    size_t First = 0;
+    size_t Last;
+
+    if (p_FreeBusy->IsTruncated) {
+        if (Start >= p_FreeBusy->Limit) {
+            return true;
+        }
+
+        if (End > p_FreeBusy->Limit) {
+            End = p_FreeBusy->Limit;
+        }
+    }
+
+    /* Periods First to Last - 1 overlap or touch the new period */
+    while ((First < p_FreeBusy->Length) && (p_Periods[First].End < Start)) {
+        First++;
+    }
+
+    Last = First;
+    while ((Last < p_FreeBusy->Length) && (p_Periods[Last].Start <= End)) {
+        Last++;
+    }
+
+    if (Last > First) {
+        if (Start < p_Periods[First].Start) {
+            p_Periods[First].Start = Start;
+        }
+
+        p_Periods[First].End = (p_Periods[Last - 1].End > End) ? p_Periods[Last - 1].End : End;
+
+        memmove(&p_Periods[First + 1], &p_Periods[Last], (p_FreeBusy->Length - Last) * sizeof(CalDAV_Busy_Period_t));
+        p_FreeBusy->Length -= Last - First - 1;
+
+        return true;
+    }
+
+    if (p_FreeBusy->Length == p_FreeBusy->Max) {
+        p_FreeBusy->IsTruncated = true;
+
+        if (First == p_FreeBusy->Length) {
+            p_FreeBusy->Limit = Start;
+
+            return true;
+        }
+
+        p_FreeBusy->Length--;
+        p_FreeBusy->Limit = p_Periods[p_FreeBusy->Length].Start;
+    }
+
+    memmove(&p_Periods[First + 1], &p_Periods[First], (p_FreeBusy->Length - First) * sizeof(CalDAV_Busy_Period_t));
+    p_Periods[First].Start = Start;
+    p_Periods[First].End = End;
+    p_FreeBusy->Length++;
+
+    return true;
+}
+
+/** @brief          Encodes the "Authorization" header of a CalDAV client for HTTP Basic authentication.
+ *  @param p_Client CalDAV client handle
+ *  @return         true on success, false if the credentials are too long
+ */
+static bool _CalDAV_HTTP_Authorization(CalDAV_Client_t *p_Client)
+{
+    int Length;
+    int Error;
+    size_t Encoded;
+    char Credentials[sizeof(p_Client->Username) + sizeof(p_Client->Password)];
+
+    Length = snprintf(Credentials, sizeof(Credentials), "%s:%s", p_Client->Username, p_Client->Password);
+
+    memcpy(p_Client->Authorization, "Basic ", 6);
+    Error = mbedtls_base64_encode((unsigned char *)p_Client->Authorization + 6, sizeof(p_Client->Authorization) - 6,
+                                  &Encoded, (const unsigned char *)Credentials, (size_t)Length);
+
+    /* No copy of the plain credentials is left on the stack */
+    memset(Credentials, 0, sizeof(Credentials));
+
+    return (Error == 0);
+}
+
+/** @brief          Returns the persistent HTTP client of a CalDAV client and creates it on first use.
+ *                  The handle is created with keep-alive enabled and stays open until CalDAV_Client_Deinit,
+ *                  so consecutive requests share one TCP / TLS session. The configuration is built from the
+ *                  client itself and copied by esp_http_client_init, so clients do not share any state.
+ *  @param p_Client CalDAV client handle
+ *  @return         HTTP client handle or NULL on failure
+ */
+static esp_http_client_handle_t _CalDAV_HTTP_Get_Handle(CalDAV_Client_t *p_Client)
+{
+    if (p_Client->HTTP_Client != NULL) {
+        return p_Client->HTTP_Client;
+    }
+
+    esp_http_client_config_t Config;
+
+    /* Initialize HTTP config completely to avoid garbage values */
+    memset(&Config, 0, sizeof(Config));
+
+    Config.transport_type = HTTP_TRANSPORT_OVER_SSL;
+    Config.crt_bundle_attach = esp_crt_bundle_attach;
+    Config.url = p_Client->ServerURL;
+    Config.timeout_ms = p_Client->TimeoutMs;
+    Config.event_handler = on_HTTP_Event_Handler;
+    Config.keep_alive_enable = true;
+#if CONFIG_ESP32_CALDAV_ASYNC
+    Config.is_async = true;
+#endif
+#if CONFIG_ESP32_CALDAV_TLS_SESSION_TICKETS
+    Config.save_client_session = true;
+#endif
+
+    p_Client->HTTP_Client = esp_http_client_init(&Config);
+    if (p_Client->HTTP_Client == NULL) {
+        ESP_LOGE(TAG, "HTTP client initialization failed!");
+
+        return NULL;
+    }
+
+    /* The header stays set for all requests. With the credentials in the configuration the HTTP client would
+       encode them again for every request */
+    esp_http_client_set_header(p_Client->HTTP_Client, "Authorization", p_Client->Authorization);
+
+    return p_Client->HTTP_Client;
+}
+
+/** @brief              Prepares a single request over the persistent HTTP client of a CalDAV client.
+ *                      Headers from previous requests are reset, so every request only carries its own headers.
+ *                      The conditional headers and the content type of the body are taken from the receiver.
+ *                      The request is sent by _CalDAV_HTTP_Continue.
+ *  @param p_Client     CalDAV client handle
+ *  @param p_URL        Request URL
+ *  @param Method       HTTP method
+ *  @param p_Depth      Value of the "Depth" header or NULL to omit it
+ *  @param p_Override   Value of the "X-HTTP-Method-Override" header or NULL to omit it
+ *  @param p_Body       Request body or NULL (must stay valid until the request has finished)
+ *  @param BodyLength   Length of the request body
+ *  @param p_Receiver   Receiver for the response body
+ *  @return             ESP_OK on success, ESP_FAIL if the HTTP client can not be created
+ */
+static esp_err_t _CalDAV_HTTP_Start(CalDAV_Client_t *p_Client, const char *p_URL, esp_http_client_method_t Method,
+                                    const char *p_Depth, const char *p_Override, const char *p_Body,
+                                    size_t BodyLength, CalDAV_Receiver_t *p_Receiver)
+{
+    esp_http_client_handle_t HTTP_Client;
+
+    HTTP_Client = _CalDAV_HTTP_Get_Handle(p_Client);
+    if (HTTP_Client == NULL) {
+        return ESP_FAIL;
+    }
+
+    esp_http_client_set_url(HTTP_Client, p_URL);
+    esp_http_client_set_method(HTTP_Client, Method);
+    esp_http_client_set_user_data(HTTP_Client, p_Receiver);
+
+    p_Client->RetryAfter = 0;
+    p_Receiver->p_RetryAfter = &p_Client->RetryAfter;
+
+    esp_http_client_delete_header(HTTP_Client, "Depth");
+    esp_http_client_delete_header(HTTP_Client, "Content-Type");
+    esp_http_client_delete_header(HTTP_Client, "X-HTTP-Method-Override");
+    esp_http_client_delete_header(HTTP_Client, "If-None-Match");
+    esp_http_client_delete_header(HTTP_Client, "If-Match");
+
+#if CONFIG_ESP32_CALDAV_COMPRESSION
+    /* Only a body that is parsed can be inflated */
+    esp_http_client_delete_header(HTTP_Client, "Accept-Encoding");
+    if (p_Receiver->p_Parser != NULL) {
+        esp_http_client_set_header(HTTP_Client, "Accept-Encoding", "gzip, deflate");
+    }
+#endif
+
+    if (p_Depth != NULL) {
+        esp_http_client_set_header(HTTP_Client, "Depth", p_Depth);
+    }
+
+    if (p_Override != NULL) {
+        esp_http_client_set_header(HTTP_Client, "X-HTTP-Method-Override", p_Override);
+    }
+
+    if (p_Body != NULL) {
+        esp_http_client_set_header(HTTP_Client, "Content-Type", (p_Receiver->p_ContentType != NULL) ?
+                                   p_Receiver->p_ContentType : "application/xml; charset=utf-8");
+    }
+
+    if (p_Receiver->p_IfNoneMatch != NULL) {
+        esp_http_client_set_header(HTTP_Client, "If-None-Match", p_Receiver->p_IfNoneMatch);
+    }
+
+    if (p_Receiver->p_IfMatch != NULL) {
+        esp_http_client_set_header(HTTP_Client, "If-Match", p_Receiver->p_IfMatch);
+    }
+
+    esp_http_client_set_post_field(HTTP_Client, p_Body, BodyLength);
+
+    return ESP_OK;
+}
+
+/** @brief              Advances the request prepared by _CalDAV_HTTP_Start.
+ *                      If the server has dropped the kept-alive connection in the meantime, the connection
+ *                      is closed and the request is repeated once on a fresh connection, as long as no data of
+ *                      the response body has been passed to the parser or the retained body. A request that is not
+ *                      retryable is only repeated when it could not be sent completely, because a server does
+ *                      not process an incomplete request. Without a response it may have been processed.
+ *  @param p_Client     CalDAV client handle
+ *  @param p_Receiver   Receiver of the request
+ *  @param p_StatusCode Pointer to store the HTTP status code
+ *  @return             ESP_OK when the request was performed, ESP_ERR_HTTP_EAGAIN if the request waits for the
+ *                      network (asynchronous mode only), error code of esp_http_client otherwise
+ */
+static esp_err_t _CalDAV_HTTP_Continue(CalDAV_Client_t *p_Client, CalDAV_Receiver_t *p_Receiver, int *p_StatusCode)
+{
+    esp_err_t Error;
+
+    Error = esp_http_client_perform(p_Client->HTTP_Client);
+
+    /* The connection can also be closed in the middle of the body. A second copy of it would be parsed behind the
+       first one and the events that were already reported can not be taken back, so this is an error */
+    if ((p_Receiver->IsRetried == false) && (p_Receiver->HasData == false) &&
+        ((Error == ESP_ERR_HTTP_WRITE_DATA) ||
+         ((p_Receiver->IsNotRetryable == false) && ((Error == ESP_ERR_HTTP_FETCH_HEADER) ||
+                                                    (Error == ESP_ERR_HTTP_CONNECTION_CLOSED))))) {
+        ESP_LOGD(TAG, "Kept-alive connection lost (%d), reconnecting...", Error);
+
+        /* Nothing of the body has been received, so the parser and the retained body are still untouched */
+        esp_http_client_close(p_Client->HTTP_Client);
+        p_Receiver->IsRetried = true;
+
+        Error = esp_http_client_perform(p_Client->HTTP_Client);
+    }
+
+    *p_StatusCode = esp_http_client_get_status_code(p_Client->HTTP_Client);
+
+    return Error;
+}
+
+/** @brief              Performs a single request over the persistent HTTP client of a CalDAV client and waits
+ *                      until it has finished.
+ *  @param p_Client     CalDAV client handle
+ *  @param p_URL        Request URL
+ *  @param Method       HTTP method
+ *  @param p_Depth      Value of the "Depth" header or NULL to omit it
+ *  @param p_Override   Value of the "X-HTTP-Method-Override" header or NULL to omit it
+ *  @param p_Body       Request body or NULL
+ *  @param BodyLength   Length of the request body
+ *  @param p_Receiver   Receiver for the response body
+ *  @param p_StatusCode Pointer to store the HTTP status code
+ *  @return             ESP_OK when the request was performed, ESP_ERR_INVALID_STATE if an asynchronous request
+ *                      is active, error code of esp_http_client otherwise
+ */
+static esp_err_t _CalDAV_HTTP_Perform(CalDAV_Client_t *p_Client, const char *p_URL, esp_http_client_method_t Method,
+                                      const char *p_Depth, const char *p_Override, const char *p_Body,
+                                      size_t BodyLength, CalDAV_Receiver_t *p_Receiver, int *p_StatusCode)
+{
+    esp_err_t Error;
+
+    *p_StatusCode = 0;
+
+    /* The HTTP client is busy with the exchange of the asynchronous request */
+    if (p_Client->p_Request != NULL) {
+        ESP_LOGE(TAG, "Asynchronous request in progress!");
+
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    Error = _CalDAV_HTTP_Start(p_Client, p_URL, Method, p_Depth, p_Override, p_Body, BodyLength, p_Receiver);
+    if (Error != ESP_OK) {
+        return Error;
+    }
+
+    do {
+        Error = _CalDAV_HTTP_Continue(p_Client, p_Receiver, p_StatusCode);
+        if (Error == ESP_ERR_HTTP_EAGAIN) {
+            vTaskDelay(1);
+        }
+    } while (Error == ESP_ERR_HTTP_EAGAIN);
+
+    return Error;
+}
+
+/** @brief              Prepares a receiver for a multistatus response.
+ *                      A streamed response is parsed while it is received, using a working buffer of
+ *                      CONFIG_ESP32_CALDAV_BUFFER_LENGTH bytes. A retained response is parsed in place by
+ *                      _CalDAV_Receiver_End. In the fixed memory profile the buffers of the client are used.
+ *  @param p_Client     CalDAV client handle
+ *  @param p_Receiver   Receiver to prepare
+ *  @param p_Parser     Parser used for the response
+ *  @param IsRetained   Retain the response instead of parsing it while it is received
+ *  @param on_Response  Response block callback (optional)
+ *  @param on_Event     Event callback (optional)
+ *  @param p_Arg        User argument for the callbacks
+ *  @return             ESP_OK on success, ESP_ERR_NO_MEM if out of memory
+ */
+static esp_err_t _CalDAV_Receiver_Begin(CalDAV_Client_t *p_Client, CalDAV_Receiver_t *p_Receiver,
+                                        CalDAV_Parser_t *p_Parser, bool IsRetained,
+                                        CalDAV_Parser_On_Response_t on_Response, CalDAV_Parser_On_Event_t on_Event,
+                                        void *p_Arg)
+{
+    char *p_Buffer = NULL;
+
+    memset(p_Receiver, 0, sizeof(CalDAV_Receiver_t));
+
+#if CONFIG_ESP32_CALDAV_STATS
+    _CalDAV_Stats_Begin(p_Client, p_Receiver);
+#endif
+
+#if CONFIG_ESP32_CALDAV_FIXED_MEMORY
+    /* Only one request of a client can run at a time, so the buffers are never used twice */
+    p_Receiver->p_Reserved = (struct CalDAV_Inflater_t *)p_Client->p_Inflater;
+    if (IsRetained == false) {
+        p_Buffer = p_Client->p_Buffer;
+        p_Receiver->IsShared = true;
+    }
+#else
+    if (IsRetained == false) {
+        p_Buffer = (char *)CUSTOM_BUFFER_MALLOC(CONFIG_ESP32_CALDAV_BUFFER_LENGTH);
+        if (p_Buffer == NULL) {
+            ESP_LOGE(TAG, "Failed to allocate parser buffer!");
+
+            return ESP_ERR_NO_MEM;
+        }
+    }
+#endif
+
+    CalDAV_Parser_Init(p_Parser, p_Buffer, (p_Buffer != NULL) ? CONFIG_ESP32_CALDAV_BUFFER_LENGTH : 0, on_Response,
+                       on_Event, p_Arg);
+    p_Receiver->p_Parser = p_Parser;
+    p_Receiver->IsRetained = IsRetained;
+
+    return ESP_OK;
+}
+
+/** @brief              Completes a receiver after the request has finished.
+ *                      The working buffer of a streamed response is released unless it belongs to the client. A
+ *                      retained response is parsed in place, so the values passed to the callbacks stay valid in
+ *                      the body.
+ *  @param p_Receiver   Receiver
+ *  @param Error        Result of the request
+ *  @param pp_Body      Pointer to store the retained body (caller must free it)
+ *  @return             Error, ESP_ERR_NO_MEM if out of memory, ESP_ERR_INVALID_RESPONSE if a compressed body
+ *                      can not be inflated
+ */
+static esp_err_t _CalDAV_Receiver_End(CalDAV_Receiver_t *p_Receiver, esp_err_t Error, CalDAV_Arena_Block_t **pp_Body)
+{
+    CalDAV_Parser_t *p_Parser = p_Receiver->p_Parser;
+
+    *pp_Body = NULL;
+
+#if CONFIG_ESP32_CALDAV_COMPRESSION
+    if ((Error == ESP_OK) && (p_Receiver->IsCorrupt || ((p_Receiver->p_Inflater != NULL) &&
+                                                       (p_Receiver->p_Inflater->Stage != CALDAV_INFLATER_DONE)))) {
+        ESP_LOGE(TAG, "Compressed response is corrupt or incomplete!");
+
+        Error = ESP_ERR_INVALID_RESPONSE;
+    }
+
+    if (p_Receiver->p_Inflater != p_Receiver->p_Reserved) {
+        CUSTOM_FREE(p_Receiver->p_Inflater);
+    }
+    p_Receiver->p_Inflater = NULL;
+#endif
+
+    if (p_Receiver->IsRetained == false) {
+        if (p_Receiver->IsShared == false) {
+            CUSTOM_FREE(p_Parser->Buffer);
+        }
+        p_Parser->Buffer = NULL;
+
+        if (p_Receiver->IsOutOfMemory) {
+            ESP_LOGE(TAG, "Failed to allocate memory for the response!");
+
+            Error = ESP_ERR_NO_MEM;
+        }
+    } else if (p_Receiver->IsOutOfMemory) {
+        ESP_LOGE(TAG, "Failed to allocate memory for the response!");
+        CUSTOM_FREE(p_Receiver->p_Body);
+        p_Receiver->p_Body = NULL;
+
+        Error = ESP_ERR_NO_MEM;
+    } else {
+        if ((Error == ESP_OK) && (p_Receiver->p_Body != NULL)) {
+#if CONFIG_ESP32_CALDAV_STATS
+            p_Receiver->ParseTime -= esp_timer_get_time();
+#endif
+
+            CalDAV_Parser_Parse_In_Place(p_Parser, (char *)(p_Receiver->p_Body + 1), p_Receiver->p_Body->Used,
+                                         p_Parser->on_Response, p_Parser->on_Event, p_Parser->p_Arg);
+
+#if CONFIG_ESP32_CALDAV_STATS
+            p_Receiver->ParseTime += esp_timer_get_time();
+#endif
+        }
+
+        *pp_Body = p_Receiver->p_Body;
+        p_Receiver->p_Body = NULL;
+    }
+
+#if CONFIG_ESP32_CALDAV_STATS
+    _CalDAV_Stats_End(p_Receiver, *pp_Body);
+#endif
+
+    return Error;
+}
+
+/** @brief              Performs a request and parses the multistatus response.
+ *                      Without pp_Body the response is parsed while it is received, using a working buffer of
+ *                      CONFIG_ESP32_CALDAV_BUFFER_LENGTH bytes. With pp_Body the complete response is retained
+ *                      and parsed in place, so the values passed to the callbacks stay valid in the body.
+ *  @param p_Client     CalDAV client handle
+ *  @param p_URL        Request URL
+ *  @param Method       HTTP method
+ *  @param p_Depth      Value of the "Depth" header or NULL to omit it
+ *  @param p_Override   Value of the "X-HTTP-Method-Override" header or NULL to omit it
+ *  @param p_Body       Request body
+ *  @param BodyLength   Length of the request body
+ *  @param p_Parser     Parser used for the response
+ *  @param on_Response  Response block callback (optional)
+ *  @param on_Event     Event callback (optional)
+ *  @param p_Arg        User argument for the callbacks
+ *  @param pp_Body      Pointer to store the retained body (caller must free it) or NULL to stream the response
+ *  @param p_StatusCode Pointer to store the HTTP status code
+ *  @return             ESP_OK when the request was performed, ESP_ERR_NO_MEM if out of memory,
+ *                      error code of esp_http_client otherwise
+ */
+static esp_err_t _CalDAV_HTTP_Parse(CalDAV_Client_t *p_Client, const char *p_URL, esp_http_client_method_t Method,
+                                    const char *p_Depth, const char *p_Override, const char *p_Body,
+                                    size_t BodyLength, CalDAV_Parser_t *p_Parser,
+                                    CalDAV_Parser_On_Response_t on_Response, CalDAV_Parser_On_Event_t on_Event,
+                                    void *p_Arg, CalDAV_Arena_Block_t **pp_Body, int *p_StatusCode)
+{
+    esp_err_t Error;
+    CalDAV_Receiver_t Receiver;
+    CalDAV_Arena_Block_t *p_Retained = NULL;
+
+    Error = _CalDAV_Receiver_Begin(p_Client, &Receiver, p_Parser, (pp_Body != NULL), on_Response, on_Event, p_Arg);
+    if (Error != ESP_OK) {
+        return Error;
+    }
+
+    Error = _CalDAV_HTTP_Perform(p_Client, p_URL, Method, p_Depth, p_Override, p_Body, BodyLength, &Receiver,
+                                 p_StatusCode);
+    Error = _CalDAV_Receiver_End(&Receiver, Error, &p_Retained);
+
+    if (pp_Body != NULL) {
+        *pp_Body = p_Retained;
+    }
+
+    return Error;
+}
+
+/** @brief              Prepares an empty request body.
+ *                      In the fixed memory profile the body is written to the request buffer of the client.
+ *  @param p_Client     CalDAV client handle
+ *  @param p_Document   Request body to prepare
+ */
+static void _CalDAV_Document_Init(const CalDAV_Client_t *p_Client, CalDAV_Document_t *p_Document)
+{
+    memset(p_Document, 0, sizeof(CalDAV_Document_t));
+
+#if CONFIG_ESP32_CALDAV_FIXED_MEMORY
+    p_Document->p_Data = p_Client->p_Document;
+    p_Document->Size = CONFIG_ESP32_CALDAV_MAX_REQUEST_LENGTH;
+    p_Document->IsFixed = true;
+#else
+    (void)p_Client;
+#endif
+}
+
+/** @brief              Appends data to a request body.
+ *  @param p_Document   Request body
+ *  @param p_Data       Data to append
+ *  @param Length       Length of the data
+ */
+static void _CalDAV_Document_Append_Length(CalDAV_Document_t *p_Document, const char *p_Data, size_t Length)
+{
+    if (p_Document->IsOutOfMemory) {
+        return;
+    }
+
+    if ((p_Document->Length + Length) > p_Document->Size) {
+        size_t Size;
+        char *p_NewData;
+
+        if (p_Document->IsFixed) {
+            ESP_LOGE(TAG, "Request exceeds %u bytes!", (unsigned int)p_Document->Size);
+            p_Document->IsOutOfMemory = true;
+
+            return;
+        }
+
+        Size = (p_Document->Size == 0) ? 512 : p_Document->Size;
+        while (Size < (p_Document->Length + Length)) {
+            Size *= 2;
+        }
+
+        p_NewData = (char *)CUSTOM_BUFFER_REALLOC(p_Document->p_Data, Size);
+        if (p_NewData == NULL) {
+            p_Document->IsOutOfMemory = true;
+
+            return;
+        }
+
+        p_Document->p_Data = p_NewData;
+        p_Document->Size = Size;
+    }
+
+    memcpy(p_Document->p_Data + p_Document->Length, p_Data, Length);
+    p_Document->Length += Length;
+}
+
+/** @brief              Appends a string to a request body.
+ *  @param p_Document   Request body
+ *  @param p_Text       Text to append
+ */
+static inline void _CalDAV_Document_Append(CalDAV_Document_t *p_Document, const char *p_Text)
+{
+    _CalDAV_Document_Append_Length(p_Document, p_Text, strlen(p_Text));
+}
+
+/** @brief              Releases a request body.
+ *  @param p_Document   Request body
+ */
+static void _CalDAV_Document_Free(CalDAV_Document_t *p_Document)
+{
+    if (p_Document->IsFixed == false) {
+        CUSTOM_FREE(p_Document->p_Data);
+    }
+
+    memset(p_Document, 0, sizeof(CalDAV_Document_t));
+}
+
+/** @brief              Appends a string to an XML document and escapes the XML special characters.
+ *  @param p_Document   XML document
+ *  @param p_Text       Text to append
+ */
+static void _CalDAV_XML_Append_Escaped(CalDAV_Document_t *p_Document, const char *p_Text)
+{
+    while (*p_Text != '\0') {
+        size_t Length;
+
+        /* Runs without special characters are copied at once */
+        Length = strcspn(p_Text, "&<>");
+        _CalDAV_Document_Append_Length(p_Document, p_Text, Length);
+        p_Text += Length;
+
+        switch (*p_Text) {
+            case '&': {
+                _CalDAV_Document_Append(p_Document, "&amp;");
+
+                break;
+            }
+            case '<': {
+                _CalDAV_Document_Append(p_Document, "&lt;");
+
+                break;
+            }
+            case '>': {
+                _CalDAV_Document_Append(p_Document, "&gt;");
+
+                break;
+            }
+            default: {
+                /* End of the text */
+                continue;
+            }
+        }
+
+        p_Text++;
+    }
+}
+
+/** @brief              Appends an iCalendar content line to a request body (RFC 5545 3.1).
+ *                      Lines are folded before 75 octets, never inside a UTF-8 sequence or an escape.
+ *  @param p_Document   Request body
+ *  @param p_Name       Property name with parameters (e.g. "DTSTART;VALUE=DATE")
+ *  @param p_Value      Value
+ *  @param IsText       Escape backslash, semicolon, comma and line breaks of a TEXT value (RFC 5545 3.3.11)
+ */
+static void _CalDAV_iCal_Append_Line(CalDAV_Document_t *p_Document, const char *p_Name, const char *p_Value,
+                                     bool IsText)
+{
+    size_t Column;
+
+    _CalDAV_Document_Append(p_Document, p_Name);
+    _CalDAV_Document_Append(p_Document, ":");
+    Column = strlen(p_Name) + 1;
+
+    while (*p_Value != '\0') {
+        char Escape[2];
+        const char *p_Unit = p_Value;
+        size_t Length = 1;
+        uint8_t c = (uint8_t)*p_Value;
+
+        if (c == '\r') {
+            p_Value++;
+
+            continue;
+        }
+
+        if (IsText && ((c == '\\') || (c == ';') || (c == ',') || (c == '\n'))) {
+            Escape[0] = '\\';
+            Escape[1] = (c == '\n') ? 'n' : (char)c;
+            p_Unit = Escape;
+            Length = 2;
+        } else if (c >= 0xC0) {
+            /* Lead byte of a UTF-8 sequence, the continuation bytes stay on the same line */
+            while ((((uint8_t)p_Value[Length]) & 0xC0) == 0x80) {
+                Length++;
+            }
+
+            p_Value += Length - 1;
+        }
+
+        if ((Column + Length) > 75) {
+            _CalDAV_Document_Append_Length(p_Document, "\r\n ", 3);
+            Column = 1;
+        }
+
+        _CalDAV_Document_Append_Length(p_Document, p_Unit, Length);
+        Column += Length;
+        p_Value++;
+    }
+
+    _CalDAV_Document_Append_Length(p_Document, "\r\n", 2);
+}
+
+/** @brief              Appends a DATE or DATE-TIME property in UTC to a request body.
+ *  @param p_Document   Request body
+ *  @param p_Name       Property name
+ *  @param Time         Time in seconds since 1970 (UTC)
+ *  @param IsDate       Write a DATE value instead of a DATE-TIME
+ */
+static void _CalDAV_iCal_Append_Time(CalDAV_Document_t *p_Document, const char *p_Name, time_t Time, bool IsDate)
+{
+    char Name[24];
+    char Value[17];
+    struct tm Tm;
+
+    gmtime_r(&Time, &Tm);
+
+    if (IsDate) {
+        snprintf(Name, sizeof(Name), "%s;VALUE=DATE", p_Name);
+        strftime(Value, sizeof(Value), "%Y%m%d", &Tm);
+    } else {
+        snprintf(Name, sizeof(Name), "%s", p_Name);
+        strftime(Value, sizeof(Value), "%Y%m%dT%H%M%SZ", &Tm);
+    }
+
+    _CalDAV_iCal_Append_Line(p_Document, Name, Value, false);
+}
+
+/** @brief              Serializes an event as an iCalendar object into a request body.
+ *                      The binary times are preferred, the ISO 8601 strings are written unchanged without them.
+ *  @param p_Document   Request body
+ *  @param p_Event      Event (UID and a start time are required)
+ */
+static void _CalDAV_iCal_Append_Event(CalDAV_Document_t *p_Document, const CalDAV_Calendar_Event_t *p_Event)
+{
+    _CalDAV_Document_Append(p_Document, "BEGIN:VCALENDAR\r\n"
+                                        "VERSION:2.0\r\n"
+                                        "PRODID:-//ESP32-CalDAV//EN\r\n"
+                                        "BEGIN:VEVENT\r\n");
+    _CalDAV_iCal_Append_Line(p_Document, "UID", p_Event->UID, false);
+    _CalDAV_iCal_Append_Time(p_Document, "DTSTAMP", time(NULL), false);
+
+    if (p_Event->Start != 0) {
+        _CalDAV_iCal_Append_Time(p_Document, "DTSTART", p_Event->Start, p_Event->IsAllDay);
+    } else {
+        _CalDAV_iCal_Append_Line(p_Document, "DTSTART", p_Event->StartTime, false);
+    }
+
+    if ((p_Event->Start != 0) && (p_Event->End > p_Event->Start)) {
+        _CalDAV_iCal_Append_Time(p_Document, "DTEND", p_Event->End, p_Event->IsAllDay);
+    } else if ((p_Event->Start == 0) && (p_Event->EndTime != NULL)) {
+        _CalDAV_iCal_Append_Line(p_Document, "DTEND", p_Event->EndTime, false);
+    }
+
+    if (p_Event->Summary != NULL) {
+        _CalDAV_iCal_Append_Line(p_Document, "SUMMARY", p_Event->Summary, true);
+    }
+
+    if (p_Event->Description != NULL) {
+        _CalDAV_iCal_Append_Line(p_Document, "DESCRIPTION", p_Event->Description, true);
+    }
+
+    if (p_Event->Location != NULL) {
+        _CalDAV_iCal_Append_Line(p_Document, "LOCATION", p_Event->Location, true);
+    }
+
+    _CalDAV_Document_Append(p_Document, "END:VEVENT\r\n"
+                                        "END:VCALENDAR\r\n");
+}
+
+/** @brief              Builds the calendar-data element of the REPORTs of a client.
+ *                      When event properties are selected, only these properties of the VEVENTs are requested, so the
+ *                      server leaves out time zones, alarms, attendees and attachments.
+ *  @param p_Client     CalDAV client handle
+ *  @return             true on success, false if the element does not fit into the client
+ */
+static bool _CalDAV_XML_Calendar_Data(CalDAV_Client_t *p_Client)
+{
+    static const struct {
+        uint32_t Property;
+        const char *p_Name;
+    } Properties[] = {
+        {CALDAV_EVENT_PROPERTY_UID, "UID"},
+        {CALDAV_EVENT_PROPERTY_SUMMARY, "SUMMARY"},
+        {CALDAV_EVENT_PROPERTY_DESCRIPTION, "DESCRIPTION"},
+        {CALDAV_EVENT_PROPERTY_LOCATION, "LOCATION"},
+        {CALDAV_EVENT_PROPERTY_DTSTART, "DTSTART"},
+        {CALDAV_EVENT_PROPERTY_DTEND, "DTEND"},
+        {CALDAV_EVENT_PROPERTY_DTEND, "DURATION"},
+    };
+
+    CalDAV_Document_t Document;
+
+    memset(&Document, 0, sizeof(CalDAV_Document_t));
+    Document.p_Data = p_Client->CalendarData;
+    Document.Size = sizeof(p_Client->CalendarData);
+    Document.IsFixed = true;
+
+    if (p_Client->EventProperties == 0) {
+        _CalDAV_Document_Append(&Document, "    <C:calendar-data/>\n");
+    } else {
+        /* RFC 4791 section 9.6: components that are not listed are left out */
+        _CalDAV_Document_Append(&Document, "    <C:calendar-data>\n"
+                                           "      <C:comp name=\"VCALENDAR\">\n");
+
+        /* Time zone definitions resolve the TZID of the start and end time */
+        if (p_Client->EventProperties & (CALDAV_EVENT_PROPERTY_DTSTART | CALDAV_EVENT_PROPERTY_DTEND)) {
+            _CalDAV_Document_Append(&Document, "        <C:comp name=\"VTIMEZONE\"/>\n");
+        }
+
+        _CalDAV_Document_Append(&Document, "        <C:comp name=\"VEVENT\">\n");
+        for (size_t i = 0; i < (sizeof(Properties) / sizeof(Properties[0])); i++) {
+            if (p_Client->EventProperties & Properties[i].Property) {
+                _CalDAV_Document_Append(&Document, "          <C:prop name=\"");
+                _CalDAV_Document_Append(&Document, Properties[i].p_Name);
+                _CalDAV_Document_Append(&Document, "\"/>\n");
+            }
+        }
+        _CalDAV_Document_Append(&Document, "        </C:comp>\n"
+                                           "      </C:comp>\n"
+                                           "    </C:calendar-data>\n");
+    }
+
+    p_Client->CalendarDataLength = Document.Length;
+
+    return (Document.IsOutOfMemory == false);
+}
+
+/** @brief          Returns the length of the scheme and host part (scheme://host) of a server URL.
+ *  @param p_URL    Server URL
+ *  @return         Length of the base URL, the complete URL without a path
+ */
+static size_t _CalDAV_Base_Length(const char *p_URL)
+{
+    const char *p_SchemeEnd;
+    const char *p_PathStart;
+
+    p_SchemeEnd = strstr(p_URL, "://");
+    if (p_SchemeEnd != NULL) {
+        p_PathStart = strchr(p_SchemeEnd + 3, '/');
+        if (p_PathStart != NULL) {
+            return (size_t)(p_PathStart - p_URL);
+        }
+    }
+
+    return strlen(p_URL);
+}
+
+/** @brief          Builds the URL of a resource on the server of a CalDAV client.
+ *  @param p_Client CalDAV client handle
+ *  @param p_Path   URL, absolute path (starting with /, e.g. from a href) or path relative to the server URL
+ *  @param p_URL    Buffer for the URL
+ *  @param Size     Size of the buffer
+ */
+static void _CalDAV_Build_URL(const CalDAV_Client_t *p_Client, const char *p_Path, char *p_URL, size_t Size)
+{
+    /* Hrefs may also be complete URLs */
+    if (strstr(p_Path, "://") != NULL) {
+        snprintf(p_URL, Size, "%s", p_Path);
+
+        return;
+    }
+
+    /* Build URL - if path is absolute (starts with /), use scheme://host (from CalDAV_Client_Init) + path */
+    if (p_Path[0] == '/') {
+        snprintf(p_URL, Size, "%.*s%s", (int)p_Client->BaseLength, p_Client->ServerURL, p_Path);
+    } else {
+        /* Relative path, append to server URL */
+        snprintf(p_URL, Size, "%s/%s", p_Client->ServerURL, p_Path);
+    }
+}
+
+/** @brief              Evaluates the response of a calendar-query REPORT.
+ *  @param Error        Result of the request
+ *  @param StatusCode   HTTP status code
+ *  @param p_Parser     Parser used for the response
+ *  @return             CALDAV_ERROR_OK on success, error code otherwise
+ */
+static CalDAV_Error_t _CalDAV_Calendar_Query_Check(esp_err_t Error, int StatusCode, const CalDAV_Parser_t *p_Parser)
+{
+    if (Error == ESP_ERR_NO_MEM) {
+        return CALDAV_ERROR_NO_MEM;
+    }
+
+    if (Error != ESP_OK) {
+        ESP_LOGE(TAG, "CalDAV-Query failed: %d (Status: %d)!", Error, StatusCode);
+
+        return CALDAV_ERROR_HTTP;
+    }
+
+    if ((StatusCode != 200) && (StatusCode != 207)) {
+        ESP_LOGE(TAG, "CalDAV-Query unexpected status: %d!", StatusCode);
+
+        return CALDAV_ERROR_HTTP;
+    }
+
+    if ((p_Parser->HasRoot == false) || p_Parser->IsHTML) {
+        ESP_LOGW(TAG, "CalDAV response is not a multistatus document!");
+
+        return CALDAV_ERROR_HTTP;
+    }
+
+    if (p_Parser->IsStopped) {
+        ESP_LOGD(TAG, "Event processing stopped by callback");
+    }
+
+    return CALDAV_ERROR_OK;
+}
+
+/** @brief          Releases the asynchronous request of a client together with its partial result.
+ *  @param p_Client CalDAV client handle
+ */
+static void _CalDAV_Request_Free(CalDAV_Client_t *p_Client)
+{
+    CalDAV_Request_t *p_Request = p_Client->p_Request;
+
+    if (p_Request == NULL) {
+        return;
+    }
+
+    if (p_Request->IsActive) {
+        CalDAV_Arena_Block_t *p_Body;
+
+        _CalDAV_Receiver_End(&p_Request->Receiver, ESP_FAIL, &p_Body);
+        CUSTOM_FREE(p_Body);
+    }
+
+    _CalDAV_Arena_Free(_CalDAV_Arena_Finish(&p_Request->Collector.Arena));
+    _CalDAV_Arena_Free(_CalDAV_Arena_Finish(&p_Request->Arena));
+    CUSTOM_FREE(p_Request->Discovery.Principal);
+    CUSTOM_FREE(p_Request->Discovery.CalendarHome);
+
+    p_Client->p_Request = NULL;
+
+    /* The request of the fixed memory profile is kept until CalDAV_Client_Deinit */
+    if (p_Request != p_Client->p_Reserved) {
+        CUSTOM_FREE(p_Request);
+    }
+}
+
+/** @brief              Creates the asynchronous request of a client.
+ *  @param p_Client     CalDAV client handle
+ *  @param on_Complete  Completion callback (optional)
+ *  @param p_Arg        User argument for the completion callback
+ *  @param pp_Request   Pointer to store the request
+ *  @return             CALDAV_ERROR_OK on success, error code otherwise
+ */
+static CalDAV_Error_t _CalDAV_Request_Create(CalDAV_Client_t *p_Client, CalDAV_Request_Callback_t on_Complete,
+                                             void *p_Arg, CalDAV_Request_t **pp_Request)
+{
+    CalDAV_Request_t *p_Request;
+
+    /* A client has one HTTP client, so it can only run one request at a time */
+    if (p_Client->p_Request != NULL) {
+        ESP_LOGE(TAG, "Another request is in progress!");
+
+        return CALDAV_ERROR_FAIL;
+    }
+
+    if (_CalDAV_HTTP_Get_Handle(p_Client) == NULL) {
+        return CALDAV_ERROR_FAIL;
+    }
+
+    p_Request = p_Client->p_Reserved;
+    if (p_Request == NULL) {
+        p_Request = (CalDAV_Request_t *)CUSTOM_BUFFER_MALLOC(sizeof(CalDAV_Request_t));
+        if (p_Request == NULL) {
+            ESP_LOGE(TAG, "Failed to allocate request!");
+
+            return CALDAV_ERROR_NO_MEM;
+        }
+    }
+
+    memset(p_Request, 0, sizeof(CalDAV_Request_t));
+    p_Request->on_Complete = on_Complete;
+    p_Request->p_Arg = p_Arg;
+
+    p_Client->p_Request = p_Request;
+    *pp_Request = p_Request;
+
+    return CALDAV_ERROR_OK;
+}
+
+/** @brief              Starts the HTTP exchange of the current step of an asynchronous request.
+ *                      The exchange is advanced by CalDAV_Client_Poll.
+ *  @param p_Client     CalDAV client handle
+ *  @param p_Request    Request
+ *  @return             CALDAV_ERROR_OK on success, error code otherwise
+ */
+static CalDAV_Error_t _CalDAV_Request_Send(CalDAV_Client_t *p_Client, CalDAV_Request_t *p_Request)
+{
+    esp_err_t Error;
+    bool IsRetained = false;
+    const char *p_Depth = "1";
+    const char *p_Override = NULL;
+    esp_http_client_method_t Method = HTTP_METHOD_PROPFIND;
+    const char *p_Body = p_Request->Body;
+    size_t BodyLength = p_Request->BodyLength;
+    CalDAV_Parser_On_Response_t on_Response = NULL;
+    CalDAV_Parser_On_Event_t on_Event = NULL;
+    void *p_Arg = NULL;
+
+    switch (p_Request->Step) {
+        case CALDAV_REQUEST_STEP_DISCOVER:
+        case CALDAV_REQUEST_STEP_DISCOVER_PRINCIPAL: {
+            if (p_Request->Step == CALDAV_REQUEST_STEP_DISCOVER) {
+                snprintf(p_Request->URL, sizeof(p_Request->URL), "%s", p_Client->ServerURL);
+            } else {
+                _CalDAV_Build_URL(p_Client, p_Request->Discovery.Principal, p_Request->URL, sizeof(p_Request->URL));
+            }
+
+            ESP_LOGD(TAG, "Discovering calendar home on: %s", p_Request->URL);
+
+            p_Body = _CalDAV_Propfind_Discovery_Body;
+            BodyLength = sizeof(_CalDAV_Propfind_Discovery_Body) - 1;
+            p_Depth = "0";
+            on_Response = on_Discovery_Response;
+            p_Arg = &p_Request->Discovery;
+
+            break;
+        }
+        case CALDAV_REQUEST_STEP_CALENDARS: {
+            _CalDAV_Build_URL(p_Client, p_Client->CalendarHome, p_Request->URL, sizeof(p_Request->URL));
+            _CalDAV_Arena_Init(&p_Request->Collector.Arena, sizeof(CalDAV_Calendar_t), NULL, 0);
+
+#if CONFIG_ESP32_CALDAV_ZERO_COPY
+            /* Strings point into the retained response */
+            p_Request->Collector.Arena.IsView = true;
+            IsRetained = true;
+#endif
+
+            ESP_LOGD(TAG, "Searching calendars on: %s (User: %s)", p_Request->URL, p_Client->Username);
+
+            p_Body = _CalDAV_Propfind_Body;
+            BodyLength = sizeof(_CalDAV_Propfind_Body) - 1;
+            on_Response = on_Calendar_Response;
+            p_Arg = &p_Request->Collector;
+
+            break;
+        }
+        default: {
+            /* URL, body and arena are prepared when the event list is started */
+            ESP_LOGD(TAG, "Fetching events from %s", p_Request->URL);
+
+            Method = HTTP_METHOD_POST;
+            p_Override = "REPORT";
+            IsRetained = p_Request->Arena.IsView;
+            on_Event = on_Calendar_Event;
+            p_Arg = &p_Request->Arena;
+
+            break;
+        }
+    }
+
+    if (BodyLength == 0) {
+        return CALDAV_ERROR_NO_MEM;
+    }
+
+    Error = _CalDAV_Receiver_Begin(p_Client, &p_Request->Receiver, &p_Request->Parser, IsRetained, on_Response,
+                                   on_Event, p_Arg);
+    if (Error != ESP_OK) {
+        return CALDAV_ERROR_NO_MEM;
+    }
+
+#if CONFIG_ESP32_CALDAV_RECURRENCE
+    if (p_Request->Step == CALDAV_REQUEST_STEP_EVENTS) {
+        CalDAV_Parser_Set_Window(&p_Request->Parser, &p_Request->StartTime, &p_Request->EndTime);
+    }
+#endif
+
+    Error = _CalDAV_HTTP_Start(p_Client, p_Request->URL, Method, p_Depth, p_Override, p_Body, BodyLength,
+                               &p_Request->Receiver);
+    if (Error != ESP_OK) {
+        CalDAV_Arena_Block_t *p_Body;
+
+        _CalDAV_Receiver_End(&p_Request->Receiver, Error, &p_Body);
+
+        return CALDAV_ERROR_FAIL;
+    }
+
+    p_Request->IsActive = true;
+
+    return CALDAV_ERROR_OK;
+}
+
+/** @brief              Evaluates a discovery PROPFIND of an asynchronous request (RFC 4791 section 6.2.1, RFC 5397).
+ *                      If only the principal is known, the principal is asked for the calendar-home-set next.
+ *                      Servers without these properties keep the server URL as calendar home.
+ *  @param p_Client     CalDAV client handle
+ *  @param p_Request    Request
+ *  @param Error        Result of the HTTP exchange
+ *  @param StatusCode   HTTP status code
+ *  @return             CALDAV_ERROR_IN_PROGRESS if the request continues with the next step, error code otherwise
+ */
+static CalDAV_Error_t _CalDAV_Request_Discovery_Done(CalDAV_Client_t *p_Client, CalDAV_Request_t *p_Request,
+                                                     esp_err_t Error, int StatusCode)
+{
+    CalDAV_Discovery_t *p_Discovery = &p_Request->Discovery;
+
+    if ((Error == ESP_ERR_NO_MEM) || p_Discovery->IsOutOfMemory) {
+        return CALDAV_ERROR_NO_MEM;
+    }
+
+    if (Error != ESP_OK) {
+        ESP_LOGE(TAG, "Discovery PROPFIND failed: %d!", Error);
+
+        return CALDAV_ERROR_HTTP;
+    }
+
+    if (StatusCode == 401) {
+        ESP_LOGE(TAG, "Authentication failed (Status: 401)!");
+
+        return CALDAV_ERROR_HTTP;
+    }
+
+    if ((StatusCode != 200) && (StatusCode != 207)) {
+        ESP_LOGW(TAG, "Discovery PROPFIND unexpected status: %d", StatusCode);
+    }
+
+    /* Properties that are already known are kept when the principal is asked */
+    if ((p_Request->Step == CALDAV_REQUEST_STEP_DISCOVER) && (p_Discovery->CalendarHome == NULL) &&
+        (p_Discovery->Principal != NULL)) {
+        p_Request->Step = CALDAV_REQUEST_STEP_DISCOVER_PRINCIPAL;
+
+        return CALDAV_ERROR_IN_PROGRESS;
+    }
+
+    if (p_Discovery->CalendarHome == NULL) {
+        ESP_LOGD(TAG, "No calendar home found, using the server URL");
+    }
+
+    if (CalDAV_Client_Set_Calendar_Home(p_Client, (p_Discovery->CalendarHome != NULL) ? p_Discovery->CalendarHome :
+                                                  p_Client->ServerURL) != CALDAV_ERROR_OK) {
+        ESP_LOGE(TAG, "Calendar home is too long!");
+
+        return CALDAV_ERROR_NO_MEM;
+    }
+
+    CUSTOM_FREE(p_Discovery->Principal);
+    CUSTOM_FREE(p_Discovery->CalendarHome);
+    memset(p_Discovery, 0, sizeof(CalDAV_Discovery_t));
+
+    p_Request->Step = CALDAV_REQUEST_STEP_CALENDARS;
+
+    return CALDAV_ERROR_IN_PROGRESS;
+}
+
+/** @brief              Evaluates the calendar PROPFIND of an asynchronous request.
+ *                      A stored calendar home that the server does not know anymore is discovered again once.
+ *  @param p_Client     CalDAV client handle
+ *  @param p_Request    Request
+ *  @param Error        Result of the HTTP exchange
+ *  @param StatusCode   HTTP status code
+ *  @param p_Body       Retained response or NULL
+ *  @return             CALDAV_ERROR_OK on success, CALDAV_ERROR_IN_PROGRESS if the request continues with the
+ *                      discovery, CALDAV_ERROR_NOT_FOUND if the calendar home does not exist, error code otherwise
+ */
+static CalDAV_Error_t _CalDAV_Request_Calendars_Done(CalDAV_Client_t *p_Client, CalDAV_Request_t *p_Request,
+                                                     esp_err_t Error, int StatusCode, CalDAV_Arena_Block_t *p_Body)
+{
+    bool IsOutOfMemory;
+    CalDAV_Calendar_List_t *p_Calendars = p_Request->p_Calendars;
+
+    _CalDAV_Arena_Adopt(&p_Request->Collector.Arena, p_Body);
+
+    IsOutOfMemory = p_Request->Collector.Arena.IsOutOfMemory || (Error == ESP_ERR_NO_MEM);
+    p_Calendars->Length = p_Request->Collector.Arena.Length;
+    p_Calendars->Calendar = (CalDAV_Calendar_t *)_CalDAV_Arena_Finish(&p_Request->Collector.Arena);
+
+    if ((Error != ESP_OK) && (Error != ESP_ERR_NO_MEM)) {
+        ESP_LOGE(TAG, "Calendar PROPFIND failed: %d!", Error);
+        CalDAV_Calendars_Free(p_Calendars);
+
+        return CALDAV_ERROR_HTTP;
+    }
+
+    if (StatusCode == 404) {
+        ESP_LOGW(TAG, "Calendar home %s not found!", p_Request->URL);
+        CalDAV_Calendars_Free(p_Calendars);
+
+        /* A stored calendar home may be outdated, so it is discovered again once */
+        if (p_Request->IsDiscovered == false) {
+            ESP_LOGD(TAG, "Calendar home outdated, discovering it again");
+
+            p_Request->IsDiscovered = true;
+            p_Request->Step = CALDAV_REQUEST_STEP_DISCOVER;
+
+            return CALDAV_ERROR_IN_PROGRESS;
+        }
+
+        return CALDAV_ERROR_NOT_FOUND;
+    }
+
+    if ((StatusCode != 200) && (StatusCode != 207)) {
+        ESP_LOGE(TAG, "Calendar PROPFIND unexpected status: %d!", StatusCode);
+        CalDAV_Calendars_Free(p_Calendars);
+
+        return CALDAV_ERROR_HTTP;
+    }
+
+    /* Check for HTML response (indicates error) */
+    if (p_Request->Parser.IsHTML) {
+        ESP_LOGE(TAG, "Invalid XML!");
+        CalDAV_Calendars_Free(p_Calendars);
+
+        return CALDAV_ERROR_HTTP;
+    }
+
+    if (IsOutOfMemory) {
+        ESP_LOGE(TAG, "Failed to allocate memory for calendars!");
+        CalDAV_Calendars_Free(p_Calendars);
+
+        return CALDAV_ERROR_NO_MEM;
+    }
+
+    ESP_LOGD(TAG, "Calendars found: %u", (unsigned int)p_Calendars->Length);
+
+    return CALDAV_ERROR_OK;
+}
+
+/** @brief              Evaluates the calendar-query REPORT of an asynchronous event list.
+ *  @param p_Request    Request
+ *  @param Error        Result of the HTTP exchange
+ *  @param StatusCode   HTTP status code
+ *  @param p_Body       Retained response or NULL
+ *  @return             CALDAV_ERROR_OK on success, error code otherwise
+ */
+static CalDAV_Error_t _CalDAV_Request_Events_Done(CalDAV_Request_t *p_Request, esp_err_t Error, int StatusCode,
+                                                  CalDAV_Arena_Block_t *p_Body)
+{
+    CalDAV_Error_t Result;
+    size_t Collected;
+
+    Result = _CalDAV_Calendar_Query_Check(Error, StatusCode, &p_Request->Parser);
+    _CalDAV_Arena_Adopt(&p_Request->Arena, p_Body);
+    if ((Result == CALDAV_ERROR_OK) && p_Request->Arena.IsOutOfMemory) {
+        ESP_LOGE(TAG, "Failed to allocate memory for events!");
+
+        Result = CALDAV_ERROR_NO_MEM;
+    }
+
+    Collected = p_Request->Arena.Length;
+    *p_Request->pp_Events = (CalDAV_Calendar_Event_t *)_CalDAV_Arena_Finish(&p_Request->Arena);
+
+    if (Result != CALDAV_ERROR_OK) {
+        CalDAV_Events_Free(*p_Request->pp_Events, Collected);
+        *p_Request->pp_Events = NULL;
+
+        return Result;
+    }
+
+    ESP_LOGD(TAG, "Found: %u events in response", (unsigned int)Collected);
+
+    *p_Request->p_Length = Collected;
+
+    return CALDAV_ERROR_OK;
+}
+
+/** @brief          Releases the buffers of the fixed memory profile.
+ *  @param p_Client CalDAV client handle
+ */
+static void _CalDAV_Client_Buffers_Free(CalDAV_Client_t *p_Client)
+{
+    CUSTOM_FREE(p_Client->p_Buffer);
+    CUSTOM_FREE(p_Client->p_Document);
+    CUSTOM_FREE(p_Client->p_Inflater);
+    CUSTOM_FREE(p_Client->p_Reserved);
+    p_Client->p_Buffer = NULL;
+    p_Client->p_Document = NULL;
+    p_Client->p_Inflater = NULL;
+    p_Client->p_Reserved = NULL;
+}
+
+CalDAV_Error_t CalDAV_Client_Init(const CalDAV_Config_t *p_Config, CalDAV_Client_t *p_Client)
+{
+#if CONFIG_ESP32_CALDAV_FIXED_MEMORY
+    bool IsAllocated;
+#endif
+
+    if ((p_Config == NULL) || (p_Config->ServerURL[0] == '\0') || (p_Config->Username[0] == '\0') ||
+        (p_Config->Password[0] == '\0')) {
+        ESP_LOGE(TAG, "Invalid configuration!");
+
+        return CALDAV_ERROR_INVALID_ARG;
+    }
+
+    memset(p_Client, 0, sizeof(CalDAV_Client_t));
+    snprintf(p_Client->ServerURL, sizeof(p_Client->ServerURL), "%s", p_Config->ServerURL);
+    snprintf(p_Client->Username, sizeof(p_Client->Username), "%s", p_Config->Username);
+    snprintf(p_Client->Password, sizeof(p_Client->Password), "%s", p_Config->Password);
+    p_Client->TimeoutMs = p_Config->TimeoutMs;
+    p_Client->EventProperties = p_Config->EventProperties;
+
+    /* Everything a request needs from the configuration is prepared once, so a request only copies it */
+    p_Client->BaseLength = _CalDAV_Base_Length(p_Client->ServerURL);
+    if ((_CalDAV_HTTP_Authorization(p_Client) == false) || (_CalDAV_XML_Calendar_Data(p_Client) == false)) {
+        ESP_LOGE(TAG, "Invalid configuration!");
+
+        return CALDAV_ERROR_INVALID_ARG;
+    }
+
+#if CONFIG_ESP32_CALDAV_FIXED_MEMORY
+    p_Client->p_Buffer = (char *)CUSTOM_BUFFER_MALLOC(CONFIG_ESP32_CALDAV_BUFFER_LENGTH);
+    p_Client->p_Document = (char *)CUSTOM_BUFFER_MALLOC(CONFIG_ESP32_CALDAV_MAX_REQUEST_LENGTH);
+
+    /* Only one request can be active, the blocking calls use it as well */
+    p_Client->p_Reserved = (CalDAV_Request_t *)CUSTOM_BUFFER_MALLOC(sizeof(CalDAV_Request_t));
+    IsAllocated = (p_Client->p_Buffer != NULL) && (p_Client->p_Document != NULL) && (p_Client->p_Reserved != NULL);
+#if CONFIG_ESP32_CALDAV_COMPRESSION
+    p_Client->p_Inflater = CUSTOM_BUFFER_MALLOC(sizeof(CalDAV_Inflater_t));
+    IsAllocated = IsAllocated && (p_Client->p_Inflater != NULL);
+#endif
+
+    if (IsAllocated == false) {
+        ESP_LOGE(TAG, "Failed to allocate client buffers!");
+        _CalDAV_Client_Buffers_Free(p_Client);
+
+        return CALDAV_ERROR_NO_MEM;
+    }
+#endif
+
+    p_Client->IsInitialized = true;
+
+    ESP_LOGD(TAG, "CalDAV client initialized: %s", p_Config->ServerURL);
+
+    return CALDAV_ERROR_OK;
+}
+
+void CalDAV_Client_Deinit(CalDAV_Client_t *p_Client)
+{
+    if (p_Client == NULL) {
+        return;
+    }
+
+    _CalDAV_Request_Free(p_Client);
+
+    if (p_Client->HTTP_Client != NULL) {
+        esp_http_client_cleanup(p_Client->HTTP_Client);
+        p_Client->HTTP_Client = NULL;
+    }
+
+    _CalDAV_Client_Buffers_Free(p_Client);
+    p_Client->IsInitialized = false;
+}
+
+CalDAV_Error_t CalDAV_Test_Connection(CalDAV_Client_t *p_Client)
+{
+    esp_err_t Error;
+    int StatusCode;
+    CalDAV_Receiver_t Receiver;
+
+    if ((p_Client == NULL) || (p_Client->IsInitialized == false)) {
+        return CALDAV_ERROR_NOT_INITIALIZED;
+    }
+
+    if (_CalDAV_HTTP_Get_Handle(p_Client) == NULL) {
+        return CALDAV_ERROR_FAIL;
+    }
+
+    /* The body is discarded */
+    memset(&Receiver, 0, sizeof(Receiver));
+
+#if CONFIG_ESP32_CALDAV_STATS
+    _CalDAV_Stats_Begin(p_Client, &Receiver);
+#endif
+
+    Error = _CalDAV_HTTP_Perform(p_Client, p_Client->ServerURL, HTTP_METHOD_GET, "0", NULL, NULL, 0,
+                                 &Receiver, &StatusCode);
+
+#if CONFIG_ESP32_CALDAV_STATS
+    _CalDAV_Stats_End(&Receiver, NULL);
+#endif
+
+    if (Error != ESP_OK) {
+        ESP_LOGE(TAG, "HTTP-Request failed: %d!", Error);
+
+        return CALDAV_ERROR_CONNECTION;
+    }
+
+    if ((StatusCode == 200) || (StatusCode == 204) || (StatusCode == 207)) {
+        ESP_LOGD(TAG, "CalDAV connection successful (Status: %d)", StatusCode);
+
+        return CALDAV_ERROR_OK;
+    } else if (StatusCode == 401) {
+        ESP_LOGE(TAG, "Authentication failed (Status: 401)!");
+
+        return CALDAV_ERROR_HTTP;
+    } else {
+        ESP_LOGW(TAG, "Unexpected status code: %d!", StatusCode);
+
+        return CALDAV_ERROR_HTTP;
+    }
+}
+
+CalDAV_Error_t CalDAV_Client_Get_Stats(const CalDAV_Client_t *p_Client, CalDAV_Stats_t *p_Stats)
+{
+    if ((p_Client == NULL) || (p_Stats == NULL)) {
+        return CALDAV_ERROR_INVALID_ARG;
+    }
+
+    if (p_Client->IsInitialized == false) {
+        return CALDAV_ERROR_NOT_INITIALIZED;
+    }
+
+    *p_Stats = p_Client->Stats;
+
+    return CALDAV_ERROR_OK;
+}
+
+CalDAV_Error_t CalDAV_Client_Get_Calendar_Home(const CalDAV_Client_t *p_Client, char *p_Buffer, size_t Size)
+{
+    size_t Length;
+
+    if ((p_Client == NULL) || (p_Buffer == NULL) || (Size == 0)) {
+        return CALDAV_ERROR_INVALID_ARG;
+    }
+
+    if (p_Client->CalendarHome[0] == '\0') {
+        return CALDAV_ERROR_NOT_FOUND;
+    }
+
+    Length = strlen(p_Client->CalendarHome);
+    if (Length >= Size) {
+        return CALDAV_ERROR_NO_MEM;
+    }
+
+    memcpy(p_Buffer, p_Client->CalendarHome, Length + 1);
+
+    return CALDAV_ERROR_OK;
+}
+
+CalDAV_Error_t CalDAV_Client_Set_Calendar_Home(CalDAV_Client_t *p_Client, const char *p_CalendarHome)
+{
+    if ((p_Client == NULL) || (p_Client->IsInitialized == false)) {
+        return CALDAV_ERROR_INVALID_ARG;
+    }
+
+    if (p_CalendarHome == NULL) {
+        p_Client->CalendarHome[0] = '\0';
+    } else {
+        size_t Length;
+
+        Length = strlen(p_CalendarHome);
+        if (Length >= sizeof(p_Client->CalendarHome)) {
+            return CALDAV_ERROR_INVALID_ARG;
+        }
+
+        memcpy(p_Client->CalendarHome, p_CalendarHome, Length + 1);
+    }
+
+    return CALDAV_ERROR_OK;
+}
+
+CalDAV_Error_t CalDAV_Client_Poll(CalDAV_Client_t *p_Client)
+{
+    esp_err_t Error;
+    int StatusCode;
+    CalDAV_Error_t Result;
+    CalDAV_Request_t *p_Request;
+    CalDAV_Request_Callback_t on_Complete;
+    void *p_Arg;
+
+    if ((p_Client == NULL) || (p_Client->IsInitialized == false)) {
+        return CALDAV_ERROR_INVALID_ARG;
+    }
+
+    p_Request = p_Client->p_Request;
+    if (p_Request == NULL) {
+        return CALDAV_ERROR_OK;
+    }
+
+    /* Steps follow each other in the same call until the request has to wait for the network */
+    do {
+        CalDAV_Arena_Block_t *p_Body;
+
+        Error = _CalDAV_HTTP_Continue(p_Client, &p_Request->Receiver, &StatusCode);
+        if (Error == ESP_ERR_HTTP_EAGAIN) {
+            return CALDAV_ERROR_IN_PROGRESS;
+        }
+
+        p_Request->IsActive = false;
+        Error = _CalDAV_Receiver_End(&p_Request->Receiver, Error, &p_Body);
+
+        switch (p_Request->Step) {
+            case CALDAV_REQUEST_STEP_DISCOVER:
+            case CALDAV_REQUEST_STEP_DISCOVER_PRINCIPAL: {
+                Result = _CalDAV_Request_Discovery_Done(p_Client, p_Request, Error, StatusCode);
+
+                break;
+            }
+            case CALDAV_REQUEST_STEP_CALENDARS: {
+                Result = _CalDAV_Request_Calendars_Done(p_Client, p_Request, Error, StatusCode, p_Body);
+
+                break;
+            }
+            default: {
+                Result = _CalDAV_Request_Events_Done(p_Request, Error, StatusCode, p_Body);
+
+                break;
+            }
+        }
+
+        if (Result == CALDAV_ERROR_IN_PROGRESS) {
+            Result = _CalDAV_Request_Send(p_Client, p_Request);
+            if (Result == CALDAV_ERROR_OK) {
+                Result = CALDAV_ERROR_IN_PROGRESS;
+            }
+        }
+    } while (Result == CALDAV_ERROR_IN_PROGRESS);
+
+    on_Complete = p_Request->on_Complete;
+    p_Arg = p_Request->p_Arg;
+
+    _CalDAV_Request_Free(p_Client);
+
+    if (on_Complete != NULL) {
+        on_Complete(Result, p_Arg);
+    }
+
+    return Result;
+}
+
+void CalDAV_Client_Cancel(CalDAV_Client_t *p_Client)
+{
+    if ((p_Client == NULL) || (p_Client->p_Request == NULL)) {
+        return;
+    }
+
+    /* The rest of the aborted response must not be read by the next request */
+    if (p_Client->p_Request->IsActive) {
+        esp_http_client_close(p_Client->HTTP_Client);
+    }
+
+    _CalDAV_Request_Free(p_Client);
+}
+
+/** @brief          Polls the asynchronous request of a client until it has finished.
+ *                  The blocking calls are thin wrappers around their asynchronous variants.
+ *  @param p_Client CalDAV client handle
+ *  @return         Result of the request
+ */
+static CalDAV_Error_t _CalDAV_Request_Wait(CalDAV_Client_t *p_Client)
+{
+    CalDAV_Error_t Error;
+
+    Error = CalDAV_Client_Poll(p_Client);
+    while (Error == CALDAV_ERROR_IN_PROGRESS) {
+        /* Give the network stack time to receive more data */
+        vTaskDelay(1);
+
+        Error = CalDAV_Client_Poll(p_Client);
+    }
+
+    return Error;
+}
+
+CalDAV_Error_t CalDAV_Calendars_List_Async(CalDAV_Client_t *p_Client,
+                                           CalDAV_Calendar_List_t *p_Calendars,
+                                           CalDAV_Request_Callback_t on_Complete,
+                                           void *p_Arg)
+{
+    CalDAV_Error_t Error;
+    CalDAV_Request_t *p_Request;
+
+    if ((p_Client == NULL) || (p_Client->IsInitialized == false) || (p_Calendars == NULL)) {
+        return CALDAV_ERROR_INVALID_ARG;
+    }
+
+    p_Calendars->Length = 0;
+    p_Calendars->Calendar = NULL;
+
+    Error = _CalDAV_Request_Create(p_Client, on_Complete, p_Arg, &p_Request);
+    if (Error != CALDAV_ERROR_OK) {
+        return Error;
+    }
+
+    p_Request->p_Calendars = p_Calendars;
+    p_Request->Step = CALDAV_REQUEST_STEP_CALENDARS;
+
+    if (p_Client->CalendarHome[0] == '\0') {
+        p_Request->Step = CALDAV_REQUEST_STEP_DISCOVER;
+        p_Request->IsDiscovered = true;
+    }
+
+    Error = _CalDAV_Request_Send(p_Client, p_Request);
+    if (Error != CALDAV_ERROR_OK) {
+        _CalDAV_Request_Free(p_Client);
+    }
+
+    return Error;
+}
+
+CalDAV_Error_t CalDAV_Calendars_List(CalDAV_Client_t *p_Client,
+                                     CalDAV_Calendar_List_t *p_Calendars)
+{
+    CalDAV_Error_t Error;
+
+    Error = CalDAV_Calendars_List_Async(p_Client, p_Calendars, NULL, NULL);
+    if (Error != CALDAV_ERROR_OK) {
+        return Error;
+    }
+
+    return _CalDAV_Request_Wait(p_Client);
+}
+
+/** @brief              Requests the sync-token and ctag of a calendar with a Depth: 0 PROPFIND.
+ *  @param p_Client     CalDAV client handle
+ *  @param p_Path       Path of the calendar
+ *  @param p_Check      Change check that receives the result
+ *  @return             CALDAV_ERROR_OK on success, CALDAV_ERROR_NOT_FOUND if the calendar does not exist,
+ *                      error code otherwise
+ */
+static CalDAV_Error_t _CalDAV_Calendar_Check(CalDAV_Client_t *p_Client, const char *p_Path,
+                                             CalDAV_Change_Check_t *p_Check)
+{
+    char URL[512];
+    esp_err_t Error;
+    int StatusCode;
+    CalDAV_Parser_t Parser;
+
+    _CalDAV_Build_URL(p_Client, p_Path, URL, sizeof(URL));
+
+    ESP_LOGD(TAG, "Checking calendar %s for changes", URL);
+
+    if (_CalDAV_HTTP_Get_Handle(p_Client) == NULL) {
+        return CALDAV_ERROR_FAIL;
+    }
+
+    Error = _CalDAV_HTTP_Parse(p_Client, URL, HTTP_METHOD_PROPFIND, "0", NULL, _CalDAV_Propfind_Tags_Body,
+                               sizeof(_CalDAV_Propfind_Tags_Body) - 1, &Parser, on_Change_Response, NULL, p_Check, NULL,
+                               &StatusCode);
+
+    if (Error == ESP_ERR_NO_MEM) {
+        return CALDAV_ERROR_NO_MEM;
+    }
+
+    if (Error != ESP_OK) {
+        ESP_LOGE(TAG, "Calendar PROPFIND failed: %d!", Error);
+
+        return CALDAV_ERROR_HTTP;
+    }
+
+    if (StatusCode == 404) {
+        ESP_LOGW(TAG, "Calendar %s not found!", p_Path);
+
+        return CALDAV_ERROR_NOT_FOUND;
+    }
+
+    if ((StatusCode != 200) && (StatusCode != 207)) {
+        ESP_LOGE(TAG, "Calendar PROPFIND unexpected status: %d!", StatusCode);
+
+        return CALDAV_ERROR_HTTP;
+    }
+
+    if (Parser.IsHTML || (p_Check->HasResponse == false)) {
+        ESP_LOGW(TAG, "CalDAV response is not a multistatus document!");
+
+        return CALDAV_ERROR_HTTP;
+    }
+
+    return CALDAV_ERROR_OK;
+}
+
+CalDAV_Error_t CalDAV_Calendar_Has_Changed(CalDAV_Client_t *p_Client,
+                                           const CalDAV_Calendar_t *p_Calendar,
+                                           bool *p_Changed)
+{
+    CalDAV_Error_t Error;
+    CalDAV_Change_Check_t Check;
+
+    if ((p_Client == NULL) || (p_Client->IsInitialized == false) || (p_Calendar == NULL) ||
+        (p_Calendar->Path == NULL) || (p_Changed == NULL)) {
+        return CALDAV_ERROR_INVALID_ARG;
+    }
+
+    *p_Changed = true;
+
+    memset(&Check, 0, sizeof(Check));
+    Check.p_Calendar = p_Calendar;
+
+    Error = _CalDAV_Calendar_Check(p_Client, p_Calendar->Path, &Check);
+    if (Error != CALDAV_ERROR_OK) {
+        return Error;
+    }
+
+    *p_Changed = Check.IsChanged;
+
+    return CALDAV_ERROR_OK;
+}
+
+CalDAV_Error_t CalDAV_Calendar_Get_Tag(CalDAV_Client_t *p_Client,
+                                       const char *p_CalendarPath,
+                                       char *p_Tag,
+                                       size_t TagSize)
+{
+    CalDAV_Error_t Error;
+    CalDAV_Change_Check_t Check;
+
+    if ((p_Client == NULL) || (p_Client->IsInitialized == false) || (p_CalendarPath == NULL) || (p_Tag == NULL) ||
+        (TagSize == 0)) {
+        return CALDAV_ERROR_INVALID_ARG;
+    }
+
+    p_Tag[0] = '\0';
+
+    memset(&Check, 0, sizeof(Check));
+    Check.p_Tag = p_Tag;
+    Check.TagSize = TagSize;
+
+    Error = _CalDAV_Calendar_Check(p_Client, p_CalendarPath, &Check);
+    if (Error != CALDAV_ERROR_OK) {
+        return Error;
+    }
+
+    if (Check.IsTruncated) {
+        ESP_LOGE(TAG, "Change tag does not fit into the buffer!");
+
+        return CALDAV_ERROR_NO_MEM;
+    }
+
+    return CALDAV_ERROR_OK;
+}
+
+CalDAV_Error_t CalDAV_Calendar_Find_By_Name(const CalDAV_Calendar_List_t *p_Calendars,
+                                            const char *p_Name,
+                                            CalDAV_Calendar_t **pp_Calendar)
+{
+    if ((p_Calendars == NULL) || (p_Name == NULL) || (pp_Calendar == NULL)) {
+        return CALDAV_ERROR_INVALID_ARG;
+    }
+
+    *pp_Calendar = NULL;
 
     /* Search through all calendars */
     for (size_t i = 0; i < p_Calendars->Length; i++) {
         bool Found = false;
 
-        /* Check Name field */
-        if (p_Calendars->Calendar[i].Name != NULL) {
-            if (strcmp(p_Calendars->Calendar[i].Name, p_Name) == 0) {
-                Found = true;
+        /* Check Name field */
+        if (p_Calendars->Calendar[i].Name != NULL) {
+            if (strcmp(p_Calendars->Calendar[i].Name, p_Name) == 0) {
+                Found = true;
+            }
+        }
+
+        /* Check DisplayName field if not found yet */
+        if (!Found && (p_Calendars->Calendar[i].DisplayName != NULL)) {
+            if (strcmp(p_Calendars->Calendar[i].DisplayName, p_Name) == 0) {
+                Found = true;
+            }
+        }
+
+        if (Found) {
+            *pp_Calendar = &p_Calendars->Calendar[i];
+            ESP_LOGD(TAG, "Found calendar: %s (Path: %s)", 
+                     p_Name, 
+                     p_Calendars->Calendar[i].Path ? p_Calendars->Calendar[i].Path : "Unknown");
+
+            return CALDAV_ERROR_OK;
+        }
+    }
+
+    ESP_LOGW(TAG, "Calendar '%s' not found in list of %zu calendars", p_Name, p_Calendars->Length);
+
+    return CALDAV_ERROR_NOT_FOUND;
+}
+
+/** @brief                  Formats the body of a calendar-query REPORT with a time-range filter.
+ *  @param p_Client         CalDAV client handle
+ *  @param p_Body           Buffer for the body
+ *  @param Size             Size of the buffer (CALDAV_QUERY_BODY_LENGTH)
+ *  @param p_StartTime      Time range filter start as UTC time
+ *  @param p_EndTime        Time range filter end as UTC time
+ *  @param WithData         Request the calendar data, otherwise only the ETags are requested
+ *  @return                 Length of the body or 0 if it does not fit into the buffer
+ */
+static size_t _CalDAV_Calendar_Query_Body(const CalDAV_Client_t *p_Client,
+                                          char *p_Body,
+                                          size_t Size,
+                                          const struct tm *p_StartTime,
+                                          const struct tm *p_EndTime,
+                                          bool WithData)
+{
+    int Length;
+    char StartTimeString[20];
+    char EndTimeString[20];
+
+    memset(StartTimeString, 0, sizeof(StartTimeString));
+    memset(EndTimeString, 0, sizeof(EndTimeString));
+
+    /* Format as CalDAV expects: YYYYMMDDTHHMMSSZ */
+    strftime(StartTimeString, sizeof(StartTimeString), "%Y%m%dT%H%M%SZ", p_StartTime);
+    strftime(EndTimeString, sizeof(EndTimeString), "%Y%m%dT%H%M%SZ", p_EndTime);
+
+    ESP_LOGD(TAG, "Fetching events between %s to %s", StartTimeString, EndTimeString);
+
+    /* The static parts and the calendar-data element of the client are only copied */
+    Length = snprintf(p_Body, Size, "%s%.*s%s%s\" end=\"%s%s", _CalDAV_Query_Head,
+                      WithData ? (int)p_Client->CalendarDataLength : 0, p_Client->CalendarData, _CalDAV_Query_Filter,
+                      StartTimeString, EndTimeString, _CalDAV_Query_Tail);
+    if ((Length < 0) || ((size_t)Length >= Size)) {
+        ESP_LOGE(TAG, "calendar-query body does not fit!");
+
+        return 0;
+    }
+
+    return (size_t)Length;
+}
+
+/** @brief                  Sends a calendar-query REPORT and passes every VEVENT of the response to a callback.
+ *                          Recurring events are expanded within the time range of the query.
+ *  @param p_Client         CalDAV client handle
+ *  @param p_CalendarPath   Path to the calendar resource
+ *  @param p_Body           Body from _CalDAV_Calendar_Query_Body
+ *  @param BodyLength       Length of the body
+ *  @param p_StartTime      Time range filter start as UTC time
+ *  @param p_EndTime        Time range filter end as UTC time
+ *  @param on_Response      Parser callback for each response block (optional)
+ *  @param on_Event         Parser callback for each event (optional)
+ *  @param p_Arg            User argument for the callbacks
+ *  @param pp_Body          Pointer to store the retained response for zero-copy results or NULL to stream it
+ *  @return                 CALDAV_ERROR_OK on success, error code otherwise
+ */
+static CalDAV_Error_t _CalDAV_Calendar_Query_Send(CalDAV_Client_t *p_Client,
+                                                  const char *p_CalendarPath,
+                                                  const char *p_Body,
+                                                  size_t BodyLength,
+                                                  const struct tm *p_StartTime,
+                                                  const struct tm *p_EndTime,
+                                                  CalDAV_Parser_On_Response_t on_Response,
+                                                  CalDAV_Parser_On_Event_t on_Event,
+                                                  void *p_Arg,
+                                                  CalDAV_Arena_Block_t **pp_Body)
+{
+    char URL[512];
+    esp_err_t Error;
+    int StatusCode = 0;
+    CalDAV_Parser_t Parser;
+    CalDAV_Receiver_t Receiver;
+    CalDAV_Arena_Block_t *p_Retained = NULL;
+
+    memset(URL, 0, sizeof(URL));
+
+    _CalDAV_Build_URL(p_Client, p_CalendarPath, URL, sizeof(URL));
+
+    ESP_LOGD(TAG, "Fetching events from %s", URL);
+
+    if (_CalDAV_HTTP_Get_Handle(p_Client) == NULL) {
+        return CALDAV_ERROR_FAIL;
+    }
+
+    if (BodyLength == 0) {
+        return CALDAV_ERROR_NO_MEM;
+    }
+
+    Error = _CalDAV_Receiver_Begin(p_Client, &Receiver, &Parser, (pp_Body != NULL), on_Response, on_Event, p_Arg);
+    if (Error != ESP_OK) {
+        return CALDAV_ERROR_NO_MEM;
+    }
+
+#if CONFIG_ESP32_CALDAV_RECURRENCE
+    CalDAV_Parser_Set_Window(&Parser, p_StartTime, p_EndTime);
+#else
+    (void)p_StartTime;
+    (void)p_EndTime;
+#endif
+
+    Error = _CalDAV_HTTP_Perform(p_Client, URL, HTTP_METHOD_POST, "1", "REPORT", p_Body, BodyLength,
+                                 &Receiver, &StatusCode);
+    Error = _CalDAV_Receiver_End(&Receiver, Error, &p_Retained);
+
+    if (pp_Body != NULL) {
+        *pp_Body = p_Retained;
+    }
+
+    return _CalDAV_Calendar_Query_Check(Error, StatusCode, &Parser);
+}
+
+/** @brief                  Runs a calendar-query REPORT with a time-range filter and passes every VEVENT of
+ *                          the response to a callback while the response is received.
+ *  @param p_Client         CalDAV client handle
+ *  @param p_CalendarPath   Path to the calendar resource
+ *  @param p_StartTime      Time range filter start as UTC time
+ *  @param p_EndTime        Time range filter end as UTC time
+ *  @param WithData         Request the calendar data, otherwise only the ETags are requested
+ *  @param on_Response      Parser callback for each response block (optional)
+ *  @param on_Event         Parser callback for each event (optional)
+ *  @param p_Arg            User argument for the callbacks
+ *  @param pp_Body          Pointer to store the retained response for zero-copy results or NULL to stream it
+ *  @return                 CALDAV_ERROR_OK on success, error code otherwise
+ */
+static CalDAV_Error_t _CalDAV_Calendar_Query(CalDAV_Client_t *p_Client,
+                                             const char *p_CalendarPath,
+                                             const struct tm *p_StartTime,
+                                             const struct tm *p_EndTime,
+                                             bool WithData,
+                                             CalDAV_Parser_On_Response_t on_Response,
+                                             CalDAV_Parser_On_Event_t on_Event,
+                                             void *p_Arg,
+                                             CalDAV_Arena_Block_t **pp_Body)
+{
+    size_t BodyLength;
+    char RequestBody[CALDAV_QUERY_BODY_LENGTH];
+
+    BodyLength = _CalDAV_Calendar_Query_Body(p_Client, RequestBody, sizeof(RequestBody), p_StartTime, p_EndTime,
+                                             WithData);
+
+    return _CalDAV_Calendar_Query_Send(p_Client, p_CalendarPath, RequestBody, BodyLength, p_StartTime, p_EndTime,
+                                       on_Response, on_Event, p_Arg, pp_Body);
+}
+
+/** @brief                  Starts an asynchronous calendar-query REPORT that collects the events of a calendar
+ *                          into an arena.
+ *  @param p_Client         CalDAV client handle
+ *  @param p_Buffer         Caller-supplied buffer for the result or NULL to allocate from the heap
+ *  @param Size             Size of the caller-supplied buffer
+ *  @param p_Events         Pointer to event array pointer
+ *  @param Length           Pointer to store the number of events found
+ *  @param p_CalendarPath   Path to the calendar resource
+ *  @param p_StartTime      Time range filter start as UTC time
+ *  @param p_EndTime        Time range filter end as UTC time
+ *  @param on_Complete      Completion callback (optional)
+ *  @param p_Arg            User argument for the completion callback
+ *  @return                 CALDAV_ERROR_OK if the request has been started, error code otherwise
+ */
+static CalDAV_Error_t _CalDAV_Calendar_Events_Start(CalDAV_Client_t *p_Client,
+                                                   void *p_Buffer,
+                                                   size_t Size,
+                                                   CalDAV_Calendar_Event_t **p_Events,
+                                                   size_t *Length,
+                                                   const char *p_CalendarPath,
+                                                   const struct tm *p_StartTime,
+                                                   const struct tm *p_EndTime,
+                                                   CalDAV_Request_Callback_t on_Complete,
+                                                   void *p_Arg)
+{
+    CalDAV_Error_t Error;
+    CalDAV_Request_t *p_Request;
+
+    if ((p_Client == NULL) || (p_Client->IsInitialized == false) || (p_Events == NULL) || (Length == NULL) ||
+        (p_CalendarPath == NULL)) {
+        return CALDAV_ERROR_INVALID_ARG;
+    }
+
+    *Length = 0;
+    *p_Events = NULL;
+
+    Error = _CalDAV_Request_Create(p_Client, on_Complete, p_Arg, &p_Request);
+    if (Error != CALDAV_ERROR_OK) {
+        return Error;
+    }
+
+    p_Request->Step = CALDAV_REQUEST_STEP_EVENTS;
+    p_Request->pp_Events = p_Events;
+    p_Request->p_Length = Length;
+
+    _CalDAV_Arena_Init(&p_Request->Arena, sizeof(CalDAV_Calendar_Event_t), p_Buffer, Size);
+
+#if CONFIG_ESP32_CALDAV_ZERO_COPY
+    /* Results in a caller-supplied buffer are always copied */
+    if (p_Buffer == NULL) {
+        p_Request->Arena.IsView = true;
+    }
+#endif
+
+    _CalDAV_Build_URL(p_Client, p_CalendarPath, p_Request->URL, sizeof(p_Request->URL));
+    p_Request->BodyLength = _CalDAV_Calendar_Query_Body(p_Client, p_Request->Body, sizeof(p_Request->Body),
+                                                        p_StartTime, p_EndTime, true);
+    p_Request->StartTime = *p_StartTime;
+    p_Request->EndTime = *p_EndTime;
+
+    Error = _CalDAV_Request_Send(p_Client, p_Request);
+    if (Error != CALDAV_ERROR_OK) {
+        _CalDAV_Request_Free(p_Client);
+    }
+
+    return Error;
+}
+
+/** @brief                  Collects the events of a calendar-query REPORT into an arena and waits for the result.
+ *  @param p_Client         CalDAV client handle
+ *  @param p_Buffer         Caller-supplied buffer for the result or NULL to allocate from the heap
+ *  @param Size             Size of the caller-supplied buffer
+ *  @param p_Events         Pointer to event array pointer
+ *  @param Length           Pointer to store the number of events found
+ *  @param p_CalendarPath   Path to the calendar resource
+ *  @param p_StartTime      Time range filter start as UTC time
+ *  @param p_EndTime        Time range filter end as UTC time
+ *  @return                 CALDAV_ERROR_OK on success, error code otherwise
+ */
+static CalDAV_Error_t _CalDAV_Calendar_Events_Collect(CalDAV_Client_t *p_Client,
+                                                     void *p_Buffer,
+                                                     size_t Size,
+                                                     CalDAV_Calendar_Event_t **p_Events,
+                                                     size_t *Length,
+                                                     const char *p_CalendarPath,
+                                                     const struct tm *p_StartTime,
+                                                     const struct tm *p_EndTime)
+{
+    CalDAV_Error_t Error;
+
+    Error = _CalDAV_Calendar_Events_Start(p_Client, p_Buffer, Size, p_Events, Length, p_CalendarPath, p_StartTime,
+                                          p_EndTime, NULL, NULL);
+    if (Error != CALDAV_ERROR_OK) {
+        return Error;
+    }
+
+    return _CalDAV_Request_Wait(p_Client);
+}
+
+CalDAV_Error_t CalDAV_Calendar_Events_List(CalDAV_Client_t *p_Client,
+                                           CalDAV_Calendar_Event_t **p_Events,
+                                           size_t *Length,
+                                           const char *p_CalendarPath,
+                                           const struct tm* p_StartTime,
+                                           const struct tm* p_EndTime)
+{
+    return _CalDAV_Calendar_Events_Collect(p_Client, NULL, 0, p_Events, Length, p_CalendarPath, p_StartTime,
+                                           p_EndTime);
+}
+
+CalDAV_Error_t CalDAV_Calendar_Events_List_Async(CalDAV_Client_t *p_Client,
+                                                 CalDAV_Calendar_Event_t **p_Events,
+                                                 size_t *p_Length,
+                                                 const char *p_CalendarPath,
+                                                 const struct tm *p_StartTime,
+                                                 const struct tm *p_EndTime,
+                                                 CalDAV_Request_Callback_t on_Complete,
+                                                 void *p_Arg)
+{
+    return _CalDAV_Calendar_Events_Start(p_Client, NULL, 0, p_Events, p_Length, p_CalendarPath, p_StartTime,
+                                         p_EndTime, on_Complete, p_Arg);
+}
+
+CalDAV_Error_t CalDAV_Calendar_Events_List_Static(CalDAV_Client_t *p_Client,
+                                                  void *p_Buffer,
+                                                  size_t Size,
+                                                  CalDAV_Calendar_Event_t **p_Events,
+                                                  size_t *p_Length,
+                                                  const char *p_CalendarPath,
+                                                  const struct tm *p_StartTime,
+                                                  const struct tm *p_EndTime)
+{
+    if (p_Buffer == NULL) {
+        return CALDAV_ERROR_INVALID_ARG;
+    }
+
+    return _CalDAV_Calendar_Events_Collect(p_Client, p_Buffer, Size, p_Events, p_Length, p_CalendarPath,
+                                           p_StartTime, p_EndTime);
+}
+
+/** @brief      Compares two events by start time for qsort.
+ *              Events without start time come last.
+ *  @param p_A  First sort entry
+ *  @param p_B  Second sort entry
+ *  @return     Negative, zero or positive like strcmp
+ */
+static int _CalDAV_Sort_Compare(const void *p_A, const void *p_B)
+{
+    const CalDAV_Sort_Entry_t *p_EntryA = (const CalDAV_Sort_Entry_t *)p_A;
+    const CalDAV_Sort_Entry_t *p_EntryB = (const CalDAV_Sort_Entry_t *)p_B;
+    const CalDAV_Calendar_Event_t *p_EventA = &p_EntryA->Event;
+    const CalDAV_Calendar_Event_t *p_EventB = &p_EntryB->Event;
+    int Result = 0;
+
+    if ((p_EventA->StartTime != NULL) && (p_EventB->StartTime != NULL)) {
+        if (p_EventA->Start != p_EventB->Start) {
+            Result = (p_EventA->Start < p_EventB->Start) ? -1 : 1;
+        }
+    } else if (p_EventA->StartTime != p_EventB->StartTime) {
+        Result = (p_EventA->StartTime == NULL) ? 1 : -1;
+    }
+
+    /* The position keeps the sort stable, an entry compared with itself is equal */
+    if ((Result == 0) && (p_EntryA->Position != p_EntryB->Position)) {
+        Result = (p_EntryA->Position < p_EntryB->Position) ? -1 : 1;
+    }
+
+    return Result;
+}
+
+/** @brief              Sorts the events of an event list by start time.
+ *  @param p_List       Event list
+ *  @return             true on success, false if out of memory
+ */
+static bool _CalDAV_Event_List_Sort(CalDAV_Event_List_t *p_List)
+{
+    CalDAV_Sort_Entry_t *p_Entries;
+
+    p_Entries = (CalDAV_Sort_Entry_t *)CUSTOM_MALLOC(p_List->Length * sizeof(CalDAV_Sort_Entry_t));
+    if (p_Entries == NULL) {
+        return false;
+    }
+
+    for (size_t i = 0; i < p_List->Length; i++) {
+        p_Entries[i].Event = p_List->Events[i];
+        p_Entries[i].Calendar = p_List->Calendar[i];
+        p_Entries[i].Position = i;
+    }
+
+    qsort(p_Entries, p_List->Length, sizeof(CalDAV_Sort_Entry_t), _CalDAV_Sort_Compare);
+
+    for (size_t i = 0; i < p_List->Length; i++) {
+        p_List->Events[i] = p_Entries[i].Event;
+        p_List->Calendar[i] = p_Entries[i].Calendar;
+    }
+
+    CUSTOM_FREE(p_Entries);
+
+    return true;
+}
+
+CalDAV_Error_t CalDAV_Calendars_Events_List_Multi(CalDAV_Client_t *p_Client,
+                                                  const char *const *pp_CalendarPaths,
+                                                  size_t Count,
+                                                  const struct tm *p_StartTime,
+                                                  const struct tm *p_EndTime,
+                                                  bool Sort,
+                                                  CalDAV_Event_List_t *p_List,
+                                                  CalDAV_Error_t *p_Errors)
+{
+    CalDAV_Error_t Error = CALDAV_ERROR_OK;
+    CalDAV_Arena_t Arena;
+    size_t *p_Ends;
+    size_t Calendar;
+    size_t BodyLength;
+    char RequestBody[CALDAV_QUERY_BODY_LENGTH];
+    CalDAV_Arena_Block_t *p_Body = NULL;
+    CalDAV_Arena_Block_t **pp_Body = NULL;
+
+    if ((p_Client == NULL) || (p_Client->IsInitialized == false) || (pp_CalendarPaths == NULL) || (Count == 0) ||
+        (p_List == NULL)) {
+        return CALDAV_ERROR_INVALID_ARG;
+    }
+
+    memset(p_List, 0, sizeof(CalDAV_Event_List_t));
+
+    /* End of the events of each calendar in the event array */
+    p_Ends = (size_t *)CUSTOM_MALLOC(Count * sizeof(size_t));
+    if (p_Ends == NULL) {
+        return CALDAV_ERROR_NO_MEM;
+    }
+
+    _CalDAV_Arena_Init(&Arena, sizeof(CalDAV_Calendar_Event_t), NULL, 0);
+
+#if CONFIG_ESP32_CALDAV_ZERO_COPY
+    Arena.IsView = true;
+    pp_Body = &p_Body;
+#endif
+
+    BodyLength = _CalDAV_Calendar_Query_Body(p_Client, RequestBody, sizeof(RequestBody), p_StartTime, p_EndTime,
+                                             true);
+
+    for (size_t i = 0; i < Count; i++) {
+        CalDAV_Error_t Result;
+        size_t Start = Arena.Length;
+
+        Result = _CalDAV_Calendar_Query_Send(p_Client, pp_CalendarPaths[i], RequestBody, BodyLength, p_StartTime,
+                                             p_EndTime, NULL, on_Calendar_Event, &Arena, pp_Body);
+        _CalDAV_Arena_Adopt(&Arena, p_Body);
+        p_Body = NULL;
+
+        if ((Result == CALDAV_ERROR_OK) && Arena.IsOutOfMemory) {
+            ESP_LOGE(TAG, "Failed to allocate memory for events!");
+
+            Result = CALDAV_ERROR_NO_MEM;
+        }
+
+        if (Result != CALDAV_ERROR_OK) {
+            /* The events of a failed calendar are dropped, their memory is released with the arena */
+            Arena.Length = Start;
+
+            if ((p_Errors == NULL) || (Result == CALDAV_ERROR_NO_MEM)) {
+                Error = Result;
+
+                break;
+            }
+        }
+
+        if (p_Errors != NULL) {
+            p_Errors[i] = Result;
+        }
+
+        p_Ends[i] = Arena.Length;
+    }
+
+    p_List->Length = Arena.Length;
+    p_List->Events = (CalDAV_Calendar_Event_t *)_CalDAV_Arena_Finish(&Arena);
+
+    if ((Error == CALDAV_ERROR_OK) && (p_List->Length > 0)) {
+        p_List->Calendar = (size_t *)CUSTOM_MALLOC(p_List->Length * sizeof(size_t));
+        if (p_List->Calendar == NULL) {
+            Error = CALDAV_ERROR_NO_MEM;
+        } else {
+            Calendar = 0;
+            for (size_t i = 0; i < p_List->Length; i++) {
+                while (i >= p_Ends[Calendar]) {
+                    Calendar++;
+                }
+
+                p_List->Calendar[i] = Calendar;
+            }
+
+            if (Sort && (_CalDAV_Event_List_Sort(p_List) == false)) {
+                Error = CALDAV_ERROR_NO_MEM;
+            }
+        }
+    }
+
+    CUSTOM_FREE(p_Ends);
+
+    if (Error != CALDAV_ERROR_OK) {
+        CalDAV_Event_List_Free(p_List);
+
+        return Error;
+    }
+
+    ESP_LOGD(TAG, "Found: %u events in %u calendars", (unsigned int)p_List->Length, (unsigned int)Count);
+
+    return CALDAV_ERROR_OK;
+}
+
+/** @brief                  Sends a free-busy-query REPORT and merges the busy periods of the response.
+ *  @param p_Client         CalDAV client handle
+ *  @param p_CalendarPath   Path to the calendar resource
+ *  @param p_Body           free-busy-query body
+ *  @param BodyLength       Length of the body
+ *  @param p_FreeBusy       Merged busy periods
+ *  @return                 CALDAV_ERROR_OK on success, CALDAV_ERROR_NOT_FOUND if the calendar does not exist,
+ *                          error code otherwise
+ */
+static CalDAV_Error_t _CalDAV_Free_Busy_Query(CalDAV_Client_t *p_Client,
+                                             const char *p_CalendarPath,
+                                             const char *p_Body,
+                                             size_t BodyLength,
+                                             CalDAV_Free_Busy_t *p_FreeBusy)
+{
+    char URL[512];
+    esp_err_t Error;
+    int StatusCode = 0;
+    CalDAV_Parser_t Parser;
+    CalDAV_Receiver_t Receiver;
+    CalDAV_Arena_Block_t *p_Retained;
+
+    _CalDAV_Build_URL(p_Client, p_CalendarPath, URL, sizeof(URL));
+
+    ESP_LOGD(TAG, "Fetching free busy time from %s", URL);
+
+    if (_CalDAV_HTTP_Get_Handle(p_Client) == NULL) {
+        return CALDAV_ERROR_FAIL;
+    }
+
+    Error = _CalDAV_Receiver_Begin(p_Client, &Receiver, &Parser, false, NULL, NULL, p_FreeBusy);
+    if (Error != ESP_OK) {
+        return CALDAV_ERROR_NO_MEM;
+    }
+
+    /* The response is a single VFREEBUSY as text/calendar and not a multistatus document */
+    CalDAV_Parser_Set_Free_Busy(&Parser, on_Free_Busy_Period);
+    CalDAV_Parser_iCalendar_Begin(&Parser);
+
+    Error = _CalDAV_HTTP_Perform(p_Client, URL, HTTP_METHOD_POST, "1", "REPORT", p_Body, BodyLength, &Receiver,
+                                 &StatusCode);
+    if ((Error == ESP_OK) && (StatusCode == 200)) {
+        CalDAV_Parser_iCalendar_End(&Parser);
+    }
+    Error = _CalDAV_Receiver_End(&Receiver, Error, &p_Retained);
+
+    if (Error == ESP_ERR_NO_MEM) {
+        return CALDAV_ERROR_NO_MEM;
+    }
+
+    if (Error != ESP_OK) {
+        ESP_LOGE(TAG, "free-busy-query failed: %d!", Error);
+
+        return CALDAV_ERROR_HTTP;
+    }
+
+    if (StatusCode == 404) {
+        return CALDAV_ERROR_NOT_FOUND;
+    }
+
+    if (StatusCode != 200) {
+        ESP_LOGE(TAG, "free-busy-query unexpected status: %d!", StatusCode);
+
+        return CALDAV_ERROR_HTTP;
+    }
+
+    return CALDAV_ERROR_OK;
+}
+
+CalDAV_Error_t CalDAV_Calendars_Free_Busy(CalDAV_Client_t *p_Client,
+                                          const char *const *pp_CalendarPaths,
+                                          size_t Count,
+                                          const struct tm *p_StartTime,
+                                          const struct tm *p_EndTime,
+                                          CalDAV_Busy_Period_t *p_Periods,
+                                          size_t Max,
+                                          size_t *p_Length,
+                                          CalDAV_Error_t *p_Errors)
+{
+    int Length;
+    char StartTimeString[20];
+    char EndTimeString[20];
+    char RequestBody[256];
+    CalDAV_Free_Busy_t FreeBusy;
+    CalDAV_Free_Busy_t Saved;
+    CalDAV_Error_t Error = CALDAV_ERROR_OK;
+    CalDAV_Busy_Period_t *p_Backup = NULL;
+
+    if ((p_Client == NULL) || (p_Client->IsInitialized == false) || (pp_CalendarPaths == NULL) || (Count == 0) ||
+        (p_StartTime == NULL) || (p_EndTime == NULL) || (p_Periods == NULL) || (Max == 0) || (p_Length == NULL)) {
+        return CALDAV_ERROR_INVALID_ARG;
+    }
+
+    *p_Length = 0;
+
+    memset(StartTimeString, 0, sizeof(StartTimeString));
+    memset(EndTimeString, 0, sizeof(EndTimeString));
+
+    strftime(StartTimeString, sizeof(StartTimeString), "%Y%m%dT%H%M%SZ", p_StartTime);
+    strftime(EndTimeString, sizeof(EndTimeString), "%Y%m%dT%H%M%SZ", p_EndTime);
+
+    /* The body is the same for all calendars */
+    Length = snprintf(RequestBody, sizeof(RequestBody), "%s%s\" end=\"%s%s", _CalDAV_Free_Busy_Head,
+                      StartTimeString, EndTimeString, _CalDAV_Free_Busy_Tail);
+    if ((Length < 0) || ((size_t)Length >= sizeof(RequestBody))) {
+        return CALDAV_ERROR_NO_MEM;
+    }
+
+    /* The periods are merged while a response is received. A failed calendar that is skipped may have added some
+       of them, so the merged periods of the previous calendars are restored from a copy */
+    if ((p_Errors != NULL) && (Count > 1)) {
+        p_Backup = (CalDAV_Busy_Period_t *)CUSTOM_MALLOC(Max * sizeof(CalDAV_Busy_Period_t));
+        if (p_Backup == NULL) {
+            ESP_LOGE(TAG, "Failed to allocate busy period copy!");
+
+            return CALDAV_ERROR_NO_MEM;
+        }
+    }
+
+    memset(&FreeBusy, 0, sizeof(FreeBusy));
+    FreeBusy.p_Periods = p_Periods;
+    FreeBusy.Max = Max;
+
+    for (size_t i = 0; i < Count; i++) {
+        CalDAV_Error_t Result;
+
+        Saved = FreeBusy;
+        if (p_Backup != NULL) {
+            memcpy(p_Backup, p_Periods, FreeBusy.Length * sizeof(CalDAV_Busy_Period_t));
+        }
+
+        Result = _CalDAV_Free_Busy_Query(p_Client, pp_CalendarPaths[i], RequestBody, (size_t)Length, &FreeBusy);
+
+        if (p_Errors != NULL) {
+            p_Errors[i] = Result;
+        }
+
+        if (Result != CALDAV_ERROR_OK) {
+            if ((p_Errors == NULL) || (Result == CALDAV_ERROR_NO_MEM)) {
+                CUSTOM_FREE(p_Backup);
+
+                return Result;
+            }
+
+            FreeBusy = Saved;
+            if (p_Backup != NULL) {
+                memcpy(p_Periods, p_Backup, FreeBusy.Length * sizeof(CalDAV_Busy_Period_t));
+            }
+        }
+    }
+
+    CUSTOM_FREE(p_Backup);
+
+    *p_Length = FreeBusy.Length;
+
+    if (FreeBusy.IsTruncated) {
+        ESP_LOGW(TAG, "Too many busy periods, periods after %lld dropped!", (long long)FreeBusy.Limit);
+
+        Error = CALDAV_ERROR_NO_MEM;
+    }
+
+    ESP_LOGD(TAG, "Found: %u busy periods in %u calendars", (unsigned int)FreeBusy.Length, (unsigned int)Count);
+
+    return Error;
+}
+
+CalDAV_Error_t CalDAV_Calendar_Events_Foreach(CalDAV_Client_t *p_Client,
+                                              const char *p_CalendarPath,
+                                              const struct tm *p_StartTime,
+                                              const struct tm *p_EndTime,
+                                              CalDAV_Event_Callback_t Callback,
+                                              void *p_Arg)
+{
+    if ((p_Client == NULL) || (p_Client->IsInitialized == false) || (p_CalendarPath == NULL) ||
+        (Callback == NULL)) {
+        return CALDAV_ERROR_INVALID_ARG;
+    }
+
+    return _CalDAV_Calendar_Query(p_Client, p_CalendarPath, p_StartTime, p_EndTime, true, NULL, Callback, p_Arg,
+                                  NULL);
+}
+
+CalDAV_Error_t CalDAV_Calendar_Event_Get(CalDAV_Client_t *p_Client,
+                                         const char *p_Href,
+                                         char *p_ETag,
+                                         size_t ETagSize,
+                                         CalDAV_Event_Callback_t Callback,
+                                         void *p_Arg)
+{
+    char URL[512];
+    esp_err_t Error;
+    int StatusCode;
+    char *p_NewETag = NULL;
+    CalDAV_Parser_t Parser;
+    CalDAV_Receiver_t Receiver;
+    CalDAV_Arena_Block_t *p_Body;
+
+    if ((p_Client == NULL) || (p_Client->IsInitialized == false) || (p_Href == NULL) || (Callback == NULL) ||
+        ((p_ETag != NULL) && (ETagSize == 0))) {
+        return CALDAV_ERROR_INVALID_ARG;
+    }
+
+    _CalDAV_Build_URL(p_Client, p_Href, URL, sizeof(URL));
+
+    ESP_LOGD(TAG, "Fetching %s (If-None-Match: %s)", URL, ((p_ETag != NULL) && (p_ETag[0] != '\0')) ? p_ETag : "-");
+
+    /* The stored ETag must stay intact unless a new version is received */
+    if (p_ETag != NULL) {
+        p_NewETag = (char *)CUSTOM_MALLOC(ETagSize);
+        if (p_NewETag == NULL) {
+            return CALDAV_ERROR_NO_MEM;
+        }
+
+        p_NewETag[0] = '\0';
+    }
+
+    Error = _CalDAV_Receiver_Begin(p_Client, &Receiver, &Parser, false, NULL, Callback, p_Arg);
+    if (Error != ESP_OK) {
+        CUSTOM_FREE(p_NewETag);
+
+        return CALDAV_ERROR_NO_MEM;
+    }
+
+    Receiver.p_IfNoneMatch = ((p_ETag != NULL) && (p_ETag[0] != '\0')) ? p_ETag : NULL;
+    Receiver.p_ETag = p_NewETag;
+    Receiver.ETagSize = ETagSize;
+
+    /* The body of the resource is text/calendar and not a multistatus document */
+    CalDAV_Parser_iCalendar_Begin(&Parser);
+
+    Error = _CalDAV_HTTP_Perform(p_Client, URL, HTTP_METHOD_GET, NULL, NULL, NULL, 0, &Receiver, &StatusCode);
+    if ((Error == ESP_OK) && (StatusCode == 200)) {
+        CalDAV_Parser_iCalendar_End(&Parser);
+    }
+    Error = _CalDAV_Receiver_End(&Receiver, Error, &p_Body);
+
+    if (Error == ESP_ERR_NO_MEM) {
+        CUSTOM_FREE(p_NewETag);
+
+        return CALDAV_ERROR_NO_MEM;
+    }
+
+    if (Error != ESP_OK) {
+        ESP_LOGE(TAG, "GET failed: %d!", Error);
+        CUSTOM_FREE(p_NewETag);
+
+        return CALDAV_ERROR_HTTP;
+    }
+
+    /* Some servers answer a failed If-None-Match with 412 instead of 304 */
+    if ((StatusCode == 304) || (StatusCode == 412)) {
+        ESP_LOGD(TAG, "Resource not modified");
+        CUSTOM_FREE(p_NewETag);
+
+        return CALDAV_ERROR_NOT_MODIFIED;
+    }
+
+    if (StatusCode == 404) {
+        CUSTOM_FREE(p_NewETag);
+
+        return CALDAV_ERROR_NOT_FOUND;
+    }
+
+    if (StatusCode != 200) {
+        ESP_LOGE(TAG, "GET unexpected status: %d!", StatusCode);
+        CUSTOM_FREE(p_NewETag);
+
+        return CALDAV_ERROR_HTTP;
+    }
+
+    if (p_ETag != NULL) {
+        memcpy(p_ETag, p_NewETag, ETagSize);
+        CUSTOM_FREE(p_NewETag);
+    }
+
+    return CALDAV_ERROR_OK;
+}
+
+/** @brief              Stores an event with a PUT or deletes a resource with a DELETE.
+ *                      The request body is written to the given document, so a batch reuses its buffer.
+ *  @param p_Client     CalDAV client handle
+ *  @param p_Document   Request body (prepared with _CalDAV_Document_Init)
+ *  @param p_Href       Path of the resource
+ *  @param p_Event      Event to store or NULL to delete the resource
+ *  @param p_Match      Known ETag of the resource or NULL / empty string for a new resource
+ *  @param p_ETag       Buffer for the new ETag, empty after a DELETE (optional, may be p_Match)
+ *  @param ETagSize     Size of the ETag buffer
+ *  @return             CALDAV_ERROR_OK on success, CALDAV_ERROR_PRECONDITION if the ETag does not match,
+ *                      CALDAV_ERROR_NOT_FOUND if the resource does not exist, error code otherwise
+ */
+static CalDAV_Error_t _CalDAV_Event_Write(CalDAV_Client_t *p_Client, CalDAV_Document_t *p_Document,
+                                         const char *p_Href, const CalDAV_Calendar_Event_t *p_Event,
+                                         const char *p_Match, char *p_ETag, size_t ETagSize)
+{
+    char URL[512];
+    char ETag[CALDAV_ETAG_LENGTH];
+    esp_err_t Error;
+    int StatusCode;
+    bool HasETag;
+    CalDAV_Receiver_t Receiver;
+
+    if ((p_Href == NULL) || ((p_Event != NULL) && ((p_Event->UID == NULL) ||
+                                                   ((p_Event->Start == 0) && (p_Event->StartTime == NULL))))) {
+        return CALDAV_ERROR_INVALID_ARG;
+    }
+
+    HasETag = (p_Match != NULL) && (p_Match[0] != '\0');
+
+    _CalDAV_Build_URL(p_Client, p_Href, URL, sizeof(URL));
+
+    ESP_LOGD(TAG, "%s %s (ETag: %s)", (p_Event != NULL) ? "Storing" : "Deleting", URL, HasETag ? p_Match : "-");
+
+    if (_CalDAV_HTTP_Get_Handle(p_Client) == NULL) {
+        return CALDAV_ERROR_FAIL;
+    }
+
+    p_Document->Length = 0;
+    p_Document->IsOutOfMemory = false;
+    if (p_Event != NULL) {
+        _CalDAV_iCal_Append_Event(p_Document, p_Event);
+        if (p_Document->IsOutOfMemory) {
+            ESP_LOGE(TAG, "Failed to allocate request body!");
+
+            return CALDAV_ERROR_NO_MEM;
+        }
+    }
+
+    /* The body is discarded */
+    memset(&Receiver, 0, sizeof(Receiver));
+    ETag[0] = '\0';
+    Receiver.p_ETag = ETag;
+    Receiver.ETagSize = sizeof(ETag);
+    Receiver.p_ContentType = "text/calendar; charset=utf-8";
+
+    /* Once the first request has been processed, a repeated one fails with 412 or 404 */
+    Receiver.IsNotRetryable = true;
+
+    /* A new resource must not overwrite an existing one with the same name */
+    if (HasETag) {
+        Receiver.p_IfMatch = p_Match;
+    } else if (p_Event != NULL) {
+        Receiver.p_IfNoneMatch = "*";
+    }
+
+#if CONFIG_ESP32_CALDAV_STATS
+    _CalDAV_Stats_Begin(p_Client, &Receiver);
+#endif
+
+    if (p_Event != NULL) {
+        Error = _CalDAV_HTTP_Perform(p_Client, URL, HTTP_METHOD_PUT, NULL, NULL, p_Document->p_Data,
+                                     p_Document->Length, &Receiver, &StatusCode);
+    } else {
+        Error = _CalDAV_HTTP_Perform(p_Client, URL, HTTP_METHOD_DELETE, NULL, NULL, NULL, 0, &Receiver,
+                                     &StatusCode);
+    }
+
+#if CONFIG_ESP32_CALDAV_STATS
+    _CalDAV_Stats_End(&Receiver, NULL);
+#endif
+
+    /* The request may have been processed before the connection was lost, the result is unknown */
+    if (Error != ESP_OK) {
+        ESP_LOGE(TAG, "%s failed: %d!", (p_Event != NULL) ? "PUT" : "DELETE", Error);
+
+        return CALDAV_ERROR_HTTP;
+    }
+
+    if (StatusCode == 412) {
+        ESP_LOGW(TAG, "%s has been changed on the server!", p_Href);
+
+        return CALDAV_ERROR_PRECONDITION;
+    }
+
+    if (StatusCode == 404) {
+        return CALDAV_ERROR_NOT_FOUND;
+    }
+
+    if ((StatusCode != 200) && (StatusCode != 201) && (StatusCode != 204) &&
+        ((p_Event != NULL) || (StatusCode != 202))) {
+        ESP_LOGE(TAG, "%s unexpected status: %d!", (p_Event != NULL) ? "PUT" : "DELETE", StatusCode);
+
+        return CALDAV_ERROR_HTTP;
+    }
+
+    /* Without an ETag the server has modified the event and it has to be fetched for the new one */
+    if (p_ETag != NULL) {
+        if (p_Event == NULL) {
+            ETag[0] = '\0';
+        } else if (strlen(ETag) >= ETagSize) {
+            ESP_LOGW(TAG, "ETag too long, ignored!");
+            ETag[0] = '\0';
+        }
+
+        snprintf(p_ETag, ETagSize, "%s", ETag);
+    }
+
+    return CALDAV_ERROR_OK;
+}
+
+CalDAV_Error_t CalDAV_Event_Put(CalDAV_Client_t *p_Client,
+                                const char *p_Href,
+                                const CalDAV_Calendar_Event_t *p_Event,
+                                char *p_ETag,
+                                size_t ETagSize)
+{
+    CalDAV_Error_t Error;
+    CalDAV_Document_t RequestBody;
+
+    if ((p_Client == NULL) || (p_Client->IsInitialized == false) || (p_Event == NULL) ||
+        ((p_ETag != NULL) && (ETagSize == 0))) {
+        return CALDAV_ERROR_INVALID_ARG;
+    }
+
+    _CalDAV_Document_Init(p_Client, &RequestBody);
+    Error = _CalDAV_Event_Write(p_Client, &RequestBody, p_Href, p_Event, p_ETag, p_ETag, ETagSize);
+    _CalDAV_Document_Free(&RequestBody);
+
+    return Error;
+}
+
+CalDAV_Error_t CalDAV_Event_Delete(CalDAV_Client_t *p_Client, const char *p_Href, const char *p_ETag)
+{
+    CalDAV_Document_t RequestBody;
+
+    if ((p_Client == NULL) || (p_Client->IsInitialized == false)) {
+        return CALDAV_ERROR_INVALID_ARG;
+    }
+
+    /* A DELETE has no body and never writes the ETag */
+    _CalDAV_Document_Init(p_Client, &RequestBody);
+
+    return _CalDAV_Event_Write(p_Client, &RequestBody, p_Href, NULL, p_ETag, NULL, 0);
+}
+
+CalDAV_Error_t CalDAV_Events_Write_Multi(CalDAV_Client_t *p_Client, CalDAV_Event_Change_t *p_Changes, size_t Count)
+{
+    CalDAV_Error_t Error = CALDAV_ERROR_OK;
+    CalDAV_Document_t RequestBody;
+
+    if ((p_Client == NULL) || (p_Client->IsInitialized == false) || (p_Changes == NULL)) {
+        return CALDAV_ERROR_INVALID_ARG;
+    }
+
+    /* The requests are sent one after another over the kept-alive connection and share the body buffer */
+    _CalDAV_Document_Init(p_Client, &RequestBody);
+
+    for (size_t i = 0; i < Count; i++) {
+        p_Changes[i].Result = _CalDAV_Event_Write(p_Client, &RequestBody, p_Changes[i].Href, p_Changes[i].p_Event,
+                                                  p_Changes[i].ETag, p_Changes[i].ETag, sizeof(p_Changes[i].ETag));
+        if ((p_Changes[i].Result != CALDAV_ERROR_OK) && (Error == CALDAV_ERROR_OK)) {
+            Error = p_Changes[i].Result;
+        }
+    }
+
+    _CalDAV_Document_Free(&RequestBody);
+
+    return Error;
+}
+
+CalDAV_Error_t CalDAV_Calendar_Sync(CalDAV_Client_t *p_Client,
+                                    const char *p_CalendarPath,
+                                    char *p_SyncToken,
+                                    size_t TokenSize,
+                                    CalDAV_Sync_Callback_t Callback,
+                                    void *p_Arg)
+{
+    char URL[512];
+    esp_err_t Error;
+    int StatusCode;
+    char *p_NewToken;
+    CalDAV_Parser_t Parser;
+    CalDAV_Sync_Context_t Context;
+    CalDAV_Document_t RequestBody;
+
+    if ((p_Client == NULL) || (p_Client->IsInitialized == false) || (p_CalendarPath == NULL) ||
+        (p_SyncToken == NULL) || (TokenSize == 0) || (Callback == NULL)) {
+        return CALDAV_ERROR_INVALID_ARG;
+    }
+
+    _CalDAV_Build_URL(p_Client, p_CalendarPath, URL, sizeof(URL));
+
+    ESP_LOGD(TAG, "Syncing %s from token '%s'", URL, p_SyncToken);
+
+    if (_CalDAV_HTTP_Get_Handle(p_Client) == NULL) {
+        return CALDAV_ERROR_FAIL;
+    }
+
+    /* The old token must stay intact until the sync is complete */
+    p_NewToken = (char *)CUSTOM_MALLOC(TokenSize);
+    if (p_NewToken == NULL) {
+        return CALDAV_ERROR_NO_MEM;
+    }
+
+    _CalDAV_Document_Init(p_Client, &RequestBody);
+    _CalDAV_Document_Append(&RequestBody,
+                            "<?xml version=\"1.0\" encoding=\"utf-8\" ?>\n"
+                            "<D:sync-collection xmlns:D=\"DAV:\" xmlns:C=\"urn:ietf:params:xml:ns:caldav\">\n"
+                            "  <D:sync-token>");
+    _CalDAV_XML_Append_Escaped(&RequestBody, p_SyncToken);
+    _CalDAV_Document_Append(&RequestBody, "</D:sync-token>\n"
+                                          "  <D:sync-level>1</D:sync-level>\n"
+                                          "  <D:prop>\n"
+                                          "    <D:getetag/>\n");
+    _CalDAV_Document_Append_Length(&RequestBody, p_Client->CalendarData, p_Client->CalendarDataLength);
+    _CalDAV_Document_Append(&RequestBody, "  </D:prop>\n"
+                                          "</D:sync-collection>");
+
+    if (RequestBody.IsOutOfMemory) {
+        ESP_LOGE(TAG, "Failed to allocate request body!");
+        _CalDAV_Document_Free(&RequestBody);
+        CUSTOM_FREE(p_NewToken);
+
+        return CALDAV_ERROR_NO_MEM;
+    }
+
+    memset(&Context, 0, sizeof(Context));
+    Context.p_Parser = &Parser;
+    Context.Callback = Callback;
+    Context.p_Arg = p_Arg;
+    Context.p_SyncToken = p_NewToken;
+    Context.TokenSize = TokenSize;
+
+    /* RFC 6578 only defines the report for Depth 0 */
+    Error = _CalDAV_HTTP_Parse(p_Client, URL, HTTP_METHOD_POST, "0", "REPORT", RequestBody.p_Data,
+                               RequestBody.Length, &Parser, on_Sync_Response, on_Sync_Event, &Context, NULL,
+                               &StatusCode);
+    _CalDAV_Document_Free(&RequestBody);
+
+    if (Error == ESP_ERR_NO_MEM) {
+        CUSTOM_FREE(p_NewToken);
+
+        return CALDAV_ERROR_NO_MEM;
+    }
+
+    if (Error != ESP_OK) {
+        ESP_LOGE(TAG, "Sync REPORT failed: %d!", Error);
+        CUSTOM_FREE(p_NewToken);
+
+        return CALDAV_ERROR_HTTP;
+    }
+
+    /* An expired token is answered with the DAV:valid-sync-token precondition */
+    if ((StatusCode == 403) || (StatusCode == 409)) {
+        ESP_LOGW(TAG, "Sync token not accepted (Status: %d), full sync required!", StatusCode);
+        CUSTOM_FREE(p_NewToken);
+        p_SyncToken[0] = '\0';
+
+        return CALDAV_ERROR_INVALID_TOKEN;
+    }
+
+    if (StatusCode == 404) {
+        CUSTOM_FREE(p_NewToken);
+
+        return CALDAV_ERROR_NOT_FOUND;
+    }
+
+    if ((StatusCode != 200) && (StatusCode != 207)) {
+        ESP_LOGE(TAG, "Sync REPORT unexpected status: %d!", StatusCode);
+        CUSTOM_FREE(p_NewToken);
+
+        return CALDAV_ERROR_HTTP;
+    }
+
+    if ((Parser.HasRoot == false) || Parser.IsHTML) {
+        ESP_LOGW(TAG, "CalDAV response is not a multistatus document!");
+        CUSTOM_FREE(p_NewToken);
+
+        return CALDAV_ERROR_HTTP;
+    }
+
+    if (Parser.IsStopped) {
+        ESP_LOGD(TAG, "Sync stopped by callback, token not updated");
+        CUSTOM_FREE(p_NewToken);
+
+        return CALDAV_ERROR_OK;
+    }
+
+    if (Context.IsTokenTruncated) {
+        ESP_LOGE(TAG, "Sync token buffer too small!");
+        CUSTOM_FREE(p_NewToken);
+
+        return CALDAV_ERROR_NO_MEM;
+    }
+
+    if (Context.HasToken) {
+        strcpy(p_SyncToken, p_NewToken);
+    } else {
+        ESP_LOGW(TAG, "Sync response without a new token!");
+    }
+
+    CUSTOM_FREE(p_NewToken);
+
+    return CALDAV_ERROR_OK;
+}
+
+/** @brief              Fetches the stale entries of an event cache with calendar-multiget REPORTs.
+ *                      Up to CONFIG_ESP32_CALDAV_MULTIGET_HREFS resources are requested at once.
+ *  @param p_Client     CalDAV client handle
+ *  @param p_URL        URL of the calendar
+ *  @param p_Context    Cache context
+ *  @return             CALDAV_ERROR_OK on success, error code otherwise
+ */
+static CalDAV_Error_t _CalDAV_Event_Cache_Multiget(CalDAV_Client_t *p_Client, const char *p_URL,
+                                                   CalDAV_Cache_Context_t *p_Context)
+{
+    size_t Index = 0;
+    CalDAV_Event_Cache_t *p_Cache = p_Context->p_Cache;
+
+    while (Index < p_Cache->Length) {
+        size_t Hrefs = 0;
+        esp_err_t Error;
+        int StatusCode;
+        CalDAV_Parser_t Parser;
+
+        CalDAV_Document_t RequestBody;
+
+        _CalDAV_Document_Init(p_Client, &RequestBody);
+        _CalDAV_Document_Append(&RequestBody,
+                                "<?xml version=\"1.0\" encoding=\"utf-8\" ?>\n"
+                                "<C:calendar-multiget xmlns:D=\"DAV:\" xmlns:C=\"urn:ietf:params:xml:ns:caldav\">\n"
+                                "  <D:prop>\n"
+                                "    <D:getetag/>\n");
+        _CalDAV_Document_Append_Length(&RequestBody, p_Client->CalendarData, p_Client->CalendarDataLength);
+        _CalDAV_Document_Append(&RequestBody, "  </D:prop>\n");
+        for (; (Index < p_Cache->Length) && (Hrefs < CONFIG_ESP32_CALDAV_MULTIGET_HREFS); Index++) {
+            if (p_Cache->p_Entries[Index].IsStale) {
+                _CalDAV_Document_Append(&RequestBody, "  <D:href>");
+                _CalDAV_XML_Append_Escaped(&RequestBody, p_Cache->p_Entries[Index].Href);
+                _CalDAV_Document_Append(&RequestBody, "</D:href>\n");
+                Hrefs++;
+            }
+        }
+        _CalDAV_Document_Append(&RequestBody, "</C:calendar-multiget>");
+
+        if (Hrefs == 0) {
+            _CalDAV_Document_Free(&RequestBody);
+
+            break;
+        }
+
+        if (RequestBody.IsOutOfMemory) {
+            ESP_LOGE(TAG, "Failed to allocate request body!");
+            _CalDAV_Document_Free(&RequestBody);
+
+            return CALDAV_ERROR_NO_MEM;
+        }
+
+        ESP_LOGD(TAG, "Fetching %u changed resources", (unsigned int)Hrefs);
+
+        _CalDAV_Arena_Init(&p_Context->Arena, sizeof(CalDAV_Calendar_Event_t), NULL, 0);
+        Error = _CalDAV_HTTP_Parse(p_Client, p_URL, HTTP_METHOD_POST, "1", "REPORT", RequestBody.p_Data,
+                                   RequestBody.Length, &Parser, on_Cache_Multiget_Response, on_Cache_Event,
+                                   p_Context, NULL, &StatusCode);
+        _CalDAV_Document_Free(&RequestBody);
+        _CalDAV_Arena_Free(_CalDAV_Arena_Finish(&p_Context->Arena));
+
+        if ((Error == ESP_ERR_NO_MEM) || p_Context->IsOutOfMemory) {
+            ESP_LOGE(TAG, "Failed to allocate memory for events!");
+
+            return CALDAV_ERROR_NO_MEM;
+        }
+
+        if (Error != ESP_OK) {
+            ESP_LOGE(TAG, "Calendar-multiget failed: %d!", Error);
+
+            return CALDAV_ERROR_HTTP;
+        }
+
+        if ((StatusCode != 200) && (StatusCode != 207)) {
+            ESP_LOGE(TAG, "Calendar-multiget unexpected status: %d!", StatusCode);
+
+            return CALDAV_ERROR_HTTP;
+        }
+    }
+
+    return CALDAV_ERROR_OK;
+}
+
+/** @brief              Writes data to an event cache or calendar list file.
+ *  @param p_File       File
+ *  @param p_Data       Data
+ *  @param Length       Length of the data
+ *  @return             true on success
+ */
+static bool _CalDAV_Cache_File_Write(CalDAV_Cache_File_t *p_File, const void *p_Data, size_t Length)
+{
+    p_File->CRC = esp_rom_crc32_le(p_File->CRC, (const uint8_t *)p_Data, Length);
+
+    return (fwrite(p_Data, 1, Length, p_File->p_File) == Length);
+}
+
+/** @brief              Reads data from an event cache or calendar list file.
+ *  @param p_File       File
+ *  @param p_Data       Pointer to store the data
+ *  @param Length       Length of the data
+ *  @return             true on success
+ */
+static bool _CalDAV_Cache_File_Read(CalDAV_Cache_File_t *p_File, void *p_Data, size_t Length)
+{
+    if (fread(p_Data, 1, Length, p_File->p_File) != Length) {
+        return false;
+    }
+
+    p_File->CRC = esp_rom_crc32_le(p_File->CRC, (const uint8_t *)p_Data, Length);
+
+    return true;
+}
+
+/** @brief              Writes an unsigned integer in little endian byte order, independent of the target.
+ *  @param p_File       File
+ *  @param Value        Value
+ *  @param Size         Size of the integer in bytes (1 to 8)
+ *  @return             true on success
+ */
+static bool _CalDAV_Cache_File_Write_Integer(CalDAV_Cache_File_t *p_File, uint64_t Value, size_t Size)
+{
+    uint8_t Bytes[8];
+
+    for (size_t i = 0; i < Size; i++) {
+        Bytes[i] = (uint8_t)(Value >> (8 * i));
+    }
+
+    return _CalDAV_Cache_File_Write(p_File, Bytes, Size);
+}
+
+/** @brief              Reads an unsigned integer in little endian byte order.
+ *  @param p_File       File
+ *  @param p_Value      Pointer to store the value
+ *  @param Size         Size of the integer in bytes (1 to 8)
+ *  @return             true on success
+ */
+static bool _CalDAV_Cache_File_Read_Integer(CalDAV_Cache_File_t *p_File, uint64_t *p_Value, size_t Size)
+{
+    uint8_t Bytes[8];
+
+    if (_CalDAV_Cache_File_Read(p_File, Bytes, Size) == false) {
+        return false;
+    }
+
+    *p_Value = 0;
+    for (size_t i = 0; i < Size; i++) {
+        *p_Value |= (uint64_t)Bytes[i] << (8 * i);
+    }
+
+    return true;
+}
+
+/** @brief              Reads a 32 bit count in little endian byte order.
+ *  @param p_File       File
+ *  @param p_Count      Pointer to store the count
+ *  @return             true on success
+ */
+static bool _CalDAV_Cache_File_Read_Count(CalDAV_Cache_File_t *p_File, uint32_t *p_Count)
+{
+    uint64_t Value;
+
+    if (_CalDAV_Cache_File_Read_Integer(p_File, &Value, sizeof(uint32_t)) == false) {
+        return false;
+    }
+
+    *p_Count = (uint32_t)Value;
+
+    return true;
+}
+
+/** @brief              Creates the temporary file of a save and writes the header.
+ *                      The file is written next to the target and only renamed over it when it is complete, so a
+ *                      power loss during the save keeps the previous file.
+ *  @param p_File       File to initialize
+ *  @param p_FilePath   Path of the target file
+ *  @param p_Magic      Identification of the file (4 characters)
+ *  @param Version      Version of the file format
+ *  @param Count        Number of records
+ *  @return             CALDAV_ERROR_OK on success
+ */
+static CalDAV_Error_t _CalDAV_Cache_File_Create(CalDAV_Cache_File_t *p_File, const char *p_FilePath,
+                                                const char *p_Magic, uint8_t Version, uint32_t Count)
+{
+    memset(p_File, 0, sizeof(CalDAV_Cache_File_t));
+
+    if ((size_t)snprintf(p_File->TempPath, sizeof(p_File->TempPath), "%s%s", p_FilePath,
+                         CALDAV_CACHE_FILE_TEMP) >= sizeof(p_File->TempPath)) {
+        ESP_LOGE(TAG, "File path too long: %s!", p_FilePath);
+
+        return CALDAV_ERROR_INVALID_ARG;
+    }
+
+    p_File->p_File = fopen(p_File->TempPath, "wb");
+    if (p_File->p_File == NULL) {
+        ESP_LOGE(TAG, "Failed to open %s!", p_File->TempPath);
+
+        return CALDAV_ERROR_FAIL;
+    }
+
+    p_File->IsOk = _CalDAV_Cache_File_Write(p_File, p_Magic, 4) &&
+                   _CalDAV_Cache_File_Write_Integer(p_File, Version, sizeof(Version)) &&
+                   _CalDAV_Cache_File_Write_Integer(p_File, Count, sizeof(Count));
+
+    return CALDAV_ERROR_OK;
+}
+
+/** @brief              Finishes a save: appends the CRC32 of the content, flushes the temporary file to the storage
+ *                      and renames it over the target. A failed save removes the temporary file.
+ *  @param p_File       File created with _CalDAV_Cache_File_Create
+ *  @param p_FilePath   Path of the target file
+ *  @return             CALDAV_ERROR_OK on success, CALDAV_ERROR_FAIL if the file cannot be written
+ */
+static CalDAV_Error_t _CalDAV_Cache_File_Commit(CalDAV_Cache_File_t *p_File, const char *p_FilePath)
+{
+    bool IsOk = p_File->IsOk && _CalDAV_Cache_File_Write_Integer(p_File, p_File->CRC, sizeof(p_File->CRC));
+
+    IsOk = IsOk && (fflush(p_File->p_File) == 0) && (fsync(fileno(p_File->p_File)) == 0);
+
+    if (fclose(p_File->p_File) != 0) {
+        IsOk = false;
+    }
+
+    /* FAT and SPIFFS do not replace an existing file on rename. If the power fails after the remove, the load falls
+       back to the complete temporary file */
+    if (IsOk && (rename(p_File->TempPath, p_FilePath) != 0)) {
+        remove(p_FilePath);
+        IsOk = (rename(p_File->TempPath, p_FilePath) == 0);
+    }
+
+    if (IsOk == false) {
+        ESP_LOGE(TAG, "Failed to write %s!", p_FilePath);
+        remove(p_File->TempPath);
+
+        return CALDAV_ERROR_FAIL;
+    }
+
+    return CALDAV_ERROR_OK;
+}
+
+/** @brief              Opens a file for loading and checks the header.
+ *                      Without the file, the temporary file of an interrupted save is used. It is only accepted if
+ *                      it is complete, which _CalDAV_Cache_File_Close decides.
+ *  @param p_File       File to initialize
+ *  @param p_FilePath   Path of the file
+ *  @param p_Magic      Identification of the file (4 characters)
+ *  @param Version      Expected version of the file format
+ *  @param p_Count      Pointer to store the number of records
+ *  @return             CALDAV_ERROR_OK on success, CALDAV_ERROR_NOT_FOUND if the file does not exist,
+ *                      CALDAV_ERROR_FAIL if the header is invalid (the file must still be closed)
+ */
+static CalDAV_Error_t _CalDAV_Cache_File_Open(CalDAV_Cache_File_t *p_File, const char *p_FilePath,
+                                              const char *p_Magic, uint8_t Version, uint32_t *p_Count)
+{
+    char Magic[4];
+    uint64_t FileVersion;
+
+    memset(p_File, 0, sizeof(CalDAV_Cache_File_t));
+
+    p_File->p_File = fopen(p_FilePath, "rb");
+    if ((p_File->p_File == NULL) &&
+        ((size_t)snprintf(p_File->TempPath, sizeof(p_File->TempPath), "%s%s", p_FilePath,
+                          CALDAV_CACHE_FILE_TEMP) < sizeof(p_File->TempPath))) {
+        p_File->p_File = fopen(p_File->TempPath, "rb");
+    }
+
+    if (p_File->p_File == NULL) {
+        return CALDAV_ERROR_NOT_FOUND;
+    }
+
+    if ((_CalDAV_Cache_File_Read(p_File, Magic, sizeof(Magic)) == false) || (memcmp(Magic, p_Magic, 4) != 0) ||
+        (_CalDAV_Cache_File_Read_Integer(p_File, &FileVersion, sizeof(Version)) == false) ||
+        (FileVersion != Version) || (_CalDAV_Cache_File_Read_Count(p_File, p_Count) == false)) {
+        return CALDAV_ERROR_FAIL;
+    }
+
+    return CALDAV_ERROR_OK;
+}
+
+/** @brief              Closes a loaded file. After the last record, the CRC32 at the end of the file is checked.
+ *  @param p_File       File opened with _CalDAV_Cache_File_Open
+ *  @param IsComplete   All records have been read
+ *  @return             true if the file is complete and unchanged (false if IsComplete is false)
+ */
+static bool _CalDAV_Cache_File_Close(CalDAV_Cache_File_t *p_File, bool IsComplete)
+{
+    uint32_t CRC = p_File->CRC;
+    uint32_t Stored;
+    bool IsOk;
+
+    IsOk = IsComplete && _CalDAV_Cache_File_Read_Count(p_File, &Stored) && (Stored == CRC) &&
+           (fgetc(p_File->p_File) == EOF);
+    fclose(p_File->p_File);
+
+    return IsOk;
+}
+
+/** @brief          Writes a string to an event cache file.
+ *  @param p_File   File
+ *  @param p_String String (may be NULL)
+ *  @return         true on success
+ */
+static bool _CalDAV_Event_Cache_Write_String(CalDAV_Cache_File_t *p_File, const char *p_String)
+{
+    size_t Length;
+
+    if (p_String == NULL) {
+        return _CalDAV_Cache_File_Write_Integer(p_File, CALDAV_EVENT_CACHE_NULL, sizeof(uint16_t));
+    }
+
+    /* Longer strings would collide with the NULL marker, they are truncated */
+    Length = (strlen(p_String) < CALDAV_EVENT_CACHE_NULL) ? strlen(p_String) : (CALDAV_EVENT_CACHE_NULL - 1);
+
+    return _CalDAV_Cache_File_Write_Integer(p_File, Length, sizeof(uint16_t)) &&
+           _CalDAV_Cache_File_Write(p_File, p_String, Length);
+}
+
+/** @brief              Reads a string from an event cache file.
+ *  @param p_File       File
+ *  @param pp_Scratch   Scratch buffer, enlarged as needed (caller must free it)
+ *  @param pp_String    Pointer to store the string (NULL for a NULL string), valid until the next call
+ *  @return             true on success
+ */
+static bool _CalDAV_Event_Cache_Read_String(CalDAV_Cache_File_t *p_File, char **pp_Scratch, const char **pp_String)
+{
+    uint64_t Length;
+    char *p_Scratch;
+
+    if (_CalDAV_Cache_File_Read_Integer(p_File, &Length, sizeof(uint16_t)) == false) {
+        return false;
+    }
+
+    if (Length == CALDAV_EVENT_CACHE_NULL) {
+        *pp_String = NULL;
+
+        return true;
+    }
+
+    p_Scratch = (char *)CUSTOM_BUFFER_REALLOC(*pp_Scratch, Length + 1);
+    if (p_Scratch == NULL) {
+        return false;
+    }
+
+    *pp_Scratch = p_Scratch;
+    if (_CalDAV_Cache_File_Read(p_File, p_Scratch, Length) == false) {
+        return false;
+    }
+
+    p_Scratch[Length] = '\0';
+    *pp_String = p_Scratch;
+
+    return true;
+}
+
+/** @brief          Writes the binary times of an event to an event cache file.
+ *  @param p_File   File
+ *  @param p_Event  Event
+ *  @return         true on success
+ */
+static bool _CalDAV_Event_Cache_Write_Times(CalDAV_Cache_File_t *p_File, const CalDAV_Calendar_Event_t *p_Event)
+{
+    return _CalDAV_Cache_File_Write_Integer(p_File, (uint64_t)(int64_t)p_Event->Start, sizeof(int64_t)) &&
+           _CalDAV_Cache_File_Write_Integer(p_File, (uint64_t)(int64_t)p_Event->End, sizeof(int64_t)) &&
+           _CalDAV_Cache_File_Write_Integer(p_File, (uint32_t)p_Event->Offset, sizeof(int32_t)) &&
+           _CalDAV_Cache_File_Write_Integer(p_File, p_Event->IsAllDay ? 1 : 0, sizeof(uint8_t));
+}
+
+/** @brief          Reads the binary times of an event from an event cache file.
+ *  @param p_File   File
+ *  @param p_Event  Event
+ *  @return         true on success
+ */
+static bool _CalDAV_Event_Cache_Read_Times(CalDAV_Cache_File_t *p_File, CalDAV_Calendar_Event_t *p_Event)
+{
+    uint64_t Start;
+    uint64_t End;
+    uint64_t Offset;
+    uint64_t IsAllDay;
+
+    if ((_CalDAV_Cache_File_Read_Integer(p_File, &Start, sizeof(int64_t)) == false) ||
+        (_CalDAV_Cache_File_Read_Integer(p_File, &End, sizeof(int64_t)) == false) ||
+        (_CalDAV_Cache_File_Read_Integer(p_File, &Offset, sizeof(int32_t)) == false) ||
+        (_CalDAV_Cache_File_Read_Integer(p_File, &IsAllDay, sizeof(uint8_t)) == false)) {
+        return false;
+    }
+
+    p_Event->Start = (time_t)(int64_t)Start;
+    p_Event->End = (time_t)(int64_t)End;
+    p_Event->Offset = (int32_t)(uint32_t)Offset;
+    p_Event->IsAllDay = (IsAllDay != 0);
+
+    return true;
+}
+
+CalDAV_Error_t CalDAV_Event_Cache_Init(CalDAV_Event_Cache_t *p_Cache, size_t MaxEntries)
+{
+    if ((p_Cache == NULL) || (MaxEntries == 0)) {
+        return CALDAV_ERROR_INVALID_ARG;
+    }
+
+    memset(p_Cache, 0, sizeof(CalDAV_Event_Cache_t));
+
+    p_Cache->p_Entries = (CalDAV_Event_Cache_Entry_t *)CUSTOM_MALLOC(MaxEntries * sizeof(CalDAV_Event_Cache_Entry_t));
+    if (p_Cache->p_Entries == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate event cache!");
+
+        return CALDAV_ERROR_NO_MEM;
+    }
+
+    p_Cache->MaxEntries = MaxEntries;
+
+    return CALDAV_ERROR_OK;
+}
+
+void CalDAV_Event_Cache_Deinit(CalDAV_Event_Cache_t *p_Cache)
+{
+    if ((p_Cache == NULL) || (p_Cache->p_Entries == NULL)) {
+        return;
+    }
+
+    while (p_Cache->Length > 0) {
+        _CalDAV_Event_Cache_Remove(p_Cache, p_Cache->Length - 1);
+    }
+
+    CUSTOM_FREE(p_Cache->p_Entries);
+    memset(p_Cache, 0, sizeof(CalDAV_Event_Cache_t));
+}
+
+CalDAV_Error_t CalDAV_Event_Cache_Refresh(CalDAV_Client_t *p_Client,
+                                          CalDAV_Event_Cache_t *p_Cache,
+                                          const char *p_CalendarPath,
+                                          const struct tm *p_StartTime,
+                                          const struct tm *p_EndTime,
+                                          size_t *p_Changed)
+{
+    char URL[512];
+    CalDAV_Error_t Error;
+    CalDAV_Cache_Context_t Context;
+
+    if ((p_Client == NULL) || (p_Client->IsInitialized == false) || (p_Cache == NULL) ||
+        (p_Cache->p_Entries == NULL) || (p_CalendarPath == NULL)) {
+        return CALDAV_ERROR_INVALID_ARG;
+    }
+
+    if (p_Changed != NULL) {
+        *p_Changed = 0;
+    }
+
+    memset(&Context, 0, sizeof(Context));
+    Context.p_Cache = p_Cache;
+
+    for (size_t i = 0; i < p_Cache->Length; i++) {
+        p_Cache->p_Entries[i].IsSeen = false;
+        p_Cache->p_Entries[i].IsStale = false;
+    }
+
+    /* List the ETags of all resources in the time range without the calendar data */
+    Error = _CalDAV_Calendar_Query(p_Client, p_CalendarPath, p_StartTime, p_EndTime, false, on_Cache_ETag_Response,
+                                   NULL, &Context, NULL);
+    if ((Error == CALDAV_ERROR_OK) && Context.IsOutOfMemory) {
+        Error = CALDAV_ERROR_NO_MEM;
+    }
+
+    if (Error != CALDAV_ERROR_OK) {
+        /* Entries added for the failed listing have no data yet */
+        for (size_t i = p_Cache->Length; i > 0; i--) {
+            if (p_Cache->p_Entries[i - 1].ETag == NULL) {
+                _CalDAV_Event_Cache_Remove(p_Cache, i - 1);
+            }
+        }
+
+        return Error;
+    }
+
+    /* Resources that are gone or outside of the time range */
+    for (size_t i = p_Cache->Length; i > 0; i--) {
+        if (p_Cache->p_Entries[i - 1].IsSeen == false) {
+            _CalDAV_Event_Cache_Remove(p_Cache, i - 1);
+            Context.Changed++;
+        }
+    }
+
+    _CalDAV_Build_URL(p_Client, p_CalendarPath, URL, sizeof(URL));
+
+    Error = _CalDAV_Event_Cache_Multiget(p_Client, URL, &Context);
+
+    /* Resources that could not be fetched are fetched again with the next refresh */
+    for (size_t i = p_Cache->Length; i > 0; i--) {
+        if (p_Cache->p_Entries[i - 1].IsStale) {
+            _CalDAV_Event_Cache_Remove(p_Cache, i - 1);
+        }
+    }
+
+    ESP_LOGD(TAG, "Event cache refreshed: %u resources, %u changes", (unsigned int)p_Cache->Length,
+             (unsigned int)Context.Changed);
+
+    if (p_Changed != NULL) {
+        *p_Changed = Context.Changed;
+    }
+
+    if ((Error == CALDAV_ERROR_OK) && Context.IsFull) {
+        ESP_LOGW(TAG, "Event cache full, not all resources are cached!");
+
+        Error = CALDAV_ERROR_NO_MEM;
+    }
+
+    return Error;
+}
+
+CalDAV_Error_t CalDAV_Event_Cache_Foreach(const CalDAV_Event_Cache_t *p_Cache,
+                                          CalDAV_Event_Callback_t Callback,
+                                          void *p_Arg)
+{
+    if ((p_Cache == NULL) || (Callback == NULL)) {
+        return CALDAV_ERROR_INVALID_ARG;
+    }
+
+    for (size_t i = 0; i < p_Cache->Length; i++) {
+        for (size_t j = 0; j < p_Cache->p_Entries[i].Length; j++) {
+            if (Callback(&p_Cache->p_Entries[i].p_Events[j], p_Arg) == false) {
+                return CALDAV_ERROR_OK;
             }
         }
+    }
 
-        /* Check DisplayName field if not found yet */
-        if (!Found && (p_Calendars->Calendar[i].DisplayName != NULL)) {
-            if (strcmp(p_Calendars->Calendar[i].DisplayName, p_Name) == 0) {
-                Found = true;
-            }
-        }
+    return CALDAV_ERROR_OK;
+}
 
-        if (Found) {
-            *pp_Calendar = &p_Calendars->Calendar[i];
-            ESP_LOGD(TAG, "Found calendar: %s (Path: %s)", 
-                     p_Name, 
-                     p_Calendars->Calendar[i].Path ? p_Calendars->Calendar[i].Path : "Unknown");
+CalDAV_Error_t CalDAV_Event_Cache_Save(const CalDAV_Event_Cache_t *p_Cache, const char *p_FilePath)
+{
+    CalDAV_Cache_File_t File;
+    CalDAV_Error_t Error;
 
-            return CALDAV_ERROR_OK;
-        }
+    if ((p_Cache == NULL) || (p_FilePath == NULL)) {
+        return CALDAV_ERROR_INVALID_ARG;
     }
 
-    ESP_LOGW(TAG, "Calendar '%s' not found in list of %zu calendars", p_Name, p_Calendars->Length);
+    Error = _CalDAV_Cache_File_Create(&File, p_FilePath, CALDAV_EVENT_CACHE_MAGIC, CALDAV_EVENT_CACHE_VERSION,
+                                      p_Cache->Length);
+    if (Error != CALDAV_ERROR_OK) {
+        return Error;
+    }
 
-    return CALDAV_ERROR_NOT_FOUND;
+    for (size_t i = 0; File.IsOk && (i < p_Cache->Length); i++) {
+        const CalDAV_Event_Cache_Entry_t *p_Entry = &p_Cache->p_Entries[i];
+
+        File.IsOk = _CalDAV_Event_Cache_Write_String(&File, p_Entry->Href) &&
+                    _CalDAV_Event_Cache_Write_String(&File, p_Entry->ETag) &&
+                    _CalDAV_Cache_File_Write_Integer(&File, p_Entry->Length, sizeof(uint32_t));
+
+        for (size_t j = 0; File.IsOk && (j < p_Entry->Length); j++) {
+            const CalDAV_Calendar_Event_t *p_Event = &p_Entry->p_Events[j];
+
+            File.IsOk = _CalDAV_Event_Cache_Write_String(&File, p_Event->UID) &&
+                        _CalDAV_Event_Cache_Write_String(&File, p_Event->Summary) &&
+                        _CalDAV_Event_Cache_Write_String(&File, p_Event->Description) &&
+                        _CalDAV_Event_Cache_Write_String(&File, p_Event->StartTime) &&
+                        _CalDAV_Event_Cache_Write_String(&File, p_Event->EndTime) &&
+                        _CalDAV_Event_Cache_Write_String(&File, p_Event->Location) &&
+                        _CalDAV_Event_Cache_Write_Times(&File, p_Event);
+        }
+    }
+
+    return _CalDAV_Cache_File_Commit(&File, p_FilePath);
 }
 
-CalDAV_Error_t CalDAV_Calendar_Events_List(CalDAV_Client_t *p_Client,
-                                           CalDAV_Calendar_Event_t **p_Events,
-                                           size_t *Length,
-                                           const char *p_CalendarPath,
-                                           const struct tm* p_StartTime,
-                                           const struct tm* p_EndTime)
+CalDAV_Error_t CalDAV_Event_Cache_Load(CalDAV_Event_Cache_t *p_Cache, const char *p_FilePath)
 {
-    char URL[512];
-    char StartTimeString[20];
-    char EndTimeString[20];
-    esp_err_t Error;
-    int StatusCode;
-    HTTP_Response_Buffer_t Response;
-    esp_http_client_handle_t HTTP_Client;
+    CalDAV_Cache_File_t File;
+    uint32_t Count = 0;
+    char *p_Scratch = NULL;
+    CalDAV_Error_t Error;
 
-    if ((p_Client == NULL) || (p_Client->IsInitialized == false) || (p_Events == NULL) || (Length == NULL) ||
-        (p_CalendarPath == NULL)) {
+    if ((p_Cache == NULL) || (p_Cache->p_Entries == NULL) || (p_FilePath == NULL)) {
         return CALDAV_ERROR_INVALID_ARG;
     }
 
-    memset(&Response, 0, sizeof(Response));
-    memset(StartTimeString, 0, sizeof(StartTimeString));
-    memset(EndTimeString, 0, sizeof(EndTimeString));
-    memset(URL, 0, sizeof(URL));
+    Error = _CalDAV_Cache_File_Open(&File, p_FilePath, CALDAV_EVENT_CACHE_MAGIC, CALDAV_EVENT_CACHE_VERSION, &Count);
+    if (Error == CALDAV_ERROR_NOT_FOUND) {
+        return Error;
+    }
 
-    /* Format as CalDAV expects: YYYYMMDDTHHMMSSZ */
-    strftime(StartTimeString, sizeof(StartTimeString), "%Y%m%dT%H%M%SZ", p_StartTime);
-    strftime(EndTimeString, sizeof(EndTimeString), "%Y%m%dT%H%M%SZ", p_EndTime);
+    while (p_Cache->Length > 0) {
+        _CalDAV_Event_Cache_Remove(p_Cache, p_Cache->Length - 1);
+    }
+
+    if ((Error == CALDAV_ERROR_OK) && (Count > p_Cache->MaxEntries)) {
+        Error = CALDAV_ERROR_NO_MEM;
+    }
+
+    for (uint32_t i = 0; (Error == CALDAV_ERROR_OK) && (i < Count); i++) {
+        CalDAV_Event_Cache_Entry_t *p_Entry = &p_Cache->p_Entries[p_Cache->Length];
+        CalDAV_Arena_t Arena;
+        const char *p_String;
+        uint32_t Events;
+
+        memset(p_Entry, 0, sizeof(CalDAV_Event_Cache_Entry_t));
+        p_Cache->Length++;
+
+        if ((_CalDAV_Event_Cache_Read_String(&File, &p_Scratch, &p_String) == false) || (p_String == NULL) ||
+            ((p_Entry->Href = _CalDAV_String_Duplicate(p_String)) == NULL) ||
+            (_CalDAV_Event_Cache_Read_String(&File, &p_Scratch, &p_String) == false) ||
+            ((p_String != NULL) && ((p_Entry->ETag = _CalDAV_String_Duplicate(p_String)) == NULL)) ||
+            (_CalDAV_Cache_File_Read_Count(&File, &Events) == false)) {
+            Error = CALDAV_ERROR_FAIL;
+
+            break;
+        }
+
+        _CalDAV_Arena_Init(&Arena, sizeof(CalDAV_Calendar_Event_t), NULL, 0);
+        for (uint32_t j = 0; (Error == CALDAV_ERROR_OK) && (j < Events); j++) {
+            CalDAV_Calendar_Event_t *p_Event = (CalDAV_Calendar_Event_t *)_CalDAV_Arena_Element(&Arena);
+            char **pp_Fields[] = {&p_Event->UID, &p_Event->Summary, &p_Event->Description, &p_Event->StartTime,
+                                  &p_Event->EndTime, &p_Event->Location};
+
+            if (p_Event == NULL) {
+                Error = CALDAV_ERROR_NO_MEM;
 
-    /* Build URL - if path is absolute (starts with /), use scheme://host + path */
-    if (p_CalendarPath[0] == '/') {
-        std::string BaseURL;
-        size_t SchemeEnd;
+                break;
+            }
+
+            for (size_t k = 0; k < (sizeof(pp_Fields) / sizeof(pp_Fields[0])); k++) {
+                if (_CalDAV_Event_Cache_Read_String(&File, &p_Scratch, &p_String) == false) {
+                    Error = CALDAV_ERROR_FAIL;
+
+                    break;
+                }
+
+                *pp_Fields[k] = (p_String != NULL) ? _CalDAV_Arena_String(&Arena, p_String, strlen(p_String)) : NULL;
+            }
+
+            if ((Error == CALDAV_ERROR_OK) && (_CalDAV_Event_Cache_Read_Times(&File, p_Event) == false)) {
+                Error = CALDAV_ERROR_FAIL;
+            }
 
-        /* Extract base URL (scheme://host) */
-        BaseURL = p_Client->ServerURL;
-        SchemeEnd = BaseURL.find("://");
-        if (SchemeEnd != std::string::npos) {
-            size_t PathStart;
-            
-            PathStart = BaseURL.find('/', SchemeEnd + 3);
-            if (PathStart != std::string::npos) {
-                BaseURL = BaseURL.substr(0, PathStart);
+            if ((Error == CALDAV_ERROR_OK) && Arena.IsOutOfMemory) {
+                Error = CALDAV_ERROR_NO_MEM;
             }
         }
 
-        snprintf(URL, sizeof(URL), "%s%s", BaseURL.c_str(), p_CalendarPath);
-    } else {
-        /* Relative path, append to server URL */
-        snprintf(URL, sizeof(URL), "%s/%s", p_Client->ServerURL.c_str(), p_CalendarPath);
+        p_Entry->Length = Arena.Length;
+        p_Entry->p_Events = (CalDAV_Calendar_Event_t *)_CalDAV_Arena_Finish(&Arena);
     }
 
-    ESP_LOGD(TAG, "Fetching events from %s between %s to %s", URL, StartTimeString, EndTimeString);
+    CUSTOM_FREE(p_Scratch);
 
-    _CalDAV_HTTP_Config.timeout_ms = p_Client->TimeoutMs;
-    _CalDAV_HTTP_Config.event_handler = on_HTTP_Event_Handler;
-    _CalDAV_HTTP_Config.url = URL;
-    _CalDAV_HTTP_Config.user_data = &Response;
-    HTTP_Client = esp_http_client_init(&_CalDAV_HTTP_Config);
-    if (HTTP_Client == NULL) {
-        return CALDAV_ERROR_FAIL;
+    if ((_CalDAV_Cache_File_Close(&File, Error == CALDAV_ERROR_OK) == false) && (Error == CALDAV_ERROR_OK)) {
+        Error = CALDAV_ERROR_FAIL;
     }
 
-    esp_http_client_set_username(HTTP_Client, p_Client->Username.c_str());
-    esp_http_client_set_password(HTTP_Client, p_Client->Password.c_str());
-    esp_http_client_set_authtype(HTTP_Client, HTTP_AUTH_TYPE_BASIC);
-
-    esp_http_client_set_method(HTTP_Client, HTTP_METHOD_POST);
-    esp_http_client_set_header(HTTP_Client, "Content-Type", "application/xml; charset=utf-8");
-    esp_http_client_set_header(HTTP_Client, "Depth", "1");
-    esp_http_client_set_header(HTTP_Client, "X-HTTP-Method-Override", "REPORT");
-
-    /* Build CalDAV calendar-query with time-range filter */
-    std::string RequestBody =
-        "<?xml version=\"1.0\" encoding=\"utf-8\" ?>\n"
-        "<C:calendar-query xmlns:D=\"DAV:\" xmlns:C=\"urn:ietf:params:xml:ns:caldav\">\n"
-        "  <D:prop>\n"
-        "    <D:getetag/>\n"
-        "    <C:calendar-data/>\n"
-        "  </D:prop>\n"
-        "  <C:filter>\n"
-        "    <C:comp-filter name=\"VCALENDAR\">\n"
-        "      <C:comp-filter name=\"VEVENT\">\n"
-        "        <C:time-range start=\"";
-    RequestBody += StartTimeString;
-    RequestBody += "\" end=\"";
-    RequestBody += EndTimeString;
-    RequestBody += "\"/>\n"
-                   "      </C:comp-filter>\n"
-                   "    </C:comp-filter>\n"
-                   "  </C:filter>\n"
-                   "</C:calendar-query>";
-    esp_http_client_set_post_field(HTTP_Client, RequestBody.c_str(), RequestBody.length());
-
-    Error = esp_http_client_perform(HTTP_Client);
-    StatusCode = esp_http_client_get_status_code(HTTP_Client);
-
-    esp_http_client_cleanup(HTTP_Client);
-
-    if (Error != ESP_OK) {
-        ESP_LOGE(TAG, "CalDAV-Query failed: %d (Status: %d)!", Error, StatusCode);
-        if (Response.Buffer) {
-            ESP_LOGE(TAG, "Response buffer content (first 500 chars): %.*s", 500, Response.Buffer);
+    if (Error != CALDAV_ERROR_OK) {
+        ESP_LOGE(TAG, "Failed to load %s (%d)!", p_FilePath, Error);
 
-            CUSTOM_FREE(Response.Buffer);
+        while (p_Cache->Length > 0) {
+            _CalDAV_Event_Cache_Remove(p_Cache, p_Cache->Length - 1);
         }
+    }
 
-        return CALDAV_ERROR_HTTP;
+    return Error;
+}
+
+CalDAV_Error_t CalDAV_Calendars_Save(const CalDAV_Calendar_List_t *p_Calendars, const char *p_FilePath)
+{
+    CalDAV_Cache_File_t File;
+    CalDAV_Error_t Error;
+
+    if ((p_Calendars == NULL) || (p_FilePath == NULL)) {
+        return CALDAV_ERROR_INVALID_ARG;
     }
 
-    if ((StatusCode != 200) && (StatusCode != 207)) {
-        ESP_LOGE(TAG, "CalDAV-Query unexpected status: %d!", StatusCode);
-        if (Response.Buffer) {
-            ESP_LOGE(TAG, "Response buffer content (first 500 chars): %.*s", 500, Response.Buffer);
+    Error = _CalDAV_Cache_File_Create(&File, p_FilePath, CALDAV_CALENDARS_MAGIC, CALDAV_CALENDARS_VERSION,
+                                      p_Calendars->Length);
+    if (Error != CALDAV_ERROR_OK) {
+        return Error;
+    }
 
-            CUSTOM_FREE(Response.Buffer);
-        }
+    for (size_t i = 0; File.IsOk && (i < p_Calendars->Length); i++) {
+        const CalDAV_Calendar_t *p_Calendar = &p_Calendars->Calendar[i];
 
-        return CALDAV_ERROR_HTTP;
+        File.IsOk = _CalDAV_Event_Cache_Write_String(&File, p_Calendar->Name) &&
+                    _CalDAV_Event_Cache_Write_String(&File, p_Calendar->Path) &&
+                    _CalDAV_Event_Cache_Write_String(&File, p_Calendar->DisplayName) &&
+                    _CalDAV_Event_Cache_Write_String(&File, p_Calendar->Description) &&
+                    _CalDAV_Event_Cache_Write_String(&File, p_Calendar->Color) &&
+                    _CalDAV_Event_Cache_Write_String(&File, p_Calendar->CTag) &&
+                    _CalDAV_Event_Cache_Write_String(&File, p_Calendar->SyncToken);
     }
 
-    /* Log response for debugging */
-    if (Response.Buffer) {
-        ESP_LOGD(TAG, "CalDAV response (Status: %d, Length: %zu)", StatusCode, Response.Position);
-        ESP_LOGD(TAG, "Response content (first 1000 chars): %.*s", 1000, Response.Buffer);
-    } else {
-        ESP_LOGW(TAG, "CalDAV response buffer is NULL!");
-        return CALDAV_ERROR_HTTP;
+    return _CalDAV_Cache_File_Commit(&File, p_FilePath);
+}
+
+CalDAV_Error_t CalDAV_Calendars_Load(CalDAV_Calendar_List_t *p_Calendars, const char *p_FilePath)
+{
+    CalDAV_Cache_File_t File;
+    uint32_t Count = 0;
+    char *p_Scratch = NULL;
+    CalDAV_Arena_t Arena;
+    CalDAV_Error_t Error;
+
+    if ((p_Calendars == NULL) || (p_FilePath == NULL)) {
+        return CALDAV_ERROR_INVALID_ARG;
     }
 
-    int EventCount = 0;
-    int CurrentEvent = 0;
-    std::string ResponseStr(Response.Buffer);
-    size_t SearchPos = 0;
+    p_Calendars->Calendar = NULL;
+    p_Calendars->Length = 0;
 
-    /* Count events in the response */
-    while ((SearchPos = ResponseStr.find("BEGIN:VEVENT", SearchPos)) != std::string::npos) {
-        EventCount++;
-        SearchPos += 12;
+    Error = _CalDAV_Cache_File_Open(&File, p_FilePath, CALDAV_CALENDARS_MAGIC, CALDAV_CALENDARS_VERSION, &Count);
+    if (Error == CALDAV_ERROR_NOT_FOUND) {
+        return Error;
     }
 
-    ESP_LOGD(TAG, "Found: %d events in response", EventCount);
-    
-    if (EventCount == 0) {
-        ESP_LOGD(TAG, "No events found in calendar");
+    _CalDAV_Arena_Init(&Arena, sizeof(CalDAV_Calendar_t), NULL, 0);
+    for (uint32_t i = 0; (Error == CALDAV_ERROR_OK) && (i < Count); i++) {
+        CalDAV_Calendar_t *p_Calendar = (CalDAV_Calendar_t *)_CalDAV_Arena_Element(&Arena);
+        char **pp_Fields[] = {&p_Calendar->Name, &p_Calendar->Path, &p_Calendar->DisplayName,
+                              &p_Calendar->Description, &p_Calendar->Color, &p_Calendar->CTag,
+                              &p_Calendar->SyncToken};
+        const char *p_String;
+
+        if (p_Calendar == NULL) {
+            Error = CALDAV_ERROR_NO_MEM;
+
+            break;
+        }
+
+        for (size_t k = 0; k < (sizeof(pp_Fields) / sizeof(pp_Fields[0])); k++) {
+            if (_CalDAV_Event_Cache_Read_String(&File, &p_Scratch, &p_String) == false) {
+                Error = CALDAV_ERROR_FAIL;
+
+                break;
+            }
+
+            *pp_Fields[k] = (p_String != NULL) ? _CalDAV_Arena_String(&Arena, p_String, strlen(p_String)) : NULL;
+        }
+
+        if ((Error == CALDAV_ERROR_OK) && Arena.IsOutOfMemory) {
+            Error = CALDAV_ERROR_NO_MEM;
+        } else if ((Error == CALDAV_ERROR_OK) && (p_Calendar->Path == NULL)) {
+            Error = CALDAV_ERROR_FAIL;
+        }
     }
 
-    if (EventCount == 0) {
-        *Length = 0;
-        *p_Events = NULL;
+    CUSTOM_FREE(p_Scratch);
+
+    if ((_CalDAV_Cache_File_Close(&File, Error == CALDAV_ERROR_OK) == false) && (Error == CALDAV_ERROR_OK)) {
+        Error = CALDAV_ERROR_FAIL;
+    }
 
-        CUSTOM_FREE(Response.Buffer);
+    if (Error != CALDAV_ERROR_OK) {
+        ESP_LOGE(TAG, "Failed to load %s (%d)!", p_FilePath, Error);
+        _CalDAV_Arena_Free(_CalDAV_Arena_Finish(&Arena));
 
-        return CALDAV_ERROR_OK;
+        return Error;
     }
 
-    ESP_LOGD(TAG, "Allocating memory for %d events (%zu bytes)", EventCount, EventCount * sizeof(CalDAV_Calendar_Event_t));
+    p_Calendars->Length = Arena.Length;
+    p_Calendars->Calendar = (CalDAV_Calendar_t *)_CalDAV_Arena_Finish(&Arena);
 
-    /* Allocate memory for all events */
-    *p_Events = (CalDAV_Calendar_Event_t *)calloc(EventCount, sizeof(CalDAV_Calendar_Event_t));
-    if (*p_Events == NULL) {
-        ESP_LOGE(TAG, "Failed to allocate memory for events!");
-        CUSTOM_FREE(Response.Buffer);
+    return CALDAV_ERROR_OK;
+}
 
-        return CALDAV_ERROR_NO_MEM;
+/** @brief      Compares two event index entries by start time, equal start times keep the order of the events.
+ *  @param p_A  First entry
+ *  @param p_B  Second entry
+ *  @return     Negative, 0 or positive like strcmp
+ */
+static int _CalDAV_Event_Index_Compare(const void *p_A, const void *p_B)
+{
+    const CalDAV_Event_Index_Entry_t *p_EntryA = (const CalDAV_Event_Index_Entry_t *)p_A;
+    const CalDAV_Event_Index_Entry_t *p_EntryB = (const CalDAV_Event_Index_Entry_t *)p_B;
+
+    if (p_EntryA->Start != p_EntryB->Start) {
+        return (p_EntryA->Start < p_EntryB->Start) ? -1 : 1;
+    }
+
+    /* qsort may compare an entry with itself, which must be equal */
+    if (p_EntryA->Event != p_EntryB->Event) {
+        return (p_EntryA->Event < p_EntryB->Event) ? -1 : 1;
     }
 
-    ESP_LOGD(TAG, "Memory allocated successfully");
+    return 0;
+}
 
-    /* Parse each event */
-    SearchPos = 0;
+/** @brief          Returns the first entry of an event index that starts at or after a point in time.
+ *  @param p_Index  Event index
+ *  @param Time     Point in time in seconds since 1970 (UTC)
+ *  @return         Position of the entry or the number of entries if all entries start earlier
+ */
+static size_t _CalDAV_Event_Index_Lower_Bound(const CalDAV_Event_Index_t *p_Index, time_t Time)
+{
+    size_t Low = 0;
+    size_t High = p_Index->Length;
 
-    while ((SearchPos = ResponseStr.find("BEGIN:VEVENT", SearchPos)) != std::string::npos && CurrentEvent < EventCount) {
-            size_t EventLen;
-            size_t EventEnd;
-            char *EventData;
+    while (Low < High) {
+        size_t Middle = Low + ((High - Low) / 2);
 
-            EventEnd = ResponseStr.find("END:VEVENT", SearchPos);
-            if (EventEnd == std::string::npos) {
-                break;
-            }
+        if (p_Index->p_Entries[Middle].Start < Time) {
+            Low = Middle + 1;
+        } else {
+            High = Middle;
+        }
+    }
 
-            /* Extract event data */
-            EventLen = EventEnd - SearchPos + 10;
-            EventData = (char *)CUSTOM_MALLOC(EventLen + 1);
+    return Low;
+}
 
-            if (EventData == NULL) {
-                /* Allocation failure for event data: clean up and return */
-                for (int i = 0; i < CurrentEvent; ++i) {
-                    CUSTOM_FREE((*p_Events)[i].Summary);
-                    CUSTOM_FREE((*p_Events)[i].Description);
-                    CUSTOM_FREE((*p_Events)[i].Location);
-                    CUSTOM_FREE((*p_Events)[i].UID);
-                    CUSTOM_FREE((*p_Events)[i].StartTime);
-                    CUSTOM_FREE((*p_Events)[i].EndTime);
-                }
+CalDAV_Error_t CalDAV_Event_Index_Build(const CalDAV_Calendar_Event_t *p_Events,
+                                        size_t Length,
+                                        const size_t *p_Calendar,
+                                        CalDAV_Event_Index_t *p_Index)
+{
+    time_t Reach = 0;
 
-                *p_Events = NULL;
-                *Length = 0;
+    if ((p_Index == NULL) || ((p_Events == NULL) && (Length > 0)) || (Length > UINT32_MAX)) {
+        return CALDAV_ERROR_INVALID_ARG;
+    }
 
-                CUSTOM_FREE(*p_Events);
-                CUSTOM_FREE(Response.Buffer);
+    memset(p_Index, 0, sizeof(CalDAV_Event_Index_t));
 
-                return CALDAV_ERROR_NO_MEM;
-            }
+    if (Length == 0) {
+        return CALDAV_ERROR_OK;
+    }
 
-            memcpy(EventData, Response.Buffer + SearchPos, EventLen);
-            EventData[EventLen] = '\0';
+    p_Index->p_Entries = (CalDAV_Event_Index_Entry_t *)CUSTOM_MALLOC(Length * sizeof(CalDAV_Event_Index_Entry_t));
+    if (p_Index->p_Entries == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate event index!");
+
+        return CALDAV_ERROR_NO_MEM;
+    }
 
-            /* Parse iCal fields */
-            (*p_Events)[CurrentEvent].Summary = _CalDAV_String_to_cstr(_CalDAV_Extract_iCal_Field(EventData, "SUMMARY:"));
-            (*p_Events)[CurrentEvent].Description = _CalDAV_String_to_cstr(_CalDAV_Extract_iCal_Field(EventData, "DESCRIPTION:"));
-            (*p_Events)[CurrentEvent].Location = _CalDAV_String_to_cstr(_CalDAV_Extract_iCal_Field(EventData, "LOCATION:"));
-            (*p_Events)[CurrentEvent].UID = _CalDAV_String_to_cstr(_CalDAV_Extract_iCal_Field(EventData, "UID:"));
-            (*p_Events)[CurrentEvent].StartTime = _CalDAV_String_to_cstr(_CalDAV_Extract_iCal_Field(EventData, "DTSTART"));
-            (*p_Events)[CurrentEvent].EndTime = _CalDAV_String_to_cstr(_CalDAV_Extract_iCal_Field(EventData, "DTEND"));
+    for (size_t i = 0; i < Length; i++) {
+        CalDAV_Event_Index_Entry_t *p_Entry = &p_Index->p_Entries[p_Index->Length];
 
-            CurrentEvent++;
-            CUSTOM_FREE(EventData);
+        if (p_Events[i].StartTime == NULL) {
+            continue;
+        }
 
-            SearchPos = EventEnd + 10;
+        p_Entry->Start = p_Events[i].Start;
+        p_Entry->End = (p_Events[i].End > p_Events[i].Start) ? p_Events[i].End : p_Events[i].Start;
+        p_Entry->Event = (uint32_t)i;
+        p_Entry->Calendar = (p_Calendar != NULL) ? (uint16_t)p_Calendar[i] : 0;
+        p_Index->Length++;
     }
 
-    *Length = CurrentEvent;
-    CUSTOM_FREE(Response.Buffer);
+    qsort(p_Index->p_Entries, p_Index->Length, sizeof(CalDAV_Event_Index_Entry_t), _CalDAV_Event_Index_Compare);
+
+    /* The reach never decreases, so the first entry that can overlap a range is found with a binary search */
+    for (size_t i = 0; i < p_Index->Length; i++) {
+        CalDAV_Event_Index_Entry_t *p_Entry = &p_Index->p_Entries[i];
+
+        Reach = ((i == 0) || (p_Entry->End > Reach)) ? p_Entry->End : Reach;
+        p_Entry->Reach = Reach;
+    }
 
     return CALDAV_ERROR_OK;
 }
 
-void CalDAV_Calendars_Free(CalDAV_Calendar_List_t *p_Calendars)
+CalDAV_Error_t CalDAV_Event_Index_Find_Range(const CalDAV_Event_Index_t *p_Index,
+                                             time_t Start,
+                                             time_t End,
+                                             CalDAV_Event_Index_Entry_t *p_Entries,
+                                             size_t Max,
+                                             size_t *p_Count)
 {
-    if (p_Calendars == NULL) {
-        return;
+    size_t Low = 0;
+    size_t High;
+
+    if ((p_Index == NULL) || ((p_Entries == NULL) && (Max > 0)) || (p_Count == NULL)) {
+        return CALDAV_ERROR_INVALID_ARG;
     }
 
-    for (size_t i = 0; i < p_Calendars->Length; i++) {
-        if (p_Calendars->Calendar[i].Name) {
-            CUSTOM_FREE(p_Calendars->Calendar[i].Name);
-        }
+    *p_Count = 0;
 
-        if (p_Calendars->Calendar[i].Path) {
-            CUSTOM_FREE(p_Calendars->Calendar[i].Path);
-        }
+    High = p_Index->Length;
+    while (Low < High) {
+        size_t Middle = Low + ((High - Low) / 2);
 
-        if (p_Calendars->Calendar[i].DisplayName) {
-            CUSTOM_FREE(p_Calendars->Calendar[i].DisplayName);
+        if (p_Index->p_Entries[Middle].Reach < Start) {
+            Low = Middle + 1;
+        } else {
+            High = Middle;
         }
+    }
+
+    for (size_t i = Low; (i < p_Index->Length) && (*p_Count < Max); i++) {
+        const CalDAV_Event_Index_Entry_t *p_Entry = &p_Index->p_Entries[i];
 
-        if (p_Calendars->Calendar[i].Description) {
-            CUSTOM_FREE(p_Calendars->Calendar[i].Description);
+        if (p_Entry->Start >= End) {
+            break;
         }
 
-        if (p_Calendars->Calendar[i].Color) {
-            CUSTOM_FREE(p_Calendars->Calendar[i].Color);
+        if ((p_Entry->End > Start) || ((p_Entry->End == p_Entry->Start) && (p_Entry->Start >= Start))) {
+            p_Entries[(*p_Count)++] = *p_Entry;
         }
     }
 
-    CUSTOM_FREE(p_Calendars->Calendar);
+    return CALDAV_ERROR_OK;
 }
 
-void CalDAV_Events_Free(CalDAV_Calendar_Event_t *p_Events, size_t Length)
+CalDAV_Error_t CalDAV_Event_Index_Find_Next(const CalDAV_Event_Index_t *p_Index,
+                                            time_t Now,
+                                            CalDAV_Event_Index_Entry_t *p_Entries,
+                                            size_t Max,
+                                            size_t *p_Count)
+{
+    size_t First;
+
+    if ((p_Index == NULL) || ((p_Entries == NULL) && (Max > 0)) || (p_Count == NULL)) {
+        return CALDAV_ERROR_INVALID_ARG;
+    }
+
+    First = _CalDAV_Event_Index_Lower_Bound(p_Index, Now);
+    *p_Count = ((p_Index->Length - First) < Max) ? (p_Index->Length - First) : Max;
+
+    if (*p_Count > 0) {
+        memcpy(p_Entries, &p_Index->p_Entries[First], *p_Count * sizeof(CalDAV_Event_Index_Entry_t));
+    }
+
+    return CALDAV_ERROR_OK;
+}
+
+void CalDAV_Event_Index_Free(CalDAV_Event_Index_t *p_Index)
 {
-    if (p_Events == NULL) {
+    if (p_Index == NULL) {
         return;
     }
 
-    for (size_t i = 0; i < Length; i++) {
-        if (p_Events[i].UID) {
-            CUSTOM_FREE(p_Events[i].UID);
-        }
+    CUSTOM_FREE(p_Index->p_Entries);
+    p_Index->p_Entries = NULL;
+    p_Index->Length = 0;
+}
 
-        if (p_Events[i].Summary) {
-            CUSTOM_FREE(p_Events[i].Summary);
-        }
+/** @brief          Returns the FNV-1a hash of a string.
+ *  @param p_Name   String
+ *  @return         Hash
+ */
+static uint32_t _CalDAV_Calendar_Index_Hash(const char *p_Name)
+{
+    uint32_t Hash = 2166136261UL;
 
-        if (p_Events[i].Description) {
-            CUSTOM_FREE(p_Events[i].Description);
-        }
+    while (*p_Name != '\0') {
+        Hash ^= (uint8_t)*p_Name++;
+        Hash *= 16777619UL;
+    }
 
-        if (p_Events[i].StartTime) {
-            CUSTOM_FREE(p_Events[i].StartTime);
-        }
+    return Hash;
+}
+
+/** @brief          Checks if the name or the display name of a calendar matches a name.
+ *  @param p_Index  Calendar index
+ *  @param Calendar Index of the calendar
+ *  @param p_Name   Name
+ *  @return         true if the calendar has the name
+ */
+static bool _CalDAV_Calendar_Index_Matches(const CalDAV_Calendar_Index_t *p_Index, size_t Calendar, const char *p_Name)
+{
+    const CalDAV_Calendar_t *p_Calendar = &p_Index->p_Calendars->Calendar[Calendar];
+
+    return ((p_Calendar->Name != NULL) && (strcmp(p_Calendar->Name, p_Name) == 0)) ||
+           ((p_Calendar->DisplayName != NULL) && (strcmp(p_Calendar->DisplayName, p_Name) == 0));
+}
+
+/** @brief          Looks up a name in a calendar index.
+ *  @param p_Index  Calendar index
+ *  @param p_Name   Name
+ *  @param Hash     Hash of the name
+ *  @return         Slot with the name or the empty slot where the name belongs
+ */
+static CalDAV_Calendar_Index_Slot_t *_CalDAV_Calendar_Index_Lookup(const CalDAV_Calendar_Index_t *p_Index,
+                                                                   const char *p_Name, uint32_t Hash)
+{
+    size_t Slot = Hash & (p_Index->Size - 1);
 
-        if (p_Events[i].EndTime) {
-            CUSTOM_FREE(p_Events[i].EndTime);
+    /* Linear probing, the table is at most half full */
+    while (p_Index->p_Slots[Slot].Calendar != 0) {
+        const CalDAV_Calendar_Index_Slot_t *p_Slot = &p_Index->p_Slots[Slot];
+
+        if ((p_Slot->Hash == Hash) && _CalDAV_Calendar_Index_Matches(p_Index, p_Slot->Calendar - 1, p_Name)) {
+            break;
         }
 
-        if (p_Events[i].Location) {
-            CUSTOM_FREE(p_Events[i].Location);
+        Slot = (Slot + 1) & (p_Index->Size - 1);
+    }
+
+    return &p_Index->p_Slots[Slot];
+}
+
+CalDAV_Error_t CalDAV_Calendar_Index_Build(const CalDAV_Calendar_List_t *p_Calendars, CalDAV_Calendar_Index_t *p_Index)
+{
+    if ((p_Calendars == NULL) || (p_Index == NULL) || (p_Calendars->Length > UINT16_MAX)) {
+        return CALDAV_ERROR_INVALID_ARG;
+    }
+
+    memset(p_Index, 0, sizeof(CalDAV_Calendar_Index_t));
+    p_Index->p_Calendars = p_Calendars;
+
+    /* Two names per calendar */
+    p_Index->Size = 4;
+    while (p_Index->Size < (p_Calendars->Length * 4)) {
+        p_Index->Size *= 2;
+    }
+
+    p_Index->p_Slots = (CalDAV_Calendar_Index_Slot_t *)CUSTOM_MALLOC(p_Index->Size *
+                                                                      sizeof(CalDAV_Calendar_Index_Slot_t));
+    if (p_Index->p_Slots == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate calendar index!");
+
+        p_Index->Size = 0;
+
+        return CALDAV_ERROR_NO_MEM;
+    }
+
+    memset(p_Index->p_Slots, 0, p_Index->Size * sizeof(CalDAV_Calendar_Index_Slot_t));
+
+    for (size_t i = 0; i < p_Calendars->Length; i++) {
+        const char *p_Names[] = {p_Calendars->Calendar[i].Name, p_Calendars->Calendar[i].DisplayName};
+
+        for (size_t j = 0; j < 2; j++) {
+            CalDAV_Calendar_Index_Slot_t *p_Slot;
+            uint32_t Hash;
+
+            if (p_Names[j] == NULL) {
+                continue;
+            }
+
+            /* A name that is already used keeps the first calendar, like CalDAV_Calendar_Find_By_Name */
+            Hash = _CalDAV_Calendar_Index_Hash(p_Names[j]);
+            p_Slot = _CalDAV_Calendar_Index_Lookup(p_Index, p_Names[j], Hash);
+            if (p_Slot->Calendar == 0) {
+                p_Slot->Hash = Hash;
+                p_Slot->Calendar = (uint16_t)(i + 1);
+            }
         }
     }
 
-    CUSTOM_FREE(p_Events);
+    return CALDAV_ERROR_OK;
+}
+
+CalDAV_Error_t CalDAV_Calendar_Index_Find(const CalDAV_Calendar_Index_t *p_Index,
+                                          const char *p_Name,
+                                          CalDAV_Calendar_t **pp_Calendar)
+{
+    const CalDAV_Calendar_Index_Slot_t *p_Slot;
+
+    if ((p_Index == NULL) || (p_Name == NULL) || (pp_Calendar == NULL)) {
+        return CALDAV_ERROR_INVALID_ARG;
+    }
+
+    *pp_Calendar = NULL;
+
+    if (p_Index->p_Slots == NULL) {
+        return CALDAV_ERROR_NOT_FOUND;
+    }
+
+    p_Slot = _CalDAV_Calendar_Index_Lookup(p_Index, p_Name, _CalDAV_Calendar_Index_Hash(p_Name));
+    if (p_Slot->Calendar == 0) {
+        return CALDAV_ERROR_NOT_FOUND;
+    }
+
+    *pp_Calendar = &p_Index->p_Calendars->Calendar[p_Slot->Calendar - 1];
+
+    return CALDAV_ERROR_OK;
+}
+
+void CalDAV_Calendar_Index_Free(CalDAV_Calendar_Index_t *p_Index)
+{
+    if (p_Index == NULL) {
+        return;
+    }
+
+    CUSTOM_FREE(p_Index->p_Slots);
+    p_Index->p_Slots = NULL;
+    p_Index->Size = 0;
+}
+
+void CalDAV_Calendars_Free(CalDAV_Calendar_List_t *p_Calendars)
+{
+    if (p_Calendars == NULL) {
+        return;
+    }
+
+    _CalDAV_Arena_Free(p_Calendars->Calendar);
+
+    p_Calendars->Calendar = NULL;
+    p_Calendars->Length = 0;
+}
+
+void CalDAV_Event_List_Free(CalDAV_Event_List_t *p_List)
+{
+    if (p_List == NULL) {
+        return;
+    }
+
+    _CalDAV_Arena_Free(p_List->Events);
+    CUSTOM_FREE(p_List->Calendar);
+
+    memset(p_List, 0, sizeof(CalDAV_Event_List_t));
+}
+
+void CalDAV_Events_Free(CalDAV_Calendar_Event_t *p_Events, size_t Length)
+{
+    (void)Length;
+
+    _CalDAV_Arena_Free(p_Events);
 }
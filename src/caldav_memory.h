@@ -0,0 +1,101 @@
+/*
+ * caldav_memory.h
+ *
+ *  Copyright (C) Daniel Kampert, 2026
+ *  Website: www.kampis-elektroecke.de
+ *  File info: Heap placement of the CalDAV library.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#ifndef ESP32_CALDAV_MEMORY_H_
+#define ESP32_CALDAV_MEMORY_H_
+
+#include <esp_heap_caps.h>
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#if CONFIG_ESP32_CALDAV_STATS
+#include <atomic>
+
+/* The heap is shared by all clients, so the allocations are counted for the whole library */
+extern std::atomic<uint32_t> _CalDAV_Allocations;
+extern std::atomic<uint32_t> _CalDAV_Reallocations;
+
+    #define CALDAV_STATS_COUNT(Counter)     (void)((Counter)++)
+#else
+    #define CALDAV_STATS_COUNT(Counter)     (void)0
+#endif
+
+/* CUSTOM_MALLOC / CUSTOM_REALLOC allocate result sets and other data that is read often (arrays, strings,
+ * indices). CUSTOM_BUFFER_MALLOC / CUSTOM_BUFFER_REALLOC allocate the large transient I/O buffers (response
+ * bodies, parser buffers, request bodies, inflater). Both can be freed with CUSTOM_FREE.
+ */
+#if CONFIG_ESP32_CALDAV_USE_PSRAM
+#if CONFIG_ESP32_CALDAV_PSRAM_RESULTS
+    #define CALDAV_RESULT_CAPS              (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+#else
+    #define CALDAV_RESULT_CAPS              (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+#endif
+
+#if CONFIG_ESP32_CALDAV_PSRAM_BUFFERS
+    #define CALDAV_BUFFER_CAPS              (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+#else
+    #define CALDAV_BUFFER_CAPS              (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+#endif
+
+    #define CUSTOM_MALLOC(ptr)              (CALDAV_STATS_COUNT(_CalDAV_Allocations), \
+                                             heap_caps_malloc(ptr, CALDAV_RESULT_CAPS))
+    #define CUSTOM_FREE(ptr)                heap_caps_free(ptr)
+    #define CUSTOM_REALLOC(ptr, NewSize)    (CALDAV_STATS_COUNT(_CalDAV_Reallocations), \
+                                             heap_caps_realloc(ptr, NewSize, CALDAV_RESULT_CAPS))
+    #define CUSTOM_BUFFER_MALLOC(ptr)       (CALDAV_STATS_COUNT(_CalDAV_Allocations), \
+                                             heap_caps_malloc(ptr, CALDAV_BUFFER_CAPS))
+    #define CUSTOM_BUFFER_REALLOC(ptr, NewSize) (CALDAV_STATS_COUNT(_CalDAV_Reallocations), \
+                                                 heap_caps_realloc(ptr, NewSize, CALDAV_BUFFER_CAPS))
+#else
+    #define CUSTOM_MALLOC(ptr)              (CALDAV_STATS_COUNT(_CalDAV_Allocations), malloc(ptr))
+    #define CUSTOM_FREE(ptr)                free(ptr)
+    #define CUSTOM_REALLOC(ptr, NewSize)    (CALDAV_STATS_COUNT(_CalDAV_Reallocations), realloc(ptr, NewSize))
+    #define CUSTOM_BUFFER_MALLOC(ptr)       CUSTOM_MALLOC(ptr)
+    #define CUSTOM_BUFFER_REALLOC(ptr, NewSize) CUSTOM_REALLOC(ptr, NewSize)
+#endif
+
+/** @brief      Helper function to copy a parsed string.
+ *  @param str  The string to copy (may be NULL)
+ *  @return     Allocated char* or NULL if string is NULL
+ */
+static inline char *_CalDAV_String_Duplicate(const char *str)
+{
+    char *p_Copy;
+    size_t Length;
+
+    if (str == NULL) {
+        return NULL;
+    }
+
+    Length = strlen(str) + 1;
+    p_Copy = (char *)CUSTOM_MALLOC(Length);
+    if (p_Copy != NULL) {
+        memcpy(p_Copy, str, Length);
+    }
+
+    return p_Copy;
+}
+
+#endif /* ESP32_CALDAV_MEMORY_H_ */
@@ -0,0 +1,2380 @@
+/*
+ * caldav_parser.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2026
+ *  Website: www.kampis-elektroecke.de
+ *  File info: Streaming parser for CalDAV multistatus responses.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#include <esp_log.h>
+
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+#include "caldav_parser.h"
+
+/** @brief Marker for a field that was not found in the response.
+ */
+#define CALDAV_PARSER_NO_FIELD              ((size_t) - 1)
+
+/** @brief Time values found in a VEVENT.
+ */
+#define CALDAV_PARSER_TIME_START            (1 << 0)
+#define CALDAV_PARSER_TIME_END              (1 << 1)
+#define CALDAV_PARSER_TIME_DURATION         (1 << 2)
+
+/** @brief Seconds of a day.
+ */
+#define CALDAV_PARSER_DAY                   86400
+
+/** @brief Longest number of a DURATION value and longest duration in seconds (999999999 weeks), so the sum of the
+ *         components never overflows.
+ */
+#define CALDAV_PARSER_DURATION_DIGITS       9
+#define CALDAV_PARSER_MAX_DURATION          ((int64_t)999999999 * 7 * CALDAV_PARSER_DAY)
+
+/** @brief States of the XML tokenizer.
+ */
+typedef enum {
+    PARSER_STATE_TEXT = 0,          /**< Character data. */
+    PARSER_STATE_ENTITY,            /**< Entity reference in character data. */
+    PARSER_STATE_TAG_START,         /**< Directly after '<'. */
+    PARSER_STATE_TAG_NAME,          /**< Tag name. */
+    PARSER_STATE_TAG_ATTRIBUTES,    /**< Attributes of a tag. */
+    PARSER_STATE_DECLARATION,       /**< Directly after "<!". */
+    PARSER_STATE_COMMENT,           /**< Comment. */
+    PARSER_STATE_CDATA,             /**< CDATA section. */
+    PARSER_STATE_SKIP,              /**< Processing instruction or DOCTYPE. */
+    PARSER_STATE_ICALENDAR,         /**< Plain iCalendar body without XML (CalDAV_Parser_iCalendar_Begin). */
+} Parser_State_t;
+
+/** @brief XML elements the parser is interested in. The namespace prefix is ignored.
+ */
+typedef enum {
+    PARSER_ELEMENT_OTHER = 0,
+    PARSER_ELEMENT_MULTISTATUS,
+    PARSER_ELEMENT_RESPONSE,
+    PARSER_ELEMENT_HREF,
+    PARSER_ELEMENT_PROP,
+    PARSER_ELEMENT_RESOURCETYPE,
+    PARSER_ELEMENT_CALENDAR,
+    PARSER_ELEMENT_PRINCIPAL,
+    PARSER_ELEMENT_DISPLAYNAME,
+    PARSER_ELEMENT_CALENDAR_DESCRIPTION,
+    PARSER_ELEMENT_CALENDAR_DATA,
+    PARSER_ELEMENT_GETCTAG,
+    PARSER_ELEMENT_SYNC_TOKEN,
+    PARSER_ELEMENT_GETETAG,
+    PARSER_ELEMENT_STATUS,
+    PARSER_ELEMENT_CURRENT_USER_PRINCIPAL,
+    PARSER_ELEMENT_CALENDAR_HOME_SET,
+} Parser_Element_t;
+
+/** @brief Components of a time zone definition.
+ */
+typedef enum {
+    PARSER_TIMEZONE_NONE = 0,       /**< Outside of a VTIMEZONE. */
+    PARSER_TIMEZONE_DEFINITION,     /**< Properties of the VTIMEZONE itself. */
+    PARSER_TIMEZONE_STANDARD,       /**< STANDARD observance. */
+    PARSER_TIMEZONE_DAYLIGHT,       /**< DAYLIGHT observance. */
+} Parser_Timezone_State_t;
+
+/** @brief Frequencies of a recurrence rule.
+ */
+typedef enum {
+    PARSER_FREQUENCY_NONE = 0,      /**< No recurrence rule. */
+    PARSER_FREQUENCY_DAILY,         /**< FREQ=DAILY. */
+    PARSER_FREQUENCY_WEEKLY,        /**< FREQ=WEEKLY. */
+    PARSER_FREQUENCY_MONTHLY,       /**< FREQ=MONTHLY. */
+    PARSER_FREQUENCY_YEARLY,        /**< FREQ=YEARLY. */
+} Parser_Frequency_t;
+
+/** @brief Mapping between an XML element name and the element ID.
+ */
+typedef struct {
+    const char *Name;
+    Parser_Element_t Element;
+} Parser_Element_Name_t;
+
+/** @brief Mapping between an iCalendar property name and the event field.
+ */
+typedef struct {
+    const char *Name;
+    CalDAV_Parser_Event_Field_t Field;
+    bool IsText;                    /**< Value type is TEXT and uses backslash escapes. */
+} Parser_Property_Name_t;
+
+/** @brief Resolved DATE or DATE-TIME value.
+ */
+typedef struct {
+    int64_t Local;                  /**< Time as written in seconds since 1970. */
+    int64_t UTC;                    /**< Time in seconds since 1970 (UTC). */
+    int32_t Offset;                 /**< UTC offset in seconds. */
+    int8_t Zone;                    /**< Time zone definition or -1. */
+    bool IsDate;                    /**< The value is a date. */
+} Parser_Time_t;
+
+static const Parser_Element_Name_t _Parser_Elements[] = {
+    {"multistatus", PARSER_ELEMENT_MULTISTATUS},
+    {"response", PARSER_ELEMENT_RESPONSE},
+    {"href", PARSER_ELEMENT_HREF},
+    {"prop", PARSER_ELEMENT_PROP},
+    {"resourcetype", PARSER_ELEMENT_RESOURCETYPE},
+    {"calendar", PARSER_ELEMENT_CALENDAR},
+    {"principal", PARSER_ELEMENT_PRINCIPAL},
+    {"displayname", PARSER_ELEMENT_DISPLAYNAME},
+    {"calendar-description", PARSER_ELEMENT_CALENDAR_DESCRIPTION},
+    {"calendar-data", PARSER_ELEMENT_CALENDAR_DATA},
+    {"getctag", PARSER_ELEMENT_GETCTAG},
+    {"sync-token", PARSER_ELEMENT_SYNC_TOKEN},
+    {"getetag", PARSER_ELEMENT_GETETAG},
+    {"status", PARSER_ELEMENT_STATUS},
+    {"current-user-principal", PARSER_ELEMENT_CURRENT_USER_PRINCIPAL},
+    {"calendar-home-set", PARSER_ELEMENT_CALENDAR_HOME_SET},
+};
+
+static const Parser_Property_Name_t _Parser_Properties[] = {
+    {"UID", CALDAV_PARSER_EVENT_UID, false},
+    {"SUMMARY", CALDAV_PARSER_EVENT_SUMMARY, true},
+    {"DESCRIPTION", CALDAV_PARSER_EVENT_DESCRIPTION, true},
+    {"LOCATION", CALDAV_PARSER_EVENT_LOCATION, true},
+    {"DTSTART", CALDAV_PARSER_EVENT_DTSTART, false},
+    {"DTEND", CALDAV_PARSER_EVENT_DTEND, false},
+};
+
+static const char *TAG = "CalDAV-Parser";
+
+/** @brief      Checks if a character is XML whitespace.
+ *  @param c    Character
+ *  @return     true if the character is whitespace
+ */
+static inline bool _CalDAV_Parser_Is_Space(char c)
+{
+    return (c == ' ') || (c == '\t') || (c == '\r') || (c == '\n');
+}
+
+/** @brief          Compares a non terminated string with a name (case insensitive).
+ *  @param p_Data   String to compare
+ *  @param Length   Length of the string
+ *  @param p_Name   Name to compare with
+ *  @return         true if both are equal
+ */
+static inline bool _CalDAV_Parser_Equals(const char *p_Data, size_t Length, const char *p_Name)
+{
+    return (strlen(p_Name) == Length) && (strncasecmp(p_Data, p_Name, Length) == 0);
+}
+
+/** @brief          Appends a character to the working buffer. One byte is always kept free for the terminator.
+ *                  In place the write position never passes the read position, so no reserve is needed.
+ *  @param p_Parser Parser
+ *  @param c        Character to append
+ *  @param Reserve  Number of bytes at the end of the buffer that must stay free
+ *  @return         false if the working buffer is full
+ */
+static inline bool _CalDAV_Parser_Put(CalDAV_Parser_t *p_Parser, char c, size_t Reserve)
+{
+    if (p_Parser->IsInPlace) {
+        Reserve = 0;
+    }
+
+    if ((p_Parser->Position + 1 + Reserve) >= p_Parser->Size) {
+        if (p_Parser->IsTruncated == false) {
+            ESP_LOGD(TAG, "Working buffer full, value truncated!");
+        }
+
+        p_Parser->IsTruncated = true;
+
+        return false;
+    }
+
+    p_Parser->Buffer[p_Parser->Position++] = c;
+
+    return true;
+}
+
+/** @brief          Returns a pointer to a field value or NULL if the field is not set.
+ *  @param p_Parser Parser
+ *  @param Offset   Offset of the field in the working buffer
+ *  @return         Pointer to the value or NULL
+ */
+static inline const char *_CalDAV_Parser_Field(const CalDAV_Parser_t *p_Parser, size_t Offset)
+{
+    return (Offset == CALDAV_PARSER_NO_FIELD) ? NULL : (p_Parser->Buffer + Offset);
+}
+
+/** @brief          Copies a TEXT value and resolves the backslash escapes of RFC 5545 (3.3.11).
+ *  @param p_Target Target (may overlap with the source, the result is never longer)
+ *  @param p_Value  Escaped value
+ *  @param Length   Length of the escaped value
+ *  @return         Length of the unescaped value
+ */
+static size_t _CalDAV_Parser_iCal_Unescape(char *p_Target, const char *p_Value, size_t Length)
+{
+    size_t Result = 0;
+
+    for (size_t i = 0; i < Length; i++) {
+        char c = p_Value[i];
+
+        if ((c == '\\') && ((i + 1) < Length)) {
+            c = p_Value[++i];
+            if ((c == 'n') || (c == 'N')) {
+                c = '\n';
+            }
+        }
+
+        p_Target[Result++] = c;
+    }
+
+    return Result;
+}
+
+/** @brief          Reads a fixed number of decimal digits.
+ *  @param p_Data   Digits
+ *  @param Count    Number of digits
+ *  @param p_Value  Pointer to store the value
+ *  @return         false if a character is not a digit
+ */
+static bool _CalDAV_Parser_Digits(const char *p_Data, size_t Count, int *p_Value)
+{
+    *p_Value = 0;
+
+    for (size_t i = 0; i < Count; i++) {
+        if ((p_Data[i] < '0') || (p_Data[i] > '9')) {
+            return false;
+        }
+
+        *p_Value = (*p_Value * 10) + (p_Data[i] - '0');
+    }
+
+    return true;
+}
+
+/** @brief          Returns the number of days between 1970-01-01 and a date of the proleptic Gregorian calendar.
+ *  @param Year     Year
+ *  @param Month    Month (1 - 12)
+ *  @param Day      Day of the month (1 - 31)
+ *  @return         Days since 1970-01-01
+ */
+static int64_t _CalDAV_Parser_Days(int Year, int Month, int Day)
+{
+    int64_t Era;
+    int64_t YearOfEra;
+    int64_t DayOfYear;
+
+    /* Years start in March, so the leap day is the last day of the year */
+    Year -= (Month <= 2) ? 1 : 0;
+    Era = ((Year >= 0) ? Year : (Year - 399)) / 400;
+    YearOfEra = Year - (Era * 400);
+    DayOfYear = (((153 * ((Month > 2) ? (Month - 3) : (Month + 9))) + 2) / 5) + Day - 1;
+
+    return (Era * 146097) + (YearOfEra * 365) + (YearOfEra / 4) - (YearOfEra / 100) + DayOfYear - 719468;
+}
+
+/** @brief          Returns the date of a day.
+ *  @param Days     Days since 1970-01-01
+ *  @param p_Year   Pointer to store the year
+ *  @param p_Month  Pointer to store the month (1 - 12)
+ *  @param p_Day    Pointer to store the day of the month (1 - 31)
+ */
+static void _CalDAV_Parser_Date(int64_t Days, int *p_Year, int *p_Month, int *p_Day)
+{
+    int64_t Era;
+    int64_t DayOfEra;
+    int64_t YearOfEra;
+    int64_t DayOfYear;
+    int64_t MonthOfYear;
+
+    Days += 719468;
+    Era = ((Days >= 0) ? Days : (Days - 146096)) / 146097;
+    DayOfEra = Days - (Era * 146097);
+    YearOfEra = (DayOfEra - (DayOfEra / 1460) + (DayOfEra / 36524) - (DayOfEra / 146096)) / 365;
+    DayOfYear = DayOfEra - ((365 * YearOfEra) + (YearOfEra / 4) - (YearOfEra / 100));
+    MonthOfYear = ((5 * DayOfYear) + 2) / 153;
+
+    /* Years start in March, January and February belong to the next year */
+    *p_Day = (int)(DayOfYear - (((153 * MonthOfYear) + 2) / 5) + 1);
+    *p_Month = (int)((MonthOfYear < 10) ? (MonthOfYear + 3) : (MonthOfYear - 9));
+    *p_Year = (int)(YearOfEra + (Era * 400) + ((*p_Month <= 2) ? 1 : 0));
+}
+
+/** @brief          Returns the day of a point in time.
+ *  @param Seconds  Seconds since 1970
+ *  @return         Days since 1970-01-01
+ */
+static int64_t _CalDAV_Parser_Day(int64_t Seconds)
+{
+    return ((Seconds >= 0) ? Seconds : (Seconds - (CALDAV_PARSER_DAY - 1))) / CALDAV_PARSER_DAY;
+}
+
+/** @brief          Returns the year of a point in time.
+ *  @param Seconds  Seconds since 1970
+ *  @return         Year
+ */
+static int _CalDAV_Parser_Year(int64_t Seconds)
+{
+    int Year;
+    int Month;
+    int Day;
+
+    _CalDAV_Parser_Date(_CalDAV_Parser_Day(Seconds), &Year, &Month, &Day);
+
+    return Year;
+}
+
+/** @brief          Returns the weekday of a day.
+ *  @param Days     Days since 1970-01-01
+ *  @return         Weekday (0 = Sunday)
+ */
+static int _CalDAV_Parser_Weekday(int64_t Days)
+{
+    /* 1970-01-01 was a Thursday */
+    int64_t Weekday = (Days + 4) % 7;
+
+    return (int)((Weekday < 0) ? (Weekday + 7) : Weekday);
+}
+
+/** @brief              Parses an iCalendar DATE (YYYYMMDD) or DATE-TIME (YYYYMMDDTHHMMSS[Z]) value.
+ *  @param p_Value      Value
+ *  @param Length       Length of the value
+ *  @param p_Seconds    Pointer to store the time as written in seconds since 1970
+ *  @param p_IsDate     Pointer to store if the value is a DATE
+ *  @param p_IsUTC      Pointer to store if the value is in UTC
+ *  @return             false if the value is not a date or date-time
+ */
+static bool _CalDAV_Parser_Date_Time(const char *p_Value, size_t Length, int64_t *p_Seconds, bool *p_IsDate,
+                                     bool *p_IsUTC)
+{
+    int Year;
+    int Month;
+    int Day;
+    int Hour = 0;
+    int Minute = 0;
+    int Second = 0;
+
+    if ((Length < 8) || (_CalDAV_Parser_Digits(p_Value, 4, &Year) == false) ||
+        (_CalDAV_Parser_Digits(p_Value + 4, 2, &Month) == false) ||
+        (_CalDAV_Parser_Digits(p_Value + 6, 2, &Day) == false) || (Month < 1) || (Month > 12) || (Day < 1) ||
+        (Day > 31)) {
+        return false;
+    }
+
+    *p_IsDate = (Length == 8);
+    *p_IsUTC = false;
+
+    if (*p_IsDate == false) {
+        if ((Length < 15) || ((p_Value[8] != 'T') && (p_Value[8] != 't')) ||
+            (_CalDAV_Parser_Digits(p_Value + 9, 2, &Hour) == false) ||
+            (_CalDAV_Parser_Digits(p_Value + 11, 2, &Minute) == false) ||
+            (_CalDAV_Parser_Digits(p_Value + 13, 2, &Second) == false)) {
+            return false;
+        }
+
+        *p_IsUTC = (Length > 15) && ((p_Value[15] == 'Z') || (p_Value[15] == 'z'));
+    }
+
+    *p_Seconds = (_CalDAV_Parser_Days(Year, Month, Day) * CALDAV_PARSER_DAY) + (Hour * 3600) + (Minute * 60) + Second;
+
+    return true;
+}
+
+/** @brief              Parses an iCalendar DURATION value (e.g. "PT1H30M" or "-P1D").
+ *  @param p_Value      Value
+ *  @param Length       Length of the value
+ *  @param p_Seconds    Pointer to store the duration in seconds
+ *  @return             false if the value is not a duration or out of range
+ */
+static bool _CalDAV_Parser_Duration(const char *p_Value, size_t Length, int64_t *p_Seconds)
+{
+    int64_t Result = 0;
+    int64_t Number = 0;
+    size_t Digits = 0;
+    bool IsNegative = false;
+    size_t i = 0;
+
+    if ((i < Length) && ((p_Value[i] == '+') || (p_Value[i] == '-'))) {
+        IsNegative = (p_Value[i++] == '-');
+    }
+
+    if ((i >= Length) || ((p_Value[i] != 'P') && (p_Value[i] != 'p'))) {
+        return false;
+    }
+
+    for (i++; i < Length; i++) {
+        char c = toupper((unsigned char)p_Value[i]);
+
+        if ((c >= '0') && (c <= '9')) {
+            if (++Digits > CALDAV_PARSER_DURATION_DIGITS) {
+                return false;
+            }
+
+            Number = (Number * 10) + (c - '0');
+
+            continue;
+        }
+
+        switch (c) {
+            case 'W': {
+                Result += Number * 7 * CALDAV_PARSER_DAY;
+                break;
+            }
+            case 'D': {
+                Result += Number * CALDAV_PARSER_DAY;
+                break;
+            }
+            case 'H': {
+                Result += Number * 3600;
+                break;
+            }
+            case 'M': {
+                Result += Number * 60;
+                break;
+            }
+            case 'S': {
+                Result += Number;
+                break;
+            }
+            case 'T': {
+                break;
+            }
+            default: {
+                return false;
+            }
+        }
+
+        if (Result > CALDAV_PARSER_MAX_DURATION) {
+            return false;
+        }
+
+        Number = 0;
+        Digits = 0;
+    }
+
+    *p_Seconds = IsNegative ? -Result : Result;
+
+    return true;
+}
+
+/** @brief              Parses an iCalendar UTC-OFFSET value (+HHMM or +HHMMSS).
+ *  @param p_Value      Value
+ *  @param Length       Length of the value
+ *  @param p_Offset     Pointer to store the offset in seconds
+ *  @return             false if the value is not an UTC offset
+ */
+static bool _CalDAV_Parser_UTC_Offset(const char *p_Value, size_t Length, int32_t *p_Offset)
+{
+    int Hours;
+    int Minutes;
+    int Seconds = 0;
+
+    if ((Length < 5) || ((p_Value[0] != '+') && (p_Value[0] != '-')) ||
+        (_CalDAV_Parser_Digits(p_Value + 1, 2, &Hours) == false) ||
+        (_CalDAV_Parser_Digits(p_Value + 3, 2, &Minutes) == false) ||
+        ((Length >= 7) && (_CalDAV_Parser_Digits(p_Value + 5, 2, &Seconds) == false))) {
+        return false;
+    }
+
+    *p_Offset = (Hours * 3600) + (Minutes * 60) + Seconds;
+    if (p_Value[0] == '-') {
+        *p_Offset = -*p_Offset;
+    }
+
+    return true;
+}
+
+/** @brief          Returns the weekday of a two letter weekday name (e.g. "MO").
+ *  @param p_Name   Weekday name
+ *  @param Length   Length of the name
+ *  @return         Weekday (0 = Sunday) or -1 if the name is unknown
+ */
+static int _CalDAV_Parser_Weekday_Name(const char *p_Name, size_t Length)
+{
+    static const char *Weekdays[] = {"SU", "MO", "TU", "WE", "TH", "FR", "SA"};
+
+    for (int i = 0; i < 7; i++) {
+        if (_CalDAV_Parser_Equals(p_Name, Length, Weekdays[i])) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/** @brief          Parses the BYDAY list of a recurrence rule (e.g. "MO,WE,FR" or "-1SU").
+ *  @param p_Rule   Recurrence rule
+ *  @param p_Value  List
+ *  @param Length   Length of the list
+ */
+static void _CalDAV_Parser_Rule_By_Day(CalDAV_Parser_Rule_t *p_Rule, const char *p_Value, size_t Length)
+{
+    size_t Start = 0;
+
+    while (Start < Length) {
+        size_t End = Start;
+        size_t Name = Start;
+        int Weekday;
+
+        while ((End < Length) && (p_Value[End] != ',')) {
+            End++;
+        }
+
+        while ((Name < End) && (isalpha((unsigned char)p_Value[Name]) == 0)) {
+            Name++;
+        }
+
+        Weekday = _CalDAV_Parser_Weekday_Name(p_Value + Name, End - Name);
+        if ((Weekday < 0) || (p_Rule->ByDayCount >= CALDAV_PARSER_MAX_BYDAY)) {
+            p_Rule->IsSupported = false;
+
+            return;
+        }
+
+        p_Rule->ByDayWeekday[p_Rule->ByDayCount] = (uint8_t)Weekday;
+        p_Rule->ByDayOrdinal[p_Rule->ByDayCount] = (int8_t)atoi(p_Value + Start);
+        p_Rule->ByDayCount++;
+
+        Start = End + 1;
+    }
+}
+
+/** @brief          Parses a recurrence rule (RRULE) of RFC 5545 (3.3.10).
+ *                  Rules with BYSETPOS, BYYEARDAY, BYWEEKNO, time based parts or frequencies below a day are
+ *                  marked as not supported.
+ *  @param p_Rule   Pointer to store the rule
+ *  @param p_Value  Value of the RRULE
+ *  @param Length   Length of the value
+ */
+static void _CalDAV_Parser_Rule(CalDAV_Parser_Rule_t *p_Rule, const char *p_Value, size_t Length)
+{
+    static const char *Frequencies[] = {"DAILY", "WEEKLY", "MONTHLY", "YEARLY"};
+    size_t Start = 0;
+
+    memset(p_Rule, 0, sizeof(CalDAV_Parser_Rule_t));
+    p_Rule->IsSupported = true;
+    p_Rule->Interval = 1;
+    p_Rule->WeekStart = 1;
+
+    while (Start < Length) {
+        size_t End = Start;
+        size_t Equals;
+        const char *p_Name = p_Value + Start;
+        const char *p_PartValue;
+        size_t NameLength;
+        size_t PartLength;
+
+        while ((End < Length) && (p_Value[End] != ';')) {
+            End++;
+        }
+
+        for (Equals = Start; (Equals < End) && (p_Value[Equals] != '='); Equals++) {
+        }
+
+        /* A part without a value must not point behind the end of the line */
+        NameLength = Equals - Start;
+        p_PartValue = (Equals < End) ? (p_Value + Equals + 1) : (p_Value + End);
+        PartLength = (Equals < End) ? (End - Equals - 1) : 0;
+
+        if (_CalDAV_Parser_Equals(p_Name, NameLength, "FREQ")) {
+            for (size_t i = 0; i < (sizeof(Frequencies) / sizeof(Frequencies[0])); i++) {
+                if (_CalDAV_Parser_Equals(p_PartValue, PartLength, Frequencies[i])) {
+                    p_Rule->Frequency = (uint8_t)(PARSER_FREQUENCY_DAILY + i);
+                }
+            }
+        } else if (_CalDAV_Parser_Equals(p_Name, NameLength, "INTERVAL")) {
+            int Interval = atoi(p_PartValue);
+
+            p_Rule->Interval = (Interval > 0) ? (uint16_t)Interval : 1;
+        } else if (_CalDAV_Parser_Equals(p_Name, NameLength, "COUNT")) {
+            p_Rule->Count = (uint32_t)strtoul(p_PartValue, NULL, 10);
+        } else if (_CalDAV_Parser_Equals(p_Name, NameLength, "UNTIL")) {
+            bool IsDate;
+
+            p_Rule->HasUntil = _CalDAV_Parser_Date_Time(p_PartValue, PartLength, &p_Rule->Until, &IsDate,
+                                                        &p_Rule->IsUntilUTC);
+
+            /* A date includes the whole day */
+            if (p_Rule->HasUntil && IsDate) {
+                p_Rule->Until += CALDAV_PARSER_DAY - 1;
+            }
+        } else if (_CalDAV_Parser_Equals(p_Name, NameLength, "WKST")) {
+            int Weekday = _CalDAV_Parser_Weekday_Name(p_PartValue, PartLength);
+
+            p_Rule->WeekStart = (Weekday >= 0) ? (uint8_t)Weekday : 1;
+        } else if (_CalDAV_Parser_Equals(p_Name, NameLength, "BYMONTH") ||
+                   _CalDAV_Parser_Equals(p_Name, NameLength, "BYMONTHDAY")) {
+            bool IsMonth = (NameLength == 7);
+
+            for (size_t i = 0; i < PartLength; i++) {
+                if ((i == 0) || (p_PartValue[i - 1] == ',')) {
+                    int Number = atoi(p_PartValue + i);
+
+                    if (IsMonth && (Number >= 1) && (Number <= 12)) {
+                        p_Rule->ByMonth |= (uint16_t)(1 << Number);
+                    } else if ((IsMonth == false) && (Number >= 1) && (Number <= 31)) {
+                        p_Rule->ByMonthDay |= (uint32_t)1 << Number;
+                    } else if ((IsMonth == false) && (Number <= -1) && (Number >= -31)) {
+                        p_Rule->ByMonthDayEnd |= (uint32_t)1 << -Number;
+                    }
+                }
+            }
+        } else if (_CalDAV_Parser_Equals(p_Name, NameLength, "BYDAY")) {
+            _CalDAV_Parser_Rule_By_Day(p_Rule, p_PartValue, PartLength);
+        } else if (NameLength > 0) {
+            p_Rule->IsSupported = false;
+        }
+
+        Start = End + 1;
+    }
+
+    if (p_Rule->Frequency == PARSER_FREQUENCY_NONE) {
+        p_Rule->IsSupported = false;
+    }
+}
+
+/** @brief              Reduces the yearly RRULE of an observance (e.g. "FREQ=YEARLY;BYMONTH=3;BYDAY=-1SU") to the
+ *                      month, the first possible day and the weekday of the onset. Other rules are ignored.
+ *  @param p_Observance Observance
+ *  @param p_Value      Value of the RRULE
+ *  @param Length       Length of the value
+ */
+static void _CalDAV_Parser_Observance_Rule(CalDAV_Parser_Observance_t *p_Observance, const char *p_Value,
+                                           size_t Length)
+{
+    CalDAV_Parser_Rule_t Rule;
+    int Month = 0;
+    int MonthDay = 0;
+
+    _CalDAV_Parser_Rule(&Rule, p_Value, Length);
+
+    /* The rule has ended, the observance only describes the past */
+    if (Rule.HasUntil) {
+        p_Observance->IsValid = false;
+
+        return;
+    }
+
+    for (int i = 12; i >= 1; i--) {
+        if (Rule.ByMonth & (1 << i)) {
+            Month = i;
+        }
+    }
+
+    /* Smallest day of the list, e.g. "8,9,10,11,12,13,14" for the second week */
+    for (int i = 31; i >= 1; i--) {
+        if (Rule.ByMonthDay & ((uint32_t)1 << i)) {
+            MonthDay = i;
+        }
+    }
+
+    if ((Rule.Frequency != PARSER_FREQUENCY_YEARLY) || (Month == 0) || (Rule.ByDayCount == 0)) {
+        return;
+    }
+
+    if (Rule.ByDayOrdinal[0] < 0) {
+        p_Observance->Day = Rule.ByDayOrdinal[0];
+    } else if (Rule.ByDayOrdinal[0] > 0) {
+        p_Observance->Day = (int8_t)(((Rule.ByDayOrdinal[0] - 1) * 7) + 1);
+    } else if (MonthDay > 0) {
+        p_Observance->Day = (int8_t)MonthDay;
+    } else {
+        return;
+    }
+
+    p_Observance->Month = (uint8_t)Month;
+    p_Observance->Weekday = Rule.ByDayWeekday[0];
+}
+
+/** @brief              Returns the local time of the yearly onset of an observance.
+ *  @param p_Observance Observance with a yearly rule
+ *  @param Year         Year
+ *  @return             Onset in local seconds since 1970
+ */
+static int64_t _CalDAV_Parser_Observance_Onset(const CalDAV_Parser_Observance_t *p_Observance, int Year)
+{
+    int64_t Days;
+
+    if (p_Observance->Day > 0) {
+        /* First matching weekday on or after the day */
+        Days = _CalDAV_Parser_Days(Year, p_Observance->Month, p_Observance->Day);
+        Days += (p_Observance->Weekday - _CalDAV_Parser_Weekday(Days) + 7) % 7;
+    } else {
+        /* Last matching weekday of the n-th last week */
+        if (p_Observance->Month == 12) {
+            Days = _CalDAV_Parser_Days(Year + 1, 1, 1) - 1;
+        } else {
+            Days = _CalDAV_Parser_Days(Year, p_Observance->Month + 1, 1) - 1;
+        }
+
+        Days += (p_Observance->Day + 1) * 7;
+        Days -= (_CalDAV_Parser_Weekday(Days) - p_Observance->Weekday + 7) % 7;
+    }
+
+    return (Days * CALDAV_PARSER_DAY) + p_Observance->Time;
+}
+
+/** @brief              Returns the UTC offset of a time zone at a local time.
+ *  @param p_Timezone   Time zone definition
+ *  @param Local        Local time in seconds since 1970
+ *  @return             UTC offset in seconds
+ */
+static int32_t _CalDAV_Parser_Timezone_Offset(const CalDAV_Parser_Timezone_t *p_Timezone, int64_t Local)
+{
+    const CalDAV_Parser_Observance_t *p_Standard = &p_Timezone->Standard;
+    const CalDAV_Parser_Observance_t *p_Daylight = &p_Timezone->Daylight;
+    int64_t StandardOnset;
+    int64_t DaylightOnset;
+    int Year;
+
+    if ((p_Standard->IsValid == false) || (p_Daylight->IsValid == false)) {
+        return p_Standard->IsValid ? p_Standard->Offset : p_Daylight->Offset;
+    }
+
+    /* Without yearly rules the observance that started last applies */
+    if ((p_Standard->Month == 0) || (p_Daylight->Month == 0)) {
+        if ((p_Daylight->Onset > p_Standard->Onset) ? (Local >= p_Daylight->Onset) : (Local < p_Standard->Onset)) {
+            return p_Daylight->Offset;
+        }
+
+        return p_Standard->Offset;
+    }
+
+    Year = _CalDAV_Parser_Year(Local);
+    StandardOnset = _CalDAV_Parser_Observance_Onset(p_Standard, Year);
+    DaylightOnset = _CalDAV_Parser_Observance_Onset(p_Daylight, Year);
+
+    /* On the southern hemisphere daylight saving time spans the turn of the year */
+    if (DaylightOnset < StandardOnset) {
+        return ((Local >= DaylightOnset) && (Local < StandardOnset)) ? p_Daylight->Offset : p_Standard->Offset;
+    }
+
+    return ((Local >= DaylightOnset) || (Local < StandardOnset)) ? p_Daylight->Offset : p_Standard->Offset;
+}
+
+/** @brief          Finds a time zone definition of the response.
+ *  @param p_Parser Parser
+ *  @param p_TZID   Time zone identifier
+ *  @param Length   Length of the identifier
+ *  @return         Time zone definition or NULL if the time zone is not defined
+ */
+static const CalDAV_Parser_Timezone_t *_CalDAV_Parser_Timezone_Find(const CalDAV_Parser_t *p_Parser,
+                                                                     const char *p_TZID, size_t Length)
+{
+    for (size_t i = 0; i < p_Parser->TimezoneCount; i++) {
+        if ((strlen(p_Parser->Timezones[i].TZID) == Length) &&
+            (strncmp(p_Parser->Timezones[i].TZID, p_TZID, Length) == 0)) {
+            return &p_Parser->Timezones[i];
+        }
+    }
+
+    return NULL;
+}
+
+/** @brief          Processes a BEGIN line inside a time zone definition.
+ *  @param p_Parser Parser
+ *  @param p_Value  Component name
+ *  @param Length   Length of the component name
+ */
+static void _CalDAV_Parser_Timezone_Begin(CalDAV_Parser_t *p_Parser, const char *p_Value, size_t Length)
+{
+    if ((p_Parser->TimezoneDepth == 0) && (p_Parser->TimezoneState == PARSER_TIMEZONE_DEFINITION)) {
+        if (_CalDAV_Parser_Equals(p_Value, Length, "STANDARD")) {
+            p_Parser->TimezoneState = PARSER_TIMEZONE_STANDARD;
+        } else if (_CalDAV_Parser_Equals(p_Value, Length, "DAYLIGHT")) {
+            p_Parser->TimezoneState = PARSER_TIMEZONE_DAYLIGHT;
+        }
+
+        if (p_Parser->TimezoneState != PARSER_TIMEZONE_DEFINITION) {
+            memset(&p_Parser->Observance, 0, sizeof(CalDAV_Parser_Observance_t));
+            p_Parser->Observance.IsValid = true;
+
+            return;
+        }
+    }
+
+    p_Parser->TimezoneDepth++;
+}
+
+/** @brief          Processes an END line inside a time zone definition. An observance replaces an older one of
+ *                  the same kind, a complete definition replaces an older definition of the same time zone.
+ *  @param p_Parser Parser
+ */
+static void _CalDAV_Parser_Timezone_End(CalDAV_Parser_t *p_Parser)
+{
+    CalDAV_Parser_Timezone_t *p_Target;
+
+    if (p_Parser->TimezoneDepth > 0) {
+        p_Parser->TimezoneDepth--;
+
+        return;
+    }
+
+    if (p_Parser->TimezoneState != PARSER_TIMEZONE_DEFINITION) {
+        CalDAV_Parser_Observance_t *p_Observance = (p_Parser->TimezoneState == PARSER_TIMEZONE_STANDARD) ?
+                                                   &p_Parser->Timezone.Standard : &p_Parser->Timezone.Daylight;
+
+        if (p_Parser->Observance.IsValid &&
+            ((p_Observance->IsValid == false) || (p_Parser->Observance.Onset >= p_Observance->Onset))) {
+            *p_Observance = p_Parser->Observance;
+        }
+
+        p_Parser->TimezoneState = PARSER_TIMEZONE_DEFINITION;
+
+        return;
+    }
+
+    p_Parser->TimezoneState = PARSER_TIMEZONE_NONE;
+
+    if (p_Parser->Timezone.TZID[0] == '\0') {
+        return;
+    }
+
+    p_Target = (CalDAV_Parser_Timezone_t *)_CalDAV_Parser_Timezone_Find(p_Parser, p_Parser->Timezone.TZID,
+                                                                        strlen(p_Parser->Timezone.TZID));
+    if (p_Target == NULL) {
+        if (p_Parser->TimezoneCount < CALDAV_PARSER_MAX_TIMEZONES) {
+            p_Target = &p_Parser->Timezones[p_Parser->TimezoneCount++];
+        } else {
+            p_Target = &p_Parser->Timezones[p_Parser->TimezoneNext];
+            p_Parser->TimezoneNext = (p_Parser->TimezoneNext + 1) % CALDAV_PARSER_MAX_TIMEZONES;
+        }
+    }
+
+    *p_Target = p_Parser->Timezone;
+}
+
+/** @brief              Processes a property of a time zone definition.
+ *  @param p_Parser     Parser
+ *  @param p_Name       Property name
+ *  @param NameLength   Length of the property name
+ *  @param p_Value      Property value
+ *  @param ValueLength  Length of the property value
+ */
+static void _CalDAV_Parser_Timezone_Property(CalDAV_Parser_t *p_Parser, const char *p_Name, size_t NameLength,
+                                             const char *p_Value, size_t ValueLength)
+{
+    CalDAV_Parser_Observance_t *p_Observance = &p_Parser->Observance;
+
+    if (p_Parser->TimezoneDepth > 0) {
+        return;
+    }
+
+    if (p_Parser->TimezoneState == PARSER_TIMEZONE_DEFINITION) {
+        if (_CalDAV_Parser_Equals(p_Name, NameLength, "TZID")) {
+            size_t Length = (ValueLength < (CALDAV_PARSER_MAX_TZID - 1)) ? ValueLength : (CALDAV_PARSER_MAX_TZID - 1);
+
+            memcpy(p_Parser->Timezone.TZID, p_Value, Length);
+            p_Parser->Timezone.TZID[Length] = '\0';
+        }
+    } else if (_CalDAV_Parser_Equals(p_Name, NameLength, "TZOFFSETTO")) {
+        if (_CalDAV_Parser_UTC_Offset(p_Value, ValueLength, &p_Observance->Offset) == false) {
+            p_Observance->IsValid = false;
+        }
+    } else if (_CalDAV_Parser_Equals(p_Name, NameLength, "DTSTART")) {
+        bool IsDate;
+        bool IsUTC;
+
+        if (_CalDAV_Parser_Date_Time(p_Value, ValueLength, &p_Observance->Onset, &IsDate, &IsUTC)) {
+            p_Observance->Time = (int32_t)(((p_Observance->Onset % CALDAV_PARSER_DAY) + CALDAV_PARSER_DAY) %
+                                           CALDAV_PARSER_DAY);
+        } else {
+            p_Observance->IsValid = false;
+        }
+    } else if (_CalDAV_Parser_Equals(p_Name, NameLength, "RRULE")) {
+        _CalDAV_Parser_Observance_Rule(p_Observance, p_Value, ValueLength);
+    }
+}
+
+/** @brief              Resolves a DATE or DATE-TIME value of a content line with its TZID parameter.
+ *                      Times with a TZID are resolved with the time zone definitions of the response, floating
+ *                      times and unknown time zones are taken as UTC.
+ *  @param p_Parser     Parser
+ *  @param p_Line       Content line
+ *  @param NameLength   Length of the property name
+ *  @param ValueStart   Position of the colon in front of the value, the parameters are in front of it
+ *  @param p_Value      Value to resolve
+ *  @param ValueLength  Length of the value
+ *  @param p_Time       Pointer to store the result
+ *  @return             false if the value is not a date or date-time
+ */
+static bool _CalDAV_Parser_Resolve_Time(const CalDAV_Parser_t *p_Parser, const char *p_Line, size_t NameLength,
+                                        size_t ValueStart, const char *p_Value, size_t ValueLength,
+                                        Parser_Time_t *p_Time)
+{
+    const char *p_TZID = NULL;
+    size_t TZIDLength = 0;
+    bool IsUTC;
+
+    p_Time->Offset = 0;
+    p_Time->Zone = -1;
+
+    if (_CalDAV_Parser_Date_Time(p_Value, ValueLength, &p_Time->Local, &p_Time->IsDate, &IsUTC) == false) {
+        return false;
+    }
+
+    p_Time->UTC = p_Time->Local;
+
+    /* TZID parameter, optionally quoted */
+    for (size_t i = NameLength; (i + 6) < ValueStart; i++) {
+        if ((p_Line[i] == ';') && (strncasecmp(p_Line + i + 1, "TZID=", 5) == 0)) {
+            p_TZID = p_Line + i + 6;
+            if (*p_TZID == '"') {
+                p_TZID++;
+            }
+
+            while (((p_TZID + TZIDLength) < (p_Line + ValueStart)) && (p_TZID[TZIDLength] != '"') &&
+                   (p_TZID[TZIDLength] != ';')) {
+                TZIDLength++;
+            }
+
+            break;
+        }
+    }
+
+    if ((p_Time->IsDate == false) && (IsUTC == false) && (p_TZID != NULL)) {
+        const CalDAV_Parser_Timezone_t *p_Timezone = _CalDAV_Parser_Timezone_Find(p_Parser, p_TZID, TZIDLength);
+
+        if (p_Timezone != NULL) {
+            p_Time->Zone = (int8_t)(p_Timezone - p_Parser->Timezones);
+            p_Time->Offset = _CalDAV_Parser_Timezone_Offset(p_Timezone, p_Time->Local);
+            p_Time->UTC = p_Time->Local - p_Time->Offset;
+        } else {
+            ESP_LOGD(TAG, "Unknown time zone '%.*s', time taken as UTC", (int)TZIDLength, p_TZID);
+        }
+    }
+
+    return true;
+}
+
+/** @brief          Adds an excluded instance of the recurring event of the current calendar object.
+ *  @param p_Parser Parser
+ *  @param Start    Start of the instance in seconds since 1970 (UTC)
+ */
+static void _CalDAV_Parser_Exception(CalDAV_Parser_t *p_Parser, int64_t Start)
+{
+    if (p_Parser->ExceptionCount >= CALDAV_PARSER_MAX_EXCEPTIONS) {
+        ESP_LOGD(TAG, "Too many excluded instances, instance kept!");
+
+        return;
+    }
+
+    p_Parser->Exceptions[p_Parser->ExceptionCount++] = Start;
+}
+
+/** @brief              Processes the time and recurrence properties of a VEVENT (DTSTART, DTEND, DURATION, RRULE,
+ *                      EXDATE and RECURRENCE-ID) while the parameters are still available.
+ *  @param p_Parser     Parser
+ *  @param p_Line       Content line
+ *  @param NameLength   Length of the property name
+ *  @param ValueStart   Position of the colon in front of the value
+ *  @param Length       Length of the content line
+ */
+static void _CalDAV_Parser_Event_Time(CalDAV_Parser_t *p_Parser, const char *p_Line, size_t NameLength,
+                                      size_t ValueStart, size_t Length)
+{
+    const char *p_Value = p_Line + ValueStart + 1;
+    size_t ValueLength = Length - ValueStart - 1;
+    Parser_Time_t Time;
+
+    if (_CalDAV_Parser_Equals(p_Line, NameLength, "DURATION")) {
+        if (((p_Parser->Times & CALDAV_PARSER_TIME_DURATION) == 0) &&
+            _CalDAV_Parser_Duration(p_Value, ValueLength, &p_Parser->Duration)) {
+            p_Parser->Times |= CALDAV_PARSER_TIME_DURATION;
+        }
+    } else if (_CalDAV_Parser_Equals(p_Line, NameLength, "RRULE")) {
+        if (p_Parser->Rule.Frequency == PARSER_FREQUENCY_NONE) {
+            _CalDAV_Parser_Rule(&p_Parser->Rule, p_Value, ValueLength);
+        }
+    } else if (_CalDAV_Parser_Equals(p_Line, NameLength, "EXDATE")) {
+        size_t Start = 0;
+
+        /* Comma separated list, all values use the parameters of the line */
+        while (Start < ValueLength) {
+            size_t End = Start;
+
+            while ((End < ValueLength) && (p_Value[End] != ',')) {
+                End++;
+            }
+
+            if (_CalDAV_Parser_Resolve_Time(p_Parser, p_Line, NameLength, ValueStart, p_Value + Start, End - Start,
+                                            &Time)) {
+                _CalDAV_Parser_Exception(p_Parser, Time.UTC);
+            }
+
+            Start = End + 1;
+        }
+    } else if (_CalDAV_Parser_Equals(p_Line, NameLength, "RECURRENCE-ID")) {
+        if (_CalDAV_Parser_Resolve_Time(p_Parser, p_Line, NameLength, ValueStart, p_Value, ValueLength, &Time)) {
+            p_Parser->IsRecurrence = true;
+            _CalDAV_Parser_Exception(p_Parser, Time.UTC);
+        }
+    } else if (_CalDAV_Parser_Equals(p_Line, NameLength, "DTSTART")) {
+        /* First occurrence wins */
+        if (((p_Parser->Times & CALDAV_PARSER_TIME_START) == 0) &&
+            _CalDAV_Parser_Resolve_Time(p_Parser, p_Line, NameLength, ValueStart, p_Value, ValueLength, &Time)) {
+            p_Parser->Start = Time.UTC;
+            p_Parser->Local = Time.Local;
+            p_Parser->Offset = Time.Offset;
+            p_Parser->Zone = Time.Zone;
+            p_Parser->IsAllDay = Time.IsDate;
+            p_Parser->Times |= CALDAV_PARSER_TIME_START;
+        }
+    } else if (_CalDAV_Parser_Equals(p_Line, NameLength, "DTEND")) {
+        if (((p_Parser->Times & CALDAV_PARSER_TIME_END) == 0) &&
+            _CalDAV_Parser_Resolve_Time(p_Parser, p_Line, NameLength, ValueStart, p_Value, ValueLength, &Time)) {
+            p_Parser->End = Time.UTC;
+            p_Parser->Times |= CALDAV_PARSER_TIME_END;
+        }
+    }
+}
+
+/** @brief              Processes a FREEBUSY property of a VFREEBUSY (RFC 5545 3.8.2.6) and passes each busy period
+ *                      to the period callback. The value is a comma separated list of periods, each either
+ *                      start/end or start/duration. Periods with FBTYPE=FREE are skipped, all other types are busy.
+ *  @param p_Parser     Parser
+ *  @param p_Line       Content line
+ *  @param NameLength   Length of the property name
+ *  @param ValueStart   Position of the colon in front of the value
+ *  @param Length       Length of the content line
+ */
+static void _CalDAV_Parser_Free_Busy(CalDAV_Parser_t *p_Parser, const char *p_Line, size_t NameLength,
+                                     size_t ValueStart, size_t Length)
+{
+    const char *p_Value = p_Line + ValueStart + 1;
+    size_t ValueLength = Length - ValueStart - 1;
+    size_t Start = 0;
+
+    if (_CalDAV_Parser_Equals(p_Line, NameLength, "FREEBUSY") == false) {
+        return;
+    }
+
+    for (size_t i = NameLength; (i + 12) <= ValueStart; i++) {
+        if ((p_Line[i] == ';') && (strncasecmp(p_Line + i + 1, "FBTYPE=FREE", 11) == 0) &&
+            ((p_Line[i + 12] == ';') || (p_Line[i + 12] == ':'))) {
+            return;
+        }
+    }
+
+    while ((Start < ValueLength) && (p_Parser->IsStopped == false)) {
+        size_t End = Start;
+        size_t Separator;
+        Parser_Time_t Time;
+        int64_t PeriodStart;
+        int64_t PeriodEnd;
+
+        while ((End < ValueLength) && (p_Value[End] != ',')) {
+            End++;
+        }
+
+        Separator = Start;
+        while ((Separator < End) && (p_Value[Separator] != '/')) {
+            Separator++;
+        }
+
+        if ((Separator < End) && _CalDAV_Parser_Resolve_Time(p_Parser, p_Line, NameLength, ValueStart,
+                                                             p_Value + Start, Separator - Start, &Time)) {
+            PeriodStart = Time.UTC;
+
+            if (_CalDAV_Parser_Duration(p_Value + Separator + 1, End - Separator - 1, &PeriodEnd)) {
+                PeriodEnd += PeriodStart;
+            } else if (_CalDAV_Parser_Resolve_Time(p_Parser, p_Line, NameLength, ValueStart, p_Value + Separator + 1,
+                                                   End - Separator - 1, &Time)) {
+                PeriodEnd = Time.UTC;
+            } else {
+                PeriodEnd = PeriodStart;
+            }
+
+            if ((PeriodEnd > PeriodStart) &&
+                (p_Parser->on_Period((time_t)PeriodStart, (time_t)PeriodEnd, p_Parser->p_Arg) == false)) {
+                p_Parser->IsStopped = true;
+            }
+        }
+
+        Start = End + 1;
+    }
+}
+
+/** @brief          Passes an event to the event callback.
+ *  @param p_Parser Parser
+ *  @param p_Fields Offsets of the event fields
+ *  @param Start    Start in seconds since 1970 (UTC)
+ *  @param End      End in seconds since 1970 (UTC)
+ *  @param Offset   UTC offset of the start in seconds
+ *  @param IsAllDay The event starts on a date
+ */
+static void _CalDAV_Parser_Emit_Event(CalDAV_Parser_t *p_Parser, const size_t *p_Fields, int64_t Start, int64_t End,
+                                      int32_t Offset, bool IsAllDay)
+{
+    CalDAV_Calendar_Event_t Event;
+
+    if (p_Parser->on_Event == NULL) {
+        return;
+    }
+
+    Event.UID = (char *)_CalDAV_Parser_Field(p_Parser, p_Fields[CALDAV_PARSER_EVENT_UID]);
+    Event.Summary = (char *)_CalDAV_Parser_Field(p_Parser, p_Fields[CALDAV_PARSER_EVENT_SUMMARY]);
+    Event.Description = (char *)_CalDAV_Parser_Field(p_Parser, p_Fields[CALDAV_PARSER_EVENT_DESCRIPTION]);
+    Event.StartTime = (char *)_CalDAV_Parser_Field(p_Parser, p_Fields[CALDAV_PARSER_EVENT_DTSTART]);
+    Event.EndTime = (char *)_CalDAV_Parser_Field(p_Parser, p_Fields[CALDAV_PARSER_EVENT_DTEND]);
+    Event.Location = (char *)_CalDAV_Parser_Field(p_Parser, p_Fields[CALDAV_PARSER_EVENT_LOCATION]);
+    Event.Start = (time_t)Start;
+    Event.End = (time_t)End;
+    Event.Offset = Offset;
+    Event.IsAllDay = IsAllDay;
+
+    if (p_Parser->on_Event(&Event, p_Parser->p_Arg) == false) {
+        p_Parser->IsStopped = true;
+    }
+}
+
+/** @brief          Checks if an instance overlaps the window (RFC 4791, 9.9).
+ *  @param p_Parser Parser
+ *  @param Start    Start in seconds since 1970 (UTC)
+ *  @param End      End in seconds since 1970 (UTC)
+ *  @return         true if the instance is inside of the window
+ */
+static bool _CalDAV_Parser_In_Window(const CalDAV_Parser_t *p_Parser, int64_t Start, int64_t End)
+{
+    if (Start >= p_Parser->WindowEnd) {
+        return false;
+    }
+
+    return (End > p_Parser->WindowStart) || ((End == Start) && (Start >= p_Parser->WindowStart));
+}
+
+/** @brief          Completes the current VEVENT. A recurring event is kept until the end of the calendar object,
+ *                  when the window is set, every other event is passed to the event callback.
+ *  @param p_Parser Parser
+ */
+static void _CalDAV_Parser_Event_End(CalDAV_Parser_t *p_Parser)
+{
+    int64_t Start = 0;
+    int64_t End = 0;
+
+    /* RFC 5545 (3.6.1): without DTEND and DURATION an event lasts one day or no time at all */
+    if (p_Parser->Times & CALDAV_PARSER_TIME_START) {
+        Start = p_Parser->Start;
+        if (p_Parser->Times & CALDAV_PARSER_TIME_END) {
+            End = p_Parser->End;
+        } else if (p_Parser->Times & CALDAV_PARSER_TIME_DURATION) {
+            End = p_Parser->Start + p_Parser->Duration;
+        } else {
+            End = p_Parser->Start + (p_Parser->IsAllDay ? CALDAV_PARSER_DAY : 0);
+        }
+    }
+
+    if (p_Parser->HasWindow && (p_Parser->Times & CALDAV_PARSER_TIME_START) && (p_Parser->IsRecurrence == false) &&
+        p_Parser->Rule.IsSupported && (p_Parser->HasMaster == false)) {
+        CalDAV_Parser_Master_t *p_Master = &p_Parser->Master;
+
+        memcpy(p_Master->Fields, p_Parser->Event, sizeof(p_Master->Fields));
+        p_Master->Mark = p_Parser->EventMark;
+        p_Master->Rule = p_Parser->Rule;
+        p_Master->Local = p_Parser->Local;
+        p_Master->Duration = End - Start;
+        p_Master->Timezone = p_Parser->IsAllDay ? -1 : p_Parser->Zone;
+        p_Master->IsAllDay = p_Parser->IsAllDay;
+        p_Parser->HasMaster = true;
+
+        /* The fields stay in the working buffer until the event is expanded */
+        return;
+    }
+
+    if (p_Parser->Rule.Frequency != PARSER_FREQUENCY_NONE) {
+        if (p_Parser->Rule.IsSupported == false) {
+            ESP_LOGD(TAG, "Recurrence rule not supported, event not expanded!");
+        }
+    }
+
+    /* An overridden instance may be outside of the window of the recurring event */
+    if ((p_Parser->HasWindow == false) || (p_Parser->IsRecurrence == false) ||
+        ((p_Parser->Times & CALDAV_PARSER_TIME_START) == 0) || _CalDAV_Parser_In_Window(p_Parser, Start, End)) {
+        _CalDAV_Parser_Emit_Event(p_Parser, p_Parser->Event, Start, End, p_Parser->Offset, p_Parser->IsAllDay);
+    }
+
+    /* Values parsed in place stay valid after the callback */
+    if (p_Parser->IsInPlace == false) {
+        p_Parser->Position = p_Parser->EventMark;
+    }
+}
+
+/** @brief          Checks if a day is selected by the BYxxx parts of a recurrence rule.
+ *  @param p_Rule   Recurrence rule
+ *  @param Days     Day (days since 1970-01-01)
+ *  @param p_First  Date of the first instance (year, month, day and weekday)
+ *  @return         true if the day is selected
+ */
+static bool _CalDAV_Parser_Rule_Day(const CalDAV_Parser_Rule_t *p_Rule, int64_t Days, const int *p_First)
+{
+    int Year;
+    int Month;
+    int Day;
+    int MonthDays;
+    int Weekday = _CalDAV_Parser_Weekday(Days);
+
+    _CalDAV_Parser_Date(Days, &Year, &Month, &Day);
+    MonthDays = (int)(((Month == 12) ? _CalDAV_Parser_Days(Year + 1, 1, 1) : _CalDAV_Parser_Days(Year, Month + 1, 1)) -
+                      _CalDAV_Parser_Days(Year, Month, 1));
+
+    if (p_Rule->ByMonth != 0) {
+        if ((p_Rule->ByMonth & (1 << Month)) == 0) {
+            return false;
+        }
+    } else if ((p_Rule->Frequency == PARSER_FREQUENCY_YEARLY) && (Month != p_First[1])) {
+        return false;
+    }
+
+    if ((p_Rule->ByMonthDay != 0) || (p_Rule->ByMonthDayEnd != 0)) {
+        if (((p_Rule->ByMonthDay & ((uint32_t)1 << Day)) == 0) &&
+            ((p_Rule->ByMonthDayEnd & ((uint32_t)1 << (MonthDays - Day + 1))) == 0)) {
+            return false;
+        }
+    }
+
+    if (p_Rule->ByDayCount > 0) {
+        for (size_t i = 0; i < p_Rule->ByDayCount; i++) {
+            int Ordinal = p_Rule->ByDayOrdinal[i];
+
+            if (p_Rule->ByDayWeekday[i] != Weekday) {
+                continue;
+            }
+
+            /* The week of the month only counts for monthly and yearly rules */
+            if ((Ordinal == 0) || (p_Rule->Frequency <= PARSER_FREQUENCY_WEEKLY) ||
+                ((Ordinal > 0) && ((((Day - 1) / 7) + 1) == Ordinal)) ||
+                ((Ordinal < 0) && ((((MonthDays - Day) / 7) + 1) == -Ordinal))) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    if ((p_Rule->ByMonthDay != 0) || (p_Rule->ByMonthDayEnd != 0)) {
+        return true;
+    }
+
+    /* Without BYxxx parts the rule repeats the first instance */
+    switch (p_Rule->Frequency) {
+        case PARSER_FREQUENCY_WEEKLY: {
+            return Weekday == p_First[3];
+        }
+        case PARSER_FREQUENCY_MONTHLY:
+        case PARSER_FREQUENCY_YEARLY: {
+            return Day == p_First[2];
+        }
+        default: {
+            return true;
+        }
+    }
+}
+
+/** @brief              Passes an instance of the recurring event to the event callback unless it is excluded or
+ *                      outside of the window.
+ *  @param p_Parser     Parser
+ *  @param Local        Start of the instance as local time in seconds since 1970
+ *  @param p_Instances  Number of reported instances
+ *  @return             false if the expansion has to stop
+ */
+static bool _CalDAV_Parser_Instance(CalDAV_Parser_t *p_Parser, int64_t Local, size_t *p_Instances)
+{
+    const CalDAV_Parser_Master_t *p_Master = &p_Parser->Master;
+    int32_t Offset = 0;
+    int64_t Start;
+
+    if (p_Master->Timezone >= 0) {
+        Offset = _CalDAV_Parser_Timezone_Offset(&p_Parser->Timezones[p_Master->Timezone], Local);
+    }
+
+    Start = Local - Offset;
+
+    if (_CalDAV_Parser_In_Window(p_Parser, Start, Start + p_Master->Duration) == false) {
+        return true;
+    }
+
+    for (size_t i = 0; i < p_Parser->ExceptionCount; i++) {
+        if (p_Parser->Exceptions[i] == Start) {
+            return true;
+        }
+    }
+
+    _CalDAV_Parser_Emit_Event(p_Parser, p_Master->Fields, Start, Start + p_Master->Duration, Offset,
+                              p_Master->IsAllDay);
+
+    if (++(*p_Instances) >= CALDAV_PARSER_MAX_INSTANCES) {
+        ESP_LOGW(TAG, "Recurring event expanded to %u instances, expansion stopped!",
+                 (unsigned int)CALDAV_PARSER_MAX_INSTANCES);
+
+        return false;
+    }
+
+    return (p_Parser->IsStopped == false);
+}
+
+/** @brief          Expands the recurring event of the current calendar object into the instances inside of the
+ *                  window. The rule is evaluated period by period (day, week, month or year). Without COUNT the
+ *                  periods before the window are skipped, so the effort depends on the window, not on the age of
+ *                  the event.
+ *  @param p_Parser Parser
+ */
+static void _CalDAV_Parser_Expand(CalDAV_Parser_t *p_Parser)
+{
+    const CalDAV_Parser_Master_t *p_Master = &p_Parser->Master;
+    const CalDAV_Parser_Rule_t *p_Rule = &p_Master->Rule;
+    int64_t FirstDay = _CalDAV_Parser_Day(p_Master->Local);
+    int64_t TimeOfDay = p_Master->Local - (FirstDay * CALDAV_PARSER_DAY);
+    int64_t WeekDay;
+    int64_t TargetDay;
+    int64_t LastDay;
+    int64_t Period = 0;
+    int First[4];
+    int Target[3];
+    uint32_t Count = 1;
+    size_t Instances = 0;
+
+    _CalDAV_Parser_Date(FirstDay, &First[0], &First[1], &First[2]);
+    First[3] = _CalDAV_Parser_Weekday(FirstDay);
+
+    /* Start of the week of the first instance */
+    WeekDay = FirstDay - ((First[3] - p_Rule->WeekStart + 7) % 7);
+
+    /* Time zone offsets move an instance by less than a day */
+    TargetDay = _CalDAV_Parser_Day(p_Parser->WindowStart - p_Master->Duration) - 1;
+    LastDay = _CalDAV_Parser_Day(p_Parser->WindowEnd) + 1;
+    _CalDAV_Parser_Date(TargetDay, &Target[0], &Target[1], &Target[2]);
+
+    /* DTSTART is always the first instance */
+    if (_CalDAV_Parser_Instance(p_Parser, p_Master->Local, &Instances) == false) {
+        return;
+    }
+
+    /* The instances before the window only have to be counted with COUNT */
+    if (p_Rule->Count == 0) {
+        int64_t Skip;
+
+        switch (p_Rule->Frequency) {
+            case PARSER_FREQUENCY_DAILY: {
+                Skip = TargetDay - FirstDay;
+                break;
+            }
+            case PARSER_FREQUENCY_WEEKLY: {
+                Skip = (TargetDay - WeekDay) / 7;
+                break;
+            }
+            case PARSER_FREQUENCY_MONTHLY: {
+                Skip = (((int64_t)Target[0] * 12) + Target[1]) - (((int64_t)First[0] * 12) + First[1]);
+                break;
+            }
+            default: {
+                Skip = Target[0] - First[0];
+                break;
+            }
+        }
+
+        if (Skip > 0) {
+            Period = (Skip / p_Rule->Interval) * p_Rule->Interval;
+        }
+    }
+
+    for (;; Period += p_Rule->Interval) {
+        int64_t PeriodFirst;
+        int64_t PeriodLast;
+
+        switch (p_Rule->Frequency) {
+            case PARSER_FREQUENCY_DAILY: {
+                PeriodFirst = FirstDay + Period;
+                PeriodLast = PeriodFirst;
+                break;
+            }
+            case PARSER_FREQUENCY_WEEKLY: {
+                PeriodFirst = WeekDay + (Period * 7);
+                PeriodLast = PeriodFirst + 6;
+                break;
+            }
+            case PARSER_FREQUENCY_MONTHLY: {
+                int64_t Month = (First[1] - 1) + Period;
+                int Year = First[0] + (int)(Month / 12);
+
+                Month = (Month % 12) + 1;
+                PeriodFirst = _CalDAV_Parser_Days(Year, (int)Month, 1);
+                PeriodLast = ((Month == 12) ? _CalDAV_Parser_Days(Year + 1, 1, 1) :
+                              _CalDAV_Parser_Days(Year, (int)Month + 1, 1)) - 1;
+                break;
+            }
+            default: {
+                PeriodFirst = _CalDAV_Parser_Days(First[0] + (int)Period, 1, 1);
+                PeriodLast = _CalDAV_Parser_Days(First[0] + (int)Period + 1, 1, 1) - 1;
+                break;
+            }
+        }
+
+        if (PeriodFirst > LastDay) {
+            return;
+        }
+
+        for (int64_t Day = (PeriodFirst > FirstDay) ? PeriodFirst : FirstDay; Day <= PeriodLast; Day++) {
+            int64_t Local = (Day * CALDAV_PARSER_DAY) + TimeOfDay;
+
+            if ((Local <= p_Master->Local) || (_CalDAV_Parser_Rule_Day(p_Rule, Day, First) == false)) {
+                continue;
+            }
+
+            if (p_Rule->HasUntil) {
+                int64_t Until = Local;
+
+                if (p_Rule->IsUntilUTC && (p_Master->Timezone >= 0)) {
+                    Until -= _CalDAV_Parser_Timezone_Offset(&p_Parser->Timezones[p_Master->Timezone], Local);
+                }
+
+                if (Until > p_Rule->Until) {
+                    return;
+                }
+            }
+
+            if ((p_Rule->Count != 0) && (Count++ >= p_Rule->Count)) {
+                return;
+            }
+
+            if (_CalDAV_Parser_Instance(p_Parser, Local, &Instances) == false) {
+                return;
+            }
+        }
+    }
+}
+
+/** @brief          Processes a complete (unfolded) iCalendar content line stored at LineStart.
+ *                  The line is split into name, parameters and value in a single pass. Quoted parameter
+ *                  values may contain ':' and ';'. Only properties of the VEVENT itself are used, properties
+ *                  of nested components (e.g. VALARM) are skipped.
+ *  @param p_Parser Parser
+ */
+static void _CalDAV_Parser_iCal_Line(CalDAV_Parser_t *p_Parser)
+{
+    char *p_Line = p_Parser->Buffer + p_Parser->LineStart;
+    size_t Length;
+    size_t NameLength = 0;
+    size_t ValueStart;
+    bool IsQuoted = false;
+    const char *p_Value;
+    size_t ValueLength;
+
+    /* The line has been dropped with the data behind the write position */
+    if (p_Parser->Position <= p_Parser->LineStart) {
+        p_Parser->LineStart = p_Parser->Position;
+
+        return;
+    }
+
+    Length = p_Parser->Position - p_Parser->LineStart;
+
+    p_Line[Length] = '\0';
+
+    /* Line is always discarded unless a field keeps it */
+    p_Parser->Position = p_Parser->LineStart;
+
+    while ((NameLength < Length) && (p_Line[NameLength] != ':') && (p_Line[NameLength] != ';')) {
+        NameLength++;
+    }
+
+    /* Skip the parameters, the value starts after the first colon outside of a quoted string */
+    for (ValueStart = NameLength; ValueStart < Length; ValueStart++) {
+        if (p_Line[ValueStart] == '"') {
+            IsQuoted = !IsQuoted;
+        } else if ((p_Line[ValueStart] == ':') && (IsQuoted == false)) {
+            break;
+        }
+    }
+
+    if (ValueStart >= Length) {
+        return;
+    }
+
+    p_Value = p_Line + ValueStart + 1;
+    ValueLength = Length - ValueStart - 1;
+
+    if (_CalDAV_Parser_Equals(p_Line, NameLength, "BEGIN")) {
+        if (p_Parser->InEvent) {
+            p_Parser->ComponentDepth++;
+        } else if (p_Parser->TimezoneState != PARSER_TIMEZONE_NONE) {
+            _CalDAV_Parser_Timezone_Begin(p_Parser, p_Value, ValueLength);
+        } else if (_CalDAV_Parser_Equals(p_Value, ValueLength, "VTIMEZONE")) {
+            memset(&p_Parser->Timezone, 0, sizeof(CalDAV_Parser_Timezone_t));
+            p_Parser->TimezoneState = PARSER_TIMEZONE_DEFINITION;
+            p_Parser->TimezoneDepth = 0;
+        } else if (_CalDAV_Parser_Equals(p_Value, ValueLength, "VFREEBUSY")) {
+            p_Parser->InFreeBusy = (p_Parser->on_Period != NULL);
+        } else if (_CalDAV_Parser_Equals(p_Value, ValueLength, "VEVENT")) {
+            p_Parser->InEvent = true;
+            p_Parser->ComponentDepth = 0;
+            p_Parser->EventMark = p_Parser->Position;
+            p_Parser->Times = 0;
+            p_Parser->Offset = 0;
+            p_Parser->IsAllDay = false;
+            p_Parser->Zone = -1;
+            p_Parser->IsRecurrence = false;
+            memset(&p_Parser->Rule, 0, sizeof(CalDAV_Parser_Rule_t));
+            for (size_t i = 0; i < CALDAV_PARSER_EVENT_FIELDS; i++) {
+                p_Parser->Event[i] = CALDAV_PARSER_NO_FIELD;
+            }
+        }
+
+        return;
+    }
+
+    if (_CalDAV_Parser_Equals(p_Line, NameLength, "END")) {
+        if (p_Parser->InEvent && (p_Parser->ComponentDepth > 0)) {
+            p_Parser->ComponentDepth--;
+        } else if (p_Parser->TimezoneState != PARSER_TIMEZONE_NONE) {
+            _CalDAV_Parser_Timezone_End(p_Parser);
+        } else if (_CalDAV_Parser_Equals(p_Value, ValueLength, "VEVENT") && p_Parser->InEvent) {
+            _CalDAV_Parser_Event_End(p_Parser);
+            p_Parser->InEvent = false;
+        } else if (_CalDAV_Parser_Equals(p_Value, ValueLength, "VFREEBUSY")) {
+            p_Parser->InFreeBusy = false;
+        }
+
+        return;
+    }
+
+    if (p_Parser->TimezoneState != PARSER_TIMEZONE_NONE) {
+        _CalDAV_Parser_Timezone_Property(p_Parser, p_Line, NameLength, p_Value, ValueLength);
+
+        return;
+    }
+
+    if (p_Parser->InFreeBusy) {
+        _CalDAV_Parser_Free_Busy(p_Parser, p_Line, NameLength, ValueStart, Length);
+
+        return;
+    }
+
+    if ((p_Parser->InEvent == false) || (p_Parser->ComponentDepth > 0) || (ValueLength == 0)) {
+        return;
+    }
+
+    _CalDAV_Parser_Event_Time(p_Parser, p_Line, NameLength, ValueStart, Length);
+
+    for (size_t i = 0; i < (sizeof(_Parser_Properties) / sizeof(_Parser_Properties[0])); i++) {
+        if (_CalDAV_Parser_Equals(p_Line, NameLength, _Parser_Properties[i].Name)) {
+            CalDAV_Parser_Event_Field_t Field = _Parser_Properties[i].Field;
+
+            /* Stored values must not use the reserve */
+            if ((p_Parser->IsInPlace == false) &&
+                ((p_Parser->LineStart + ValueLength + 1 + CALDAV_PARSER_RESERVE) > p_Parser->Size)) {
+                p_Parser->IsTruncated = true;
+
+                if ((p_Parser->LineStart + 1 + CALDAV_PARSER_RESERVE) >= p_Parser->Size) {
+                    break;
+                }
+
+                ValueLength = p_Parser->Size - CALDAV_PARSER_RESERVE - p_Parser->LineStart - 1;
+            }
+
+            /* First occurrence wins */
+            if (p_Parser->Event[Field] == CALDAV_PARSER_NO_FIELD) {
+                if (_Parser_Properties[i].IsText) {
+                    ValueLength = _CalDAV_Parser_iCal_Unescape(p_Line, p_Value, ValueLength);
+                } else {
+                    memmove(p_Line, p_Value, ValueLength);
+                }
+
+                p_Line[ValueLength] = '\0';
+
+                p_Parser->Event[Field] = p_Parser->LineStart;
+                p_Parser->Position = p_Parser->LineStart + ValueLength + 1;
+            }
+
+            break;
+        }
+    }
+}
+
+/** @brief          Ends the current iCalendar content line and processes it.
+ *  @param p_Parser Parser
+ */
+static void _CalDAV_Parser_iCal_Line_End(CalDAV_Parser_t *p_Parser)
+{
+    _CalDAV_Parser_iCal_Line(p_Parser);
+
+    p_Parser->LineStart = p_Parser->Position;
+    p_Parser->IsLineTruncated = false;
+    p_Parser->IsLineBreak = false;
+}
+
+/** @brief          Processes a character of the calendar-data text.
+ *                  A line break is only processed with the next character, because a following space or
+ *                  tab continues the line (RFC 5545 3.1, line folding).
+ *  @param p_Parser Parser
+ *  @param c        Character
+ */
+static void _CalDAV_Parser_iCal_Char(CalDAV_Parser_t *p_Parser, char c)
+{
+    if (c == '\r') {
+        return;
+    }
+
+    if (p_Parser->IsLineBreak) {
+        p_Parser->IsLineBreak = false;
+
+        if ((c == ' ') || (c == '\t')) {
+            return;
+        }
+
+        _CalDAV_Parser_iCal_Line_End(p_Parser);
+    }
+
+    if (c == '\n') {
+        p_Parser->IsLineBreak = true;
+
+        return;
+    }
+
+    if (_CalDAV_Parser_Put(p_Parser, c, 0) == false) {
+        p_Parser->IsLineTruncated = true;
+    }
+}
+
+/** @brief          Starts a block of calendar data.
+ *  @param p_Parser Parser
+ */
+static void _CalDAV_Parser_Calendar_Data_Begin(CalDAV_Parser_t *p_Parser)
+{
+    p_Parser->InCalendarData = true;
+    p_Parser->InEvent = false;
+    p_Parser->InFreeBusy = false;
+    p_Parser->TimezoneState = PARSER_TIMEZONE_NONE;
+    p_Parser->HasMaster = false;
+    p_Parser->ExceptionCount = 0;
+    p_Parser->IsLineTruncated = false;
+    p_Parser->IsLineBreak = false;
+    p_Parser->LineStart = p_Parser->Position;
+}
+
+/** @brief          Leaves a block of calendar data without processing the pending line or events.
+ *  @param p_Parser Parser
+ */
+static void _CalDAV_Parser_Calendar_Data_Reset(CalDAV_Parser_t *p_Parser)
+{
+    p_Parser->HasMaster = false;
+    p_Parser->ExceptionCount = 0;
+    p_Parser->InCalendarData = false;
+    p_Parser->InEvent = false;
+    p_Parser->InFreeBusy = false;
+    p_Parser->TimezoneState = PARSER_TIMEZONE_NONE;
+    p_Parser->IsLineTruncated = false;
+    p_Parser->IsLineBreak = false;
+    p_Parser->LineStart = p_Parser->Position;
+}
+
+/** @brief          Ends a block of calendar data and reports the events that were held back for the expansion.
+ *  @param p_Parser Parser
+ */
+static void _CalDAV_Parser_Calendar_Data_End(CalDAV_Parser_t *p_Parser)
+{
+    if (p_Parser->InCalendarData == false) {
+        return;
+    }
+
+    /* Last line may not be terminated */
+    _CalDAV_Parser_iCal_Line_End(p_Parser);
+
+    /* Drop an incomplete VEVENT */
+    if (p_Parser->InEvent) {
+        p_Parser->Position = p_Parser->EventMark;
+    }
+
+    /* All overridden instances are known now */
+    if (p_Parser->HasMaster) {
+        if (p_Parser->IsStopped == false) {
+            _CalDAV_Parser_Expand(p_Parser);
+        }
+
+        if (p_Parser->IsInPlace == false) {
+            p_Parser->Position = p_Parser->Master.Mark;
+        }
+    }
+
+    _CalDAV_Parser_Calendar_Data_Reset(p_Parser);
+}
+
+/** @brief          Moves the write position back to drop the values behind it.
+ *                  Calendar data that is still open (e.g. a response block that ends inside of it in a malformed
+ *                  response) is dropped as well, because its current line was stored behind the new position.
+ *  @param p_Parser Parser
+ *  @param Position New write position
+ */
+static void _CalDAV_Parser_Rewind(CalDAV_Parser_t *p_Parser, size_t Position)
+{
+    p_Parser->Position = Position;
+
+    if (p_Parser->InCalendarData) {
+        ESP_LOGD(TAG, "Unterminated calendar data dropped!");
+
+        _CalDAV_Parser_Calendar_Data_Reset(p_Parser);
+    }
+}
+
+/** @brief          Processes a decoded character of XML character data.
+ *  @param p_Parser Parser
+ *  @param c        Character
+ */
+static void _CalDAV_Parser_Text(CalDAV_Parser_t *p_Parser, char c)
+{
+    if (p_Parser->Capture >= 0) {
+        /* Skip leading whitespace of captured values */
+        if ((p_Parser->Position == p_Parser->CaptureStart) && _CalDAV_Parser_Is_Space(c)) {
+            return;
+        }
+
+        _CalDAV_Parser_Put(p_Parser, c, CALDAV_PARSER_RESERVE);
+    } else if (p_Parser->InCalendarData) {
+        _CalDAV_Parser_iCal_Char(p_Parser, c);
+    }
+}
+
+/** @brief          Starts capturing the text of the current element into a response field.
+ *  @param p_Parser Parser
+ *  @param Field    Response field
+ */
+static void _CalDAV_Parser_Capture(CalDAV_Parser_t *p_Parser, CalDAV_Parser_Response_Field_t Field)
+{
+    /* First occurrence wins */
+    if (p_Parser->Response[Field] != CALDAV_PARSER_NO_FIELD) {
+        return;
+    }
+
+    /* Calendar data does not contain elements, its open line would be stored over the captured value */
+    if (p_Parser->InCalendarData) {
+        _CalDAV_Parser_Rewind(p_Parser, (p_Parser->LineStart < p_Parser->Position) ? p_Parser->LineStart :
+                              p_Parser->Position);
+    }
+
+    p_Parser->Capture = Field;
+    p_Parser->CaptureStart = p_Parser->Position;
+}
+
+/** @brief          Finishes the active capture and stores the value if it is not empty.
+ *  @param p_Parser Parser
+ */
+static void _CalDAV_Parser_Capture_End(CalDAV_Parser_t *p_Parser)
+{
+    while ((p_Parser->Position > p_Parser->CaptureStart) &&
+           _CalDAV_Parser_Is_Space(p_Parser->Buffer[p_Parser->Position - 1])) {
+        p_Parser->Position--;
+    }
+
+    if (p_Parser->Position > p_Parser->CaptureStart) {
+        p_Parser->Buffer[p_Parser->Position++] = '\0';
+        p_Parser->Response[p_Parser->Capture] = p_Parser->CaptureStart;
+    }
+
+    p_Parser->Capture = -1;
+}
+
+/** @brief          Handles the start of an XML element.
+ *  @param p_Parser Parser
+ *  @param Element  Element ID
+ *  @param Parent   Element ID of the parent element
+ */
+static void _CalDAV_Parser_Element_Start(CalDAV_Parser_t *p_Parser, uint8_t Element, uint8_t Parent)
+{
+    switch (Element) {
+        case PARSER_ELEMENT_RESPONSE: {
+            p_Parser->ResponseMark = p_Parser->Position;
+            p_Parser->IsCalendar = false;
+            p_Parser->IsPrincipal = false;
+            for (size_t i = 0; i < CALDAV_PARSER_RESPONSE_FIELDS; i++) {
+                p_Parser->Response[i] = CALDAV_PARSER_NO_FIELD;
+            }
+
+            break;
+        }
+        case PARSER_ELEMENT_HREF: {
+            if (Parent == PARSER_ELEMENT_RESPONSE) {
+                _CalDAV_Parser_Capture(p_Parser, CALDAV_PARSER_RESPONSE_HREF);
+            } else if (Parent == PARSER_ELEMENT_CURRENT_USER_PRINCIPAL) {
+                _CalDAV_Parser_Capture(p_Parser, CALDAV_PARSER_RESPONSE_CURRENT_USER_PRINCIPAL);
+            } else if (Parent == PARSER_ELEMENT_CALENDAR_HOME_SET) {
+                /* Only the first calendar home is used */
+                _CalDAV_Parser_Capture(p_Parser, CALDAV_PARSER_RESPONSE_CALENDAR_HOME);
+            }
+
+            break;
+        }
+        case PARSER_ELEMENT_DISPLAYNAME: {
+            if (Parent == PARSER_ELEMENT_PROP) {
+                _CalDAV_Parser_Capture(p_Parser, CALDAV_PARSER_RESPONSE_DISPLAYNAME);
+            }
+
+            break;
+        }
+        case PARSER_ELEMENT_CALENDAR_DESCRIPTION: {
+            if (Parent == PARSER_ELEMENT_PROP) {
+                _CalDAV_Parser_Capture(p_Parser, CALDAV_PARSER_RESPONSE_DESCRIPTION);
+            }
+
+            break;
+        }
+        case PARSER_ELEMENT_GETCTAG: {
+            if (Parent == PARSER_ELEMENT_PROP) {
+                _CalDAV_Parser_Capture(p_Parser, CALDAV_PARSER_RESPONSE_CTAG);
+            }
+
+            break;
+        }
+        case PARSER_ELEMENT_SYNC_TOKEN: {
+            /* Property of a collection (PROPFIND) or new token of a sync-collection REPORT */
+            if ((Parent == PARSER_ELEMENT_PROP) || (Parent == PARSER_ELEMENT_MULTISTATUS)) {
+                _CalDAV_Parser_Capture(p_Parser, CALDAV_PARSER_RESPONSE_SYNC_TOKEN);
+            }
+
+            break;
+        }
+        case PARSER_ELEMENT_GETETAG: {
+            if (Parent == PARSER_ELEMENT_PROP) {
+                _CalDAV_Parser_Capture(p_Parser, CALDAV_PARSER_RESPONSE_ETAG);
+            }
+
+            break;
+        }
+        case PARSER_ELEMENT_STATUS: {
+            /* Only the status of the whole resource, the status of a propstat is ignored */
+            if (Parent == PARSER_ELEMENT_RESPONSE) {
+                _CalDAV_Parser_Capture(p_Parser, CALDAV_PARSER_RESPONSE_STATUS);
+            }
+
+            break;
+        }
+        case PARSER_ELEMENT_CALENDAR: {
+            if (Parent == PARSER_ELEMENT_RESOURCETYPE) {
+                p_Parser->IsCalendar = true;
+            }
+
+            break;
+        }
+        case PARSER_ELEMENT_PRINCIPAL: {
+            if (Parent == PARSER_ELEMENT_RESOURCETYPE) {
+                p_Parser->IsPrincipal = true;
+            }
+
+            break;
+        }
+        case PARSER_ELEMENT_CALENDAR_DATA: {
+            if (Parent == PARSER_ELEMENT_PROP) {
+                _CalDAV_Parser_Calendar_Data_Begin(p_Parser);
+            }
+
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+}
+
+/** @brief                  Passes the collected response block to the response callback.
+ *  @param p_Parser         Parser
+ *  @param IsMultistatus    The fields belong to the multistatus itself
+ */
+static void _CalDAV_Parser_Emit_Response(CalDAV_Parser_t *p_Parser, bool IsMultistatus)
+{
+    CalDAV_Parser_Response_t Response;
+    const char *p_Status;
+
+    if (p_Parser->on_Response == NULL) {
+        return;
+    }
+
+    Response.Href = _CalDAV_Parser_Field(p_Parser, p_Parser->Response[CALDAV_PARSER_RESPONSE_HREF]);
+    Response.DisplayName = _CalDAV_Parser_Field(p_Parser, p_Parser->Response[CALDAV_PARSER_RESPONSE_DISPLAYNAME]);
+    Response.Description = _CalDAV_Parser_Field(p_Parser, p_Parser->Response[CALDAV_PARSER_RESPONSE_DESCRIPTION]);
+    Response.CTag = _CalDAV_Parser_Field(p_Parser, p_Parser->Response[CALDAV_PARSER_RESPONSE_CTAG]);
+    Response.SyncToken = _CalDAV_Parser_Field(p_Parser, p_Parser->Response[CALDAV_PARSER_RESPONSE_SYNC_TOKEN]);
+    Response.ETag = _CalDAV_Parser_Field(p_Parser, p_Parser->Response[CALDAV_PARSER_RESPONSE_ETAG]);
+    Response.CurrentUserPrincipal =
+        _CalDAV_Parser_Field(p_Parser, p_Parser->Response[CALDAV_PARSER_RESPONSE_CURRENT_USER_PRINCIPAL]);
+    Response.CalendarHome = _CalDAV_Parser_Field(p_Parser, p_Parser->Response[CALDAV_PARSER_RESPONSE_CALENDAR_HOME]);
+    Response.Status = 0;
+    Response.IsMultistatus = IsMultistatus;
+    Response.IsCalendar = p_Parser->IsCalendar && (IsMultistatus == false);
+    Response.IsPrincipal = p_Parser->IsPrincipal && (IsMultistatus == false);
+
+    /* Status line, e.g. "HTTP/1.1 404 Not Found" */
+    p_Status = _CalDAV_Parser_Field(p_Parser, p_Parser->Response[CALDAV_PARSER_RESPONSE_STATUS]);
+    if (p_Status != NULL) {
+        p_Status = strchr(p_Status, ' ');
+        if (p_Status != NULL) {
+            Response.Status = atoi(p_Status + 1);
+        }
+    }
+
+    if (p_Parser->on_Response(&Response, p_Parser->p_Arg) == false) {
+        p_Parser->IsStopped = true;
+    }
+}
+
+/** @brief          Handles the end of an XML element.
+ *  @param p_Parser Parser
+ *  @param Element  Element ID
+ */
+static void _CalDAV_Parser_Element_End(CalDAV_Parser_t *p_Parser, uint8_t Element)
+{
+    switch (Element) {
+        case PARSER_ELEMENT_RESPONSE: {
+            if (p_Parser->Capture >= 0) {
+                p_Parser->Capture = -1;
+            }
+
+            _CalDAV_Parser_Emit_Response(p_Parser, false);
+
+            if (p_Parser->IsInPlace == false) {
+                _CalDAV_Parser_Rewind(p_Parser, p_Parser->ResponseMark);
+            }
+
+            for (size_t i = 0; i < CALDAV_PARSER_RESPONSE_FIELDS; i++) {
+                p_Parser->Response[i] = CALDAV_PARSER_NO_FIELD;
+            }
+
+            break;
+        }
+        case PARSER_ELEMENT_MULTISTATUS: {
+            if (p_Parser->Response[CALDAV_PARSER_RESPONSE_SYNC_TOKEN] != CALDAV_PARSER_NO_FIELD) {
+                _CalDAV_Parser_Emit_Response(p_Parser, true);
+            }
+
+            break;
+        }
+        case PARSER_ELEMENT_CALENDAR_DATA: {
+            _CalDAV_Parser_Calendar_Data_End(p_Parser);
+
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+}
+
+/** @brief          Handles a complete start, end or empty element tag stored in Name.
+ *  @param p_Parser Parser
+ */
+static void _CalDAV_Parser_Tag(CalDAV_Parser_t *p_Parser)
+{
+    const char *p_LocalName;
+    uint8_t Element = PARSER_ELEMENT_OTHER;
+
+    p_Parser->Name[p_Parser->NameLength] = '\0';
+
+    /* Ignore the namespace prefix */
+    p_LocalName = strrchr(p_Parser->Name, ':');
+    p_LocalName = (p_LocalName == NULL) ? p_Parser->Name : (p_LocalName + 1);
+
+    for (size_t i = 0; i < (sizeof(_Parser_Elements) / sizeof(_Parser_Elements[0])); i++) {
+        if (strcmp(p_LocalName, _Parser_Elements[i].Name) == 0) {
+            Element = _Parser_Elements[i].Element;
+
+            break;
+        }
+    }
+
+    if (p_Parser->IsEndTag == false) {
+        uint8_t Parent = PARSER_ELEMENT_OTHER;
+
+        if (p_Parser->HasRoot == false) {
+            p_Parser->HasRoot = true;
+            p_Parser->IsHTML = (strcasecmp(p_LocalName, "html") == 0);
+        }
+
+        if ((p_Parser->Depth > 0) && (p_Parser->Depth <= CALDAV_PARSER_MAX_DEPTH)) {
+            Parent = p_Parser->Stack[p_Parser->Depth - 1];
+        }
+
+        if (p_Parser->Depth < CALDAV_PARSER_MAX_DEPTH) {
+            p_Parser->Stack[p_Parser->Depth] = Element;
+        }
+
+        p_Parser->Depth++;
+
+        /* Text of captured fields must not contain child elements */
+        if ((p_Parser->Capture >= 0) && (Element != PARSER_ELEMENT_OTHER)) {
+            p_Parser->Capture = -1;
+            _CalDAV_Parser_Rewind(p_Parser, p_Parser->CaptureStart);
+        }
+
+        _CalDAV_Parser_Element_Start(p_Parser, Element, Parent);
+
+        if (p_Parser->IsEmptyTag == false) {
+            return;
+        }
+    }
+
+    if (p_Parser->Depth == 0) {
+        return;
+    }
+
+    p_Parser->Depth--;
+    Element = (p_Parser->Depth < CALDAV_PARSER_MAX_DEPTH) ? p_Parser->Stack[p_Parser->Depth] :
+              (uint8_t)PARSER_ELEMENT_OTHER;
+
+    if ((p_Parser->Capture >= 0) && (Element != PARSER_ELEMENT_OTHER)) {
+        _CalDAV_Parser_Capture_End(p_Parser);
+    }
+
+    _CalDAV_Parser_Element_End(p_Parser, Element);
+}
+
+/** @brief          Decodes the entity reference stored in Entity and passes the result to the text handler.
+ *                  Unknown entities are passed through unchanged.
+ *  @param p_Parser Parser
+ */
+static void _CalDAV_Parser_Entity(CalDAV_Parser_t *p_Parser)
+{
+    const char *p_Entity = p_Parser->Entity;
+    size_t Length = p_Parser->EntityLength;
+    uint32_t Codepoint = 0;
+
+    if (_CalDAV_Parser_Equals(p_Entity, Length, "lt")) {
+        Codepoint = '<';
+    } else if (_CalDAV_Parser_Equals(p_Entity, Length, "gt")) {
+        Codepoint = '>';
+    } else if (_CalDAV_Parser_Equals(p_Entity, Length, "amp")) {
+        Codepoint = '&';
+    } else if (_CalDAV_Parser_Equals(p_Entity, Length, "quot")) {
+        Codepoint = '"';
+    } else if (_CalDAV_Parser_Equals(p_Entity, Length, "apos")) {
+        Codepoint = '\'';
+    } else if ((Length > 1) && (p_Entity[0] == '#')) {
+        bool IsHex = (p_Entity[1] == 'x') || (p_Entity[1] == 'X');
+
+        for (size_t i = IsHex ? 2 : 1; i < Length; i++) {
+            char c = p_Entity[i];
+
+            if ((c >= '0') && (c <= '9')) {
+                Codepoint = (Codepoint * (IsHex ? 16 : 10)) + (c - '0');
+            } else if (IsHex && (c >= 'a') && (c <= 'f')) {
+                Codepoint = (Codepoint * 16) + (c - 'a' + 10);
+            } else if (IsHex && (c >= 'A') && (c <= 'F')) {
+                Codepoint = (Codepoint * 16) + (c - 'A' + 10);
+            } else {
+                Codepoint = 0;
+
+                break;
+            }
+        }
+    }
+
+    if ((Codepoint == 0) || (Codepoint > 0x10FFFF)) {
+        _CalDAV_Parser_Text(p_Parser, '&');
+        for (size_t i = 0; i < Length; i++) {
+            _CalDAV_Parser_Text(p_Parser, p_Entity[i]);
+        }
+        _CalDAV_Parser_Text(p_Parser, ';');
+    } else if (Codepoint < 0x80) {
+        _CalDAV_Parser_Text(p_Parser, (char)Codepoint);
+    } else if (Codepoint < 0x800) {
+        _CalDAV_Parser_Text(p_Parser, (char)(0xC0 | (Codepoint >> 6)));
+        _CalDAV_Parser_Text(p_Parser, (char)(0x80 | (Codepoint & 0x3F)));
+    } else if (Codepoint < 0x10000) {
+        _CalDAV_Parser_Text(p_Parser, (char)(0xE0 | (Codepoint >> 12)));
+        _CalDAV_Parser_Text(p_Parser, (char)(0x80 | ((Codepoint >> 6) & 0x3F)));
+        _CalDAV_Parser_Text(p_Parser, (char)(0x80 | (Codepoint & 0x3F)));
+    } else {
+        _CalDAV_Parser_Text(p_Parser, (char)(0xF0 | (Codepoint >> 18)));
+        _CalDAV_Parser_Text(p_Parser, (char)(0x80 | ((Codepoint >> 12) & 0x3F)));
+        _CalDAV_Parser_Text(p_Parser, (char)(0x80 | ((Codepoint >> 6) & 0x3F)));
+        _CalDAV_Parser_Text(p_Parser, (char)(0x80 | (Codepoint & 0x3F)));
+    }
+}
+
+/** @brief          Processes a single character of the response.
+ *  @param p_Parser Parser
+ *  @param c        Character
+ */
+static void _CalDAV_Parser_Char(CalDAV_Parser_t *p_Parser, char c)
+{
+    switch (p_Parser->State) {
+        case PARSER_STATE_TEXT: {
+            if (c == '<') {
+                p_Parser->State = PARSER_STATE_TAG_START;
+                p_Parser->NameLength = 0;
+                p_Parser->IsEndTag = false;
+                p_Parser->IsEmptyTag = false;
+                p_Parser->Quote = 0;
+            } else if (c == '&') {
+                p_Parser->State = PARSER_STATE_ENTITY;
+                p_Parser->EntityLength = 0;
+            } else {
+                _CalDAV_Parser_Text(p_Parser, c);
+            }
+
+            break;
+        }
+        case PARSER_STATE_ENTITY: {
+            if (c == ';') {
+                _CalDAV_Parser_Entity(p_Parser);
+                p_Parser->State = PARSER_STATE_TEXT;
+            } else if ((p_Parser->EntityLength < sizeof(p_Parser->Entity)) && (c != '<') && (c != '&') &&
+                       (_CalDAV_Parser_Is_Space(c) == false)) {
+                p_Parser->Entity[p_Parser->EntityLength++] = c;
+            } else {
+                /* Not an entity reference, pass it through and process the character as text */
+                _CalDAV_Parser_Text(p_Parser, '&');
+                for (size_t i = 0; i < p_Parser->EntityLength; i++) {
+                    _CalDAV_Parser_Text(p_Parser, p_Parser->Entity[i]);
+                }
+
+                p_Parser->State = PARSER_STATE_TEXT;
+                _CalDAV_Parser_Char(p_Parser, c);
+            }
+
+            break;
+        }
+        case PARSER_STATE_TAG_START: {
+            if (c == '/') {
+                p_Parser->IsEndTag = true;
+                p_Parser->State = PARSER_STATE_TAG_NAME;
+            } else if (c == '?') {
+                p_Parser->State = PARSER_STATE_SKIP;
+            } else if (c == '!') {
+                p_Parser->State = PARSER_STATE_DECLARATION;
+            } else {
+                p_Parser->State = PARSER_STATE_TAG_NAME;
+                _CalDAV_Parser_Char(p_Parser, c);
+            }
+
+            break;
+        }
+        case PARSER_STATE_TAG_NAME: {
+            if (c == '>') {
+                _CalDAV_Parser_Tag(p_Parser);
+                p_Parser->State = PARSER_STATE_TEXT;
+            } else if ((c == '/') || _CalDAV_Parser_Is_Space(c)) {
+                p_Parser->State = PARSER_STATE_TAG_ATTRIBUTES;
+                _CalDAV_Parser_Char(p_Parser, c);
+            } else if (p_Parser->NameLength < (sizeof(p_Parser->Name) - 1)) {
+                p_Parser->Name[p_Parser->NameLength++] = c;
+            }
+
+            break;
+        }
+        case PARSER_STATE_TAG_ATTRIBUTES: {
+            if (p_Parser->Quote != 0) {
+                if (c == p_Parser->Quote) {
+                    p_Parser->Quote = 0;
+                }
+            } else if ((c == '"') || (c == '\'')) {
+                p_Parser->Quote = c;
+                p_Parser->IsEmptyTag = false;
+            } else if (c == '/') {
+                p_Parser->IsEmptyTag = true;
+            } else if (c == '>') {
+                _CalDAV_Parser_Tag(p_Parser);
+                p_Parser->State = PARSER_STATE_TEXT;
+            } else if (_CalDAV_Parser_Is_Space(c) == false) {
+                p_Parser->IsEmptyTag = false;
+            }
+
+            break;
+        }
+        case PARSER_STATE_DECLARATION: {
+            static const char *p_CDATA = "[CDATA[";
+
+            /* Name collects the characters after "<!" until the declaration type is known */
+            if (p_Parser->NameLength < (sizeof(p_Parser->Name) - 1)) {
+                p_Parser->Name[p_Parser->NameLength++] = c;
+            }
+
+            if ((p_Parser->NameLength == 2) && (strncmp(p_Parser->Name, "--", 2) == 0)) {
+                p_Parser->State = PARSER_STATE_COMMENT;
+                p_Parser->Markup = 0;
+            } else if ((p_Parser->NameLength == strlen(p_CDATA)) &&
+                       (strncmp(p_Parser->Name, p_CDATA, p_Parser->NameLength) == 0)) {
+                p_Parser->State = PARSER_STATE_CDATA;
+                p_Parser->Markup = 0;
+            } else if (c == '>') {
+                p_Parser->State = PARSER_STATE_TEXT;
+            } else if ((strncmp(p_Parser->Name, "--", p_Parser->NameLength) != 0) &&
+                       (strncmp(p_Parser->Name, p_CDATA, p_Parser->NameLength) != 0)) {
+                /* DOCTYPE or other declaration */
+                p_Parser->State = PARSER_STATE_SKIP;
+            }
+
+            break;
+        }
+        case PARSER_STATE_COMMENT: {
+            if ((c == '>') && (p_Parser->Markup >= 2)) {
+                p_Parser->State = PARSER_STATE_TEXT;
+            } else if (c == '-') {
+                if (p_Parser->Markup < 2) {
+                    p_Parser->Markup++;
+                }
+            } else {
+                p_Parser->Markup = 0;
+            }
+
+            break;
+        }
+        case PARSER_STATE_CDATA: {
+            /* Closing brackets are held back until it is known if they end the section */
+            if (c == ']') {
+                if (p_Parser->Markup < 2) {
+                    p_Parser->Markup++;
+                } else {
+                    _CalDAV_Parser_Text(p_Parser, ']');
+                }
+            } else if ((c == '>') && (p_Parser->Markup == 2)) {
+                p_Parser->State = PARSER_STATE_TEXT;
+            } else {
+                for (uint8_t i = 0; i < p_Parser->Markup; i++) {
+                    _CalDAV_Parser_Text(p_Parser, ']');
+                }
+
+                p_Parser->Markup = 0;
+                _CalDAV_Parser_Text(p_Parser, c);
+            }
+
+            break;
+        }
+        case PARSER_STATE_SKIP: {
+            if (c == '>') {
+                p_Parser->State = PARSER_STATE_TEXT;
+            }
+
+            break;
+        }
+        case PARSER_STATE_ICALENDAR: {
+            _CalDAV_Parser_iCal_Char(p_Parser, c);
+
+            break;
+        }
+        default: {
+            p_Parser->State = PARSER_STATE_TEXT;
+
+            break;
+        }
+    }
+}
+
+void CalDAV_Parser_Init(CalDAV_Parser_t *p_Parser, char *p_Buffer, size_t Size,
+                        CalDAV_Parser_On_Response_t on_Response, CalDAV_Parser_On_Event_t on_Event, void *p_Arg)
+{
+    memset(p_Parser, 0, sizeof(CalDAV_Parser_t));
+
+    p_Parser->Buffer = p_Buffer;
+    p_Parser->Size = Size;
+    p_Parser->on_Response = on_Response;
+    p_Parser->on_Event = on_Event;
+    p_Parser->p_Arg = p_Arg;
+    p_Parser->State = PARSER_STATE_TEXT;
+    p_Parser->Capture = -1;
+
+    for (size_t i = 0; i < CALDAV_PARSER_RESPONSE_FIELDS; i++) {
+        p_Parser->Response[i] = CALDAV_PARSER_NO_FIELD;
+    }
+
+    for (size_t i = 0; i < CALDAV_PARSER_EVENT_FIELDS; i++) {
+        p_Parser->Event[i] = CALDAV_PARSER_NO_FIELD;
+    }
+}
+
+void CalDAV_Parser_Set_Window(CalDAV_Parser_t *p_Parser, const struct tm *p_Start, const struct tm *p_End)
+{
+    const struct tm *p_Times[] = {p_Start, p_End};
+    int64_t Seconds[2];
+
+    if ((p_Parser == NULL) || (p_Start == NULL) || (p_End == NULL)) {
+        return;
+    }
+
+    for (size_t i = 0; i < 2; i++) {
+        Seconds[i] = (_CalDAV_Parser_Days(p_Times[i]->tm_year + 1900, p_Times[i]->tm_mon + 1, p_Times[i]->tm_mday) *
+                      CALDAV_PARSER_DAY) + (p_Times[i]->tm_hour * 3600) + (p_Times[i]->tm_min * 60) +
+                     p_Times[i]->tm_sec;
+    }
+
+    p_Parser->WindowStart = Seconds[0];
+    p_Parser->WindowEnd = Seconds[1];
+    p_Parser->HasWindow = true;
+}
+
+void CalDAV_Parser_Set_Free_Busy(CalDAV_Parser_t *p_Parser, CalDAV_Parser_On_Period_t on_Period)
+{
+    if (p_Parser == NULL) {
+        return;
+    }
+
+    p_Parser->on_Period = on_Period;
+}
+
+void CalDAV_Parser_Feed(CalDAV_Parser_t *p_Parser, const char *p_Data, size_t Length)
+{
+    if ((p_Parser == NULL) || (p_Data == NULL) || (p_Parser->Buffer == NULL)) {
+        return;
+    }
+
+    for (size_t i = 0; (i < Length) && (p_Parser->IsStopped == false); i++) {
+        _CalDAV_Parser_Char(p_Parser, p_Data[i]);
+    }
+}
+
+void CalDAV_Parser_iCalendar_Begin(CalDAV_Parser_t *p_Parser)
+{
+    if (p_Parser == NULL) {
+        return;
+    }
+
+    p_Parser->State = PARSER_STATE_ICALENDAR;
+    _CalDAV_Parser_Calendar_Data_Begin(p_Parser);
+}
+
+void CalDAV_Parser_iCalendar_End(CalDAV_Parser_t *p_Parser)
+{
+    if ((p_Parser == NULL) || (p_Parser->State != PARSER_STATE_ICALENDAR)) {
+        return;
+    }
+
+    _CalDAV_Parser_Calendar_Data_End(p_Parser);
+    p_Parser->State = PARSER_STATE_TEXT;
+}
+
+const char *CalDAV_Parser_Get_Field(const CalDAV_Parser_t *p_Parser, CalDAV_Parser_Response_Field_t Field)
+{
+    if ((p_Parser == NULL) || (Field >= CALDAV_PARSER_RESPONSE_FIELDS)) {
+        return NULL;
+    }
+
+    return _CalDAV_Parser_Field(p_Parser, p_Parser->Response[Field]);
+}
+
+void CalDAV_Parser_Parse_In_Place(CalDAV_Parser_t *p_Parser, char *p_Data, size_t Length,
+                                  CalDAV_Parser_On_Response_t on_Response, CalDAV_Parser_On_Event_t on_Event,
+                                  void *p_Arg)
+{
+    bool HasWindow = p_Parser->HasWindow;
+    int64_t WindowStart = p_Parser->WindowStart;
+    int64_t WindowEnd = p_Parser->WindowEnd;
+
+    CalDAV_Parser_Init(p_Parser, p_Data, Length, on_Response, on_Event, p_Arg);
+    p_Parser->IsInPlace = true;
+    p_Parser->HasWindow = HasWindow;
+    p_Parser->WindowStart = WindowStart;
+    p_Parser->WindowEnd = WindowEnd;
+
+    /* Every character produces at most one byte of output, so the values never overwrite unread data */
+    CalDAV_Parser_Feed(p_Parser, p_Data, Length);
+}
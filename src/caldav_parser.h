@@ -0,0 +1,345 @@
+/*
+ * caldav_parser.h
+ *
+ *  Copyright (C) Daniel Kampert, 2026
+ *  Website: www.kampis-elektroecke.de
+ *  File info: Streaming parser for CalDAV multistatus responses.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#ifndef ESP32_CALDAV_PARSER_H_
+#define ESP32_CALDAV_PARSER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "caldav_types.h"
+
+/** @brief Maximum nesting depth of XML elements tracked by the parser.
+ */
+#define CALDAV_PARSER_MAX_DEPTH             16
+
+/** @brief Maximum length of an XML tag name (including namespace prefix).
+ */
+#define CALDAV_PARSER_MAX_NAME              32
+
+/** @brief Maximum length of an XML entity reference (without '&' and ';').
+ */
+#define CALDAV_PARSER_MAX_ENTITY            10
+
+/** @brief Part of the working buffer that stored values never use. It guarantees that structural
+ *         iCalendar lines (BEGIN / END) still fit when the buffer is filled with values.
+ */
+#define CALDAV_PARSER_RESERVE               32
+
+/** @brief Number of time zone definitions (VTIMEZONE) the parser keeps to resolve TZID parameters.
+ */
+#define CALDAV_PARSER_MAX_TIMEZONES         3
+
+/** @brief Maximum length of a time zone identifier (TZID) including the terminator.
+ */
+#define CALDAV_PARSER_MAX_TZID              40
+
+/** @brief Maximum number of excluded instances (EXDATE and RECURRENCE-ID) of a recurring event.
+ */
+#define CALDAV_PARSER_MAX_EXCEPTIONS        16
+
+/** @brief Maximum number of instances a recurring event is expanded to.
+ */
+#define CALDAV_PARSER_MAX_INSTANCES         256
+
+/** @brief Maximum number of BYDAY entries of a recurrence rule.
+ */
+#define CALDAV_PARSER_MAX_BYDAY             7
+
+/** @brief Fields of a multistatus response block collected by the parser.
+ */
+typedef enum {
+    CALDAV_PARSER_RESPONSE_HREF = 0,
+    CALDAV_PARSER_RESPONSE_DISPLAYNAME,
+    CALDAV_PARSER_RESPONSE_DESCRIPTION,
+    CALDAV_PARSER_RESPONSE_CTAG,
+    CALDAV_PARSER_RESPONSE_SYNC_TOKEN,
+    CALDAV_PARSER_RESPONSE_ETAG,
+    CALDAV_PARSER_RESPONSE_STATUS,
+    CALDAV_PARSER_RESPONSE_CURRENT_USER_PRINCIPAL,
+    CALDAV_PARSER_RESPONSE_CALENDAR_HOME,
+    CALDAV_PARSER_RESPONSE_FIELDS,
+} CalDAV_Parser_Response_Field_t;
+
+/** @brief Event properties collected by the parser.
+ */
+typedef enum {
+    CALDAV_PARSER_EVENT_UID = 0,
+    CALDAV_PARSER_EVENT_SUMMARY,
+    CALDAV_PARSER_EVENT_DESCRIPTION,
+    CALDAV_PARSER_EVENT_LOCATION,
+    CALDAV_PARSER_EVENT_DTSTART,
+    CALDAV_PARSER_EVENT_DTEND,
+    CALDAV_PARSER_EVENT_FIELDS,
+} CalDAV_Parser_Event_Field_t;
+
+/** @brief Observance (STANDARD or DAYLIGHT) of a time zone definition.
+ */
+typedef struct {
+    int64_t Onset;                  /**< Local start of the observance in seconds since 1970 (DTSTART). */
+    int32_t Offset;                 /**< UTC offset during the observance in seconds (TZOFFSETTO). */
+    int32_t Time;                   /**< Local time of day of the yearly onset in seconds. */
+    uint8_t Month;                  /**< Month of the yearly onset (1 - 12) or 0 without a yearly rule. */
+    int8_t Day;                     /**< First day of the month of the onset, negative for the n-th last week. */
+    uint8_t Weekday;                /**< Weekday of the onset (0 = Sunday). */
+    bool IsValid;                   /**< The observance is defined. */
+} CalDAV_Parser_Observance_t;
+
+/** @brief Time zone definition (VTIMEZONE) reduced to its current rules.
+ */
+typedef struct {
+    char TZID[CALDAV_PARSER_MAX_TZID];      /**< Time zone identifier. */
+    CalDAV_Parser_Observance_t Standard;    /**< Latest standard time observance. */
+    CalDAV_Parser_Observance_t Daylight;    /**< Latest daylight saving time observance. */
+} CalDAV_Parser_Timezone_t;
+
+/** @brief Recurrence rule (RRULE) of a VEVENT.
+ */
+typedef struct {
+    uint8_t Frequency;              /**< Frequency (0 = no rule). */
+    bool IsSupported;               /**< The rule only uses parts the expansion supports. */
+    uint16_t Interval;              /**< Interval of the frequency. */
+    uint32_t Count;                 /**< Number of instances or 0 without limit. */
+    int64_t Until;                  /**< Latest start of an instance in seconds since 1970. */
+    bool HasUntil;                  /**< Until is set. */
+    bool IsUntilUTC;                /**< Until is in UTC, otherwise it is a local time. */
+    uint8_t WeekStart;              /**< First day of the week (0 = Sunday). */
+    uint16_t ByMonth;               /**< Months (bit 1 - 12) or 0. */
+    uint32_t ByMonthDay;            /**< Days of the month (bit 1 - 31) or 0. */
+    uint32_t ByMonthDayEnd;         /**< Days of the month counted from the end (bit 1 = last day) or 0. */
+    uint8_t ByDayCount;             /**< Number of BYDAY entries. */
+    uint8_t ByDayWeekday[CALDAV_PARSER_MAX_BYDAY];  /**< Weekday of each BYDAY entry (0 = Sunday). */
+    int8_t ByDayOrdinal[CALDAV_PARSER_MAX_BYDAY];   /**< Week of each BYDAY entry in the month or 0 for every week. */
+} CalDAV_Parser_Rule_t;
+
+/** @brief Recurring VEVENT that is expanded at the end of its calendar object, after all overridden instances
+ *         (RECURRENCE-ID) are known.
+ */
+typedef struct {
+    size_t Mark;                    /**< Working buffer position at the start of the event. */
+    size_t Fields[CALDAV_PARSER_EVENT_FIELDS];  /**< Offsets of the event fields. */
+    CalDAV_Parser_Rule_t Rule;      /**< Recurrence rule. */
+    int64_t Local;                  /**< Start as written in seconds since 1970. */
+    int64_t Duration;               /**< Duration of each instance in seconds. */
+    int8_t Timezone;                /**< Time zone definition of the start or -1 for UTC. */
+    bool IsAllDay;                  /**< The start is a date. */
+} CalDAV_Parser_Master_t;
+
+/** @brief Parsed multistatus response block.
+ *         All strings point into the working buffer of the parser and are only valid during the callback.
+ *         After the last response block, properties of the multistatus itself (the sync-token of a
+ *         sync-collection REPORT) are reported as a block with IsMultistatus set.
+ */
+typedef struct {
+    const char *Href;               /**< Resource path. */
+    const char *DisplayName;        /**< Display name (NULL if not present). */
+    const char *Description;        /**< Calendar description (NULL if not present). */
+    const char *CTag;               /**< Collection tag (NULL if not present). */
+    const char *SyncToken;          /**< Sync token (NULL if not present). */
+    const char *ETag;               /**< Entity tag of the resource (NULL if not present). */
+    const char *CurrentUserPrincipal;   /**< Principal of the authenticated user (NULL if not present). */
+    const char *CalendarHome;       /**< Collection that contains the calendars of a principal (NULL if not present). */
+    int Status;                     /**< HTTP status code of the response block or 0 if not present. */
+    bool IsMultistatus;             /**< Block holds the properties of the multistatus itself. */
+    bool IsCalendar;                /**< Resource type contains a calendar. */
+    bool IsPrincipal;               /**< Resource type contains a principal. */
+} CalDAV_Parser_Response_t;
+
+/** @brief              Callback for each completed multistatus response block.
+ *  @param p_Response   Parsed response block
+ *  @param p_Arg        User argument
+ *  @return             true to continue, false to stop parsing (the remaining data is ignored)
+ */
+typedef bool (*CalDAV_Parser_On_Response_t)(const CalDAV_Parser_Response_t *p_Response, void *p_Arg);
+
+/** @brief          Callback for each completed VEVENT.
+ *                  All strings point into the working buffer of the parser and are only valid during the callback.
+ *  @param p_Event  Parsed event
+ *  @param p_Arg    User argument
+ *  @return         true to continue, false to stop parsing (the remaining data is ignored)
+ */
+typedef bool (*CalDAV_Parser_On_Event_t)(const CalDAV_Calendar_Event_t *p_Event, void *p_Arg);
+
+/** @brief          Callback for each busy period of a VFREEBUSY component.
+ *  @param Start    Start of the period in seconds since 1970 (UTC)
+ *  @param End      End of the period in seconds since 1970 (UTC)
+ *  @param p_Arg    User argument
+ *  @return         true to continue, false to stop parsing (the remaining data is ignored)
+ */
+typedef bool (*CalDAV_Parser_On_Period_t)(time_t Start, time_t End, void *p_Arg);
+
+/** @brief Streaming parser state.
+ *         The parser consumes a multistatus (PROPFIND / REPORT) response chunk by chunk. Field values are
+ *         collected in a fixed working buffer, so the memory usage does not depend on the response size.
+ */
+typedef struct {
+    char *Buffer;                   /**< Working buffer for field values. */
+    size_t Size;                    /**< Size of the working buffer. */
+    size_t Position;                /**< Write position in the working buffer. */
+
+    CalDAV_Parser_On_Response_t on_Response;    /**< Response block callback (optional). */
+    CalDAV_Parser_On_Event_t on_Event;          /**< Event callback (optional). */
+    CalDAV_Parser_On_Period_t on_Period;        /**< Busy period callback (CalDAV_Parser_Set_Free_Busy). */
+    void *p_Arg;                    /**< User argument for the callbacks. */
+
+    uint8_t State;                  /**< Current state of the XML tokenizer. */
+    char Name[CALDAV_PARSER_MAX_NAME];  /**< Name of the current tag. */
+    size_t NameLength;              /**< Length of the current tag name. */
+    bool IsEndTag;                  /**< The current tag is an end tag. */
+    bool IsEmptyTag;                /**< The current tag is an empty element tag (e.g. <calendar/>). */
+    char Quote;                     /**< Active attribute quote character or 0. */
+    char Entity[CALDAV_PARSER_MAX_ENTITY];  /**< Current entity reference. */
+    size_t EntityLength;            /**< Length of the current entity reference. */
+    uint8_t Markup;                 /**< Counter used to detect comment, CDATA and PI delimiters. */
+    uint8_t Stack[CALDAV_PARSER_MAX_DEPTH]; /**< Open XML elements. */
+    size_t Depth;                   /**< Number of open XML elements. */
+    bool HasRoot;                   /**< The root element has been seen. */
+    bool IsHTML;                    /**< The response is an HTML document instead of XML. */
+    bool IsTruncated;               /**< At least one value did not fit into the working buffer. */
+    bool IsStopped;                 /**< A callback has stopped the parser. */
+    bool IsInPlace;                 /**< The working buffer is the response itself and values are kept in it. */
+
+    int8_t Capture;                 /**< Response field currently captured or -1. */
+    size_t CaptureStart;            /**< Start of the captured value. */
+    size_t ResponseMark;            /**< Working buffer position at the start of the response block. */
+    size_t Response[CALDAV_PARSER_RESPONSE_FIELDS];  /**< Offsets of the response fields. */
+    bool IsCalendar;                /**< Current response block is a calendar. */
+    bool IsPrincipal;               /**< Current response block is a principal. */
+
+    bool InCalendarData;            /**< Text is currently iCalendar data. */
+    bool InEvent;                   /**< Current iCalendar line belongs to a VEVENT. */
+    uint8_t ComponentDepth;         /**< Nesting depth of components inside the VEVENT (e.g. VALARM). */
+    bool InFreeBusy;                /**< Current iCalendar line belongs to a VFREEBUSY. */
+    bool IsLineBreak;               /**< A line break was read, the next character decides about folding. */
+    bool IsLineTruncated;           /**< Current iCalendar line did not fit into the working buffer. */
+    size_t LineStart;               /**< Start of the current iCalendar line. */
+    size_t EventMark;               /**< Working buffer position at the start of the current VEVENT. */
+    size_t Event[CALDAV_PARSER_EVENT_FIELDS];   /**< Offsets of the event fields. */
+    int64_t Start;                  /**< Start of the current VEVENT in seconds since 1970 (UTC). */
+    int64_t End;                    /**< End of the current VEVENT in seconds since 1970 (UTC). */
+    int64_t Duration;               /**< Duration of the current VEVENT in seconds. */
+    int32_t Offset;                 /**< UTC offset of the start of the current VEVENT in seconds. */
+    uint8_t Times;                  /**< Time values found in the current VEVENT. */
+    bool IsAllDay;                  /**< The current VEVENT starts on a date instead of a date-time. */
+    int64_t Local;                  /**< Start of the current VEVENT as written in seconds since 1970. */
+    int8_t Zone;                    /**< Time zone definition of the start of the current VEVENT or -1. */
+    CalDAV_Parser_Rule_t Rule;      /**< Recurrence rule of the current VEVENT. */
+    bool IsRecurrence;              /**< The current VEVENT overrides an instance (RECURRENCE-ID). */
+
+    bool HasWindow;                 /**< Recurring events are expanded within the window. */
+    int64_t WindowStart;            /**< Start of the expansion window in seconds since 1970 (UTC). */
+    int64_t WindowEnd;              /**< End of the expansion window in seconds since 1970 (UTC). */
+    bool HasMaster;                 /**< A recurring event waits for the end of the calendar object. */
+    CalDAV_Parser_Master_t Master;  /**< Recurring event of the current calendar object. */
+    int64_t Exceptions[CALDAV_PARSER_MAX_EXCEPTIONS];   /**< Excluded instances in seconds since 1970 (UTC). */
+    size_t ExceptionCount;          /**< Number of excluded instances. */
+
+    uint8_t TimezoneState;          /**< Component of the time zone definition currently parsed. */
+    uint8_t TimezoneDepth;          /**< Nesting depth of unknown components inside the time zone definition. */
+    CalDAV_Parser_Observance_t Observance;  /**< Observance currently parsed. */
+    CalDAV_Parser_Timezone_t Timezone;      /**< Time zone definition currently parsed. */
+    CalDAV_Parser_Timezone_t Timezones[CALDAV_PARSER_MAX_TIMEZONES];   /**< Time zone definitions of the response. */
+    size_t TimezoneCount;           /**< Number of kept time zone definitions. */
+    size_t TimezoneNext;            /**< Time zone definition that is replaced next when all are used. */
+} CalDAV_Parser_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief              Initializes a streaming parser.
+ *  @param p_Parser     Parser to initialize
+ *  @param p_Buffer     Working buffer
+ *  @param Size         Size of the working buffer
+ *  @param on_Response  Response block callback (optional)
+ *  @param on_Event     Event callback (optional)
+ *  @param p_Arg        User argument for the callbacks
+ */
+void CalDAV_Parser_Init(CalDAV_Parser_t *p_Parser, char *p_Buffer, size_t Size,
+                        CalDAV_Parser_On_Response_t on_Response, CalDAV_Parser_On_Event_t on_Event, void *p_Arg);
+
+/** @brief          Feeds a chunk of response data into the parser.
+ *  @param p_Parser Parser
+ *  @param p_Data   Response data
+ *  @param Length   Length of the response data
+ */
+void CalDAV_Parser_Feed(CalDAV_Parser_t *p_Parser, const char *p_Data, size_t Length);
+
+/** @brief          Switches an initialized parser to a plain iCalendar body, e.g. the response of a GET on a
+ *                  calendar object resource. The data fed afterwards is not XML but text/calendar.
+ *  @param p_Parser Initialized parser
+ */
+void CalDAV_Parser_iCalendar_Begin(CalDAV_Parser_t *p_Parser);
+
+/** @brief          Ends a plain iCalendar body. Processes the last line and reports a pending recurring event.
+ *  @param p_Parser Parser
+ */
+void CalDAV_Parser_iCalendar_End(CalDAV_Parser_t *p_Parser);
+
+/** @brief          Returns a field of the current response block.
+ *                  Can be used from the event callback, e.g. to get the href of the resource the event belongs to.
+ *  @param p_Parser Parser
+ *  @param Field    Response field
+ *  @return         Value or NULL if the field has not been parsed (yet)
+ */
+const char *CalDAV_Parser_Get_Field(const CalDAV_Parser_t *p_Parser, CalDAV_Parser_Response_Field_t Field);
+
+/** @brief              Expands recurring events within a time range. Each VEVENT with an RRULE is reported once for
+ *                      every instance that overlaps the range, EXDATE and overridden instances (RECURRENCE-ID)
+ *                      excluded. The instances share the strings of the recurring event, only the binary times
+ *                      differ. Overridden instances outside of the range are dropped.
+ *  @param p_Parser     Initialized parser
+ *  @param p_Start      Start of the range as UTC time
+ *  @param p_End        End of the range as UTC time
+ */
+void CalDAV_Parser_Set_Window(CalDAV_Parser_t *p_Parser, const struct tm *p_Start, const struct tm *p_End);
+
+/** @brief              Reports the busy periods (FREEBUSY properties) of VFREEBUSY components, e.g. of the
+ *                      response of a free-busy-query REPORT. Without a callback VFREEBUSY components are skipped.
+ *  @param p_Parser     Initialized parser
+ *  @param on_Period    Busy period callback or NULL
+ */
+void CalDAV_Parser_Set_Free_Busy(CalDAV_Parser_t *p_Parser, CalDAV_Parser_On_Period_t on_Period);
+
+/** @brief              Parses a complete response in place.
+ *                      The values are decoded and NUL-terminated inside the response data and stay valid after
+ *                      the callbacks as long as the data is kept, so they can be used without copying.
+ *                      A window set with CalDAV_Parser_Set_Window is kept.
+ *  @param p_Parser     Parser to initialize (initialized before when a window is used)
+ *  @param p_Data       Response data (modified)
+ *  @param Length       Length of the response data
+ *  @param on_Response  Response block callback (optional)
+ *  @param on_Event     Event callback (optional)
+ *  @param p_Arg        User argument for the callbacks
+ */
+void CalDAV_Parser_Parse_In_Place(CalDAV_Parser_t *p_Parser, char *p_Data, size_t Length,
+                                  CalDAV_Parser_On_Response_t on_Response, CalDAV_Parser_On_Event_t on_Event,
+                                  void *p_Arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ESP32_CALDAV_PARSER_H_ */
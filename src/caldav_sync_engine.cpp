@@ -0,0 +1,605 @@
+/*
+ * caldav_sync_engine.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2026
+ *  Website: www.kampis-elektroecke.de
+ *  File info: Background sync engine for the CalDAV client.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+
+#include <esp_log.h>
+#include <esp_timer.h>
+
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include <atomic>
+#include <new>
+
+#include "caldav_sync_engine.h"
+#include "caldav_memory.h"
+
+#if CONFIG_ESP32_CALDAV_SYNC_ENGINE
+
+#if CONFIG_ESP32_CALDAV_SYNC_TASK_CORE < 0
+    #define CALDAV_SYNC_TASK_CORE           tskNO_AFFINITY
+#else
+    #define CALDAV_SYNC_TASK_CORE           CONFIG_ESP32_CALDAV_SYNC_TASK_CORE
+#endif
+
+/* No snapshot has been published yet */
+#define CALDAV_SYNC_NO_SNAPSHOT             -1
+
+/* Failed requests double the delay up to 2^6 times the interval (fixed interval only) */
+#define CALDAV_SYNC_BACKOFF_SHIFT           6
+
+/** @brief Poll state of a registered calendar in the adaptive mode.
+ */
+typedef struct {
+    char *p_Tag;                            /**< Change tag of the published snapshot or NULL. */
+    char *p_Pending;                        /**< Change tag read for the next refresh or NULL. */
+    uint32_t IntervalMs;                    /**< Current poll interval in milliseconds. */
+    int64_t Due;                            /**< Time of the next check in milliseconds (esp_timer). */
+    uint32_t Errors;                        /**< Number of failed checks in a row. */
+    time_t NextStart;                       /**< Start of the next event in the snapshot or 0. */
+    bool IsChanged;                         /**< The calendar has to be refreshed. */
+    std::atomic<bool> IsNotified;           /**< Push hint from CalDAV_Sync_Engine_Notify. */
+} CalDAV_Sync_Calendar_t;
+
+/** @brief Sync engine state.
+ *         The two snapshots are used alternately. The task only writes the snapshot that is not published and
+ *         waits until its readers are gone, readers count themselves in before they use the published snapshot.
+ */
+struct CalDAV_Sync_Engine_t {
+    CalDAV_Client_t *p_Client;              /**< Client used by the task. */
+    char **pp_CalendarPaths;                /**< Copies of the calendar paths. */
+    size_t Count;                           /**< Number of calendars. */
+    uint32_t IntervalMs;                    /**< Time between two refreshes in milliseconds. */
+    uint32_t MaxIntervalMs;                 /**< Longest poll interval or 0 for a fixed interval. */
+    int32_t WindowStart;                    /**< Start of the time range relative to the refresh in seconds. */
+    uint32_t WindowLength;                  /**< Length of the time range in seconds. */
+    CalDAV_Sync_Engine_Callback_t on_Update;    /**< Callback after every refresh. */
+    void *p_Arg;                            /**< User argument for the callback. */
+
+    CalDAV_Sync_Calendar_t *p_Calendars;    /**< Poll state of each calendar (adaptive mode only). */
+    int64_t RefreshDue;                     /**< Time of the next unconditional refresh in milliseconds. */
+    uint32_t Errors;                        /**< Number of failed refreshes in a row. */
+
+    TaskHandle_t Task;                      /**< Sync task. */
+    SemaphoreHandle_t Stopped;              /**< Given by the task when it has finished. */
+    std::atomic<bool> IsStopping;           /**< The task has to finish. */
+    std::atomic<bool> IsTriggered;          /**< CalDAV_Sync_Engine_Trigger has been called. */
+
+    CalDAV_Sync_Snapshot_t Snapshots[2];    /**< Double-buffered snapshots. */
+    std::atomic<int> Published;             /**< Index of the published snapshot or CALDAV_SYNC_NO_SNAPSHOT. */
+    std::atomic<uint32_t> Readers[2];       /**< Number of readers of each snapshot. */
+    uint32_t Generation;                    /**< Number of published snapshots. */
+};
+
+static const char *TAG = "CalDAV-Sync";
+
+/** @brief          Releases an engine and its snapshots.
+ *  @param p_Engine Engine
+ */
+static void _CalDAV_Sync_Engine_Free(CalDAV_Sync_Engine_t *p_Engine)
+{
+    if (p_Engine->pp_CalendarPaths != NULL) {
+        for (size_t i = 0; i < p_Engine->Count; i++) {
+            CUSTOM_FREE(p_Engine->pp_CalendarPaths[i]);
+        }
+
+        CUSTOM_FREE(p_Engine->pp_CalendarPaths);
+    }
+
+    if (p_Engine->p_Calendars != NULL) {
+        for (size_t i = 0; i < p_Engine->Count; i++) {
+            CUSTOM_FREE(p_Engine->p_Calendars[i].p_Tag);
+            CUSTOM_FREE(p_Engine->p_Calendars[i].p_Pending);
+        }
+
+        delete[] p_Engine->p_Calendars;
+    }
+
+    if (p_Engine->Stopped != NULL) {
+        vSemaphoreDelete(p_Engine->Stopped);
+    }
+
+    CalDAV_Event_List_Free(&p_Engine->Snapshots[0].List);
+    CalDAV_Event_List_Free(&p_Engine->Snapshots[1].List);
+
+    delete p_Engine;
+}
+
+/** @brief          Refreshes the calendars into the unpublished snapshot and publishes it.
+ *  @param p_Engine Engine
+ *  @return         CALDAV_ERROR_OK on success, error code otherwise
+ */
+static CalDAV_Error_t _CalDAV_Sync_Engine_Refresh(CalDAV_Sync_Engine_t *p_Engine)
+{
+    int Target;
+    time_t Now;
+    time_t Time;
+    struct tm StartTime;
+    struct tm EndTime;
+    CalDAV_Error_t Error;
+    CalDAV_Event_List_t List;
+    CalDAV_Sync_Snapshot_t *p_Snapshot;
+
+    Now = time(NULL);
+    Time = Now + p_Engine->WindowStart;
+    gmtime_r(&Time, &StartTime);
+    Time += p_Engine->WindowLength;
+    gmtime_r(&Time, &EndTime);
+
+    /* The network requests run before the snapshot is touched, so readers keep the old data meanwhile */
+    Error = CalDAV_Calendars_Events_List_Multi(p_Engine->p_Client, p_Engine->pp_CalendarPaths, p_Engine->Count,
+                                               &StartTime, &EndTime, true, &List, NULL);
+    if (Error != CALDAV_ERROR_OK) {
+        return Error;
+    }
+
+    Target = (p_Engine->Published.load() == 0) ? 1 : 0;
+    p_Snapshot = &p_Engine->Snapshots[Target];
+
+    /* Readers that acquired the snapshot before the last publication */
+    while (p_Engine->Readers[Target].load() > 0) {
+        vTaskDelay(1);
+    }
+
+    CalDAV_Event_List_Free(&p_Snapshot->List);
+    p_Snapshot->List = List;
+    p_Snapshot->Generation = ++p_Engine->Generation;
+    p_Snapshot->Updated = Now;
+
+    p_Engine->Published.store(Target);
+
+    ESP_LOGD(TAG, "Snapshot %u published with %u events", (unsigned int)p_Snapshot->Generation,
+             (unsigned int)List.Length);
+
+    /* The events are sorted by start time, so the first future event of a calendar is its next one */
+    if (p_Engine->p_Calendars != NULL) {
+        for (size_t i = 0; i < p_Engine->Count; i++) {
+            p_Engine->p_Calendars[i].NextStart = 0;
+        }
+
+        for (size_t i = 0; i < List.Length; i++) {
+            CalDAV_Sync_Calendar_t *p_Calendar = &p_Engine->p_Calendars[List.Calendar[i]];
+
+            if ((p_Calendar->NextStart == 0) && (List.Events[i].Start > Now)) {
+                p_Calendar->NextStart = List.Events[i].Start;
+            }
+        }
+    }
+
+    return CALDAV_ERROR_OK;
+}
+
+/** @brief          Returns the time of the sync task in milliseconds.
+ *  @return         Milliseconds since boot
+ */
+static inline int64_t _CalDAV_Sync_Engine_Now(void)
+{
+    return esp_timer_get_time() / 1000;
+}
+
+/** @brief          Returns the delay after a failed request.
+ *                  The delay doubles with every failure, a "Retry-After" header of the server is a lower bound.
+ *  @param p_Engine Engine
+ *  @param Errors   Number of failed requests in a row
+ *  @return         Delay in milliseconds
+ */
+static int64_t _CalDAV_Sync_Engine_Backoff(const CalDAV_Sync_Engine_t *p_Engine, uint32_t Errors)
+{
+    int64_t Delay;
+    int64_t Limit;
+    uint32_t Shift;
+
+    Shift = (Errors < CALDAV_SYNC_BACKOFF_SHIFT) ? Errors : CALDAV_SYNC_BACKOFF_SHIFT;
+    Delay = (int64_t)p_Engine->IntervalMs << Shift;
+
+    if (p_Engine->p_Calendars != NULL) {
+        Limit = p_Engine->MaxIntervalMs;
+    } else {
+        Limit = (int64_t)p_Engine->IntervalMs << CALDAV_SYNC_BACKOFF_SHIFT;
+    }
+
+    if (Delay > Limit) {
+        Delay = Limit;
+    }
+
+    if (((int64_t)p_Engine->p_Client->RetryAfter * 1000) > Delay) {
+        Delay = (int64_t)p_Engine->p_Client->RetryAfter * 1000;
+    }
+
+    return Delay;
+}
+
+/** @brief              Sets the next check of a calendar. The interval is kept short while the next event of
+ *                      the calendar starts within it, so late changes (e.g. a cancellation) are seen in time.
+ *  @param p_Engine     Engine
+ *  @param p_Calendar   Calendar
+ *  @param Now          Current time in milliseconds
+ */
+static void _CalDAV_Sync_Engine_Schedule(const CalDAV_Sync_Engine_t *p_Engine, CalDAV_Sync_Calendar_t *p_Calendar,
+                                         int64_t Now)
+{
+    time_t Time = time(NULL);
+
+    if ((p_Calendar->NextStart > Time) &&
+        (((int64_t)(p_Calendar->NextStart - Time) * 1000) <= p_Calendar->IntervalMs)) {
+        p_Calendar->IntervalMs = p_Engine->IntervalMs;
+    }
+
+    p_Calendar->Due = Now + p_Calendar->IntervalMs;
+}
+
+/** @brief          Checks the due calendars for changes with the tag of the calendar.
+ *                  An unchanged calendar is checked half as often as before, a changed calendar is refreshed and
+ *                  checked at the configured interval again.
+ *  @param p_Engine Engine
+ *  @param Now      Current time in milliseconds
+ *  @param p_Error  Pointer to store the result of a failed check
+ *  @return         true if at least one calendar has changed
+ */
+static bool _CalDAV_Sync_Engine_Check(CalDAV_Sync_Engine_t *p_Engine, int64_t Now, CalDAV_Error_t *p_Error)
+{
+    bool IsChanged = false;
+    char Tag[CALDAV_SYNC_TOKEN_LENGTH];
+
+    for (size_t i = 0; i < p_Engine->Count; i++) {
+        CalDAV_Error_t Error;
+        CalDAV_Sync_Calendar_t *p_Calendar = &p_Engine->p_Calendars[i];
+
+        p_Calendar->IsChanged = false;
+
+        /* A push hint replaces the check */
+        if (p_Calendar->IsNotified.exchange(false)) {
+            p_Calendar->IsChanged = true;
+            IsChanged = true;
+
+            continue;
+        }
+
+        if (p_Calendar->Due > Now) {
+            continue;
+        }
+
+        Error = CalDAV_Calendar_Get_Tag(p_Engine->p_Client, p_Engine->pp_CalendarPaths[i], Tag, sizeof(Tag));
+        if (Error != CALDAV_ERROR_OK) {
+            ESP_LOGW(TAG, "Check of %s failed: %d!", p_Engine->pp_CalendarPaths[i], Error);
+            p_Calendar->Errors++;
+            p_Calendar->Due = Now + _CalDAV_Sync_Engine_Backoff(p_Engine, p_Calendar->Errors);
+            *p_Error = Error;
+
+            continue;
+        }
+
+        p_Calendar->Errors = 0;
+
+        /* Without a tag a change can not be ruled out */
+        if ((Tag[0] != '\0') && (p_Calendar->p_Tag != NULL) && (strcmp(Tag, p_Calendar->p_Tag) == 0)) {
+            p_Calendar->IntervalMs *= 2;
+            if (p_Calendar->IntervalMs > p_Engine->MaxIntervalMs) {
+                p_Calendar->IntervalMs = p_Engine->MaxIntervalMs;
+            }
+
+            _CalDAV_Sync_Engine_Schedule(p_Engine, p_Calendar, Now);
+
+            ESP_LOGD(TAG, "%s unchanged, next check in %u ms", p_Engine->pp_CalendarPaths[i],
+                     (unsigned int)p_Calendar->IntervalMs);
+
+            continue;
+        }
+
+        CUSTOM_FREE(p_Calendar->p_Pending);
+        p_Calendar->p_Pending = (Tag[0] != '\0') ? _CalDAV_String_Duplicate(Tag) : NULL;
+        p_Calendar->IsChanged = true;
+        IsChanged = true;
+    }
+
+    return IsChanged;
+}
+
+/** @brief          Completes the calendars that were refreshed or had to be refreshed.
+ *  @param p_Engine Engine
+ *  @param Error    Result of the refresh
+ *  @param Now      Current time in milliseconds
+ */
+static void _CalDAV_Sync_Engine_Update(CalDAV_Sync_Engine_t *p_Engine, CalDAV_Error_t Error, int64_t Now)
+{
+    int64_t Due;
+
+    for (size_t i = 0; i < p_Engine->Count; i++) {
+        CalDAV_Sync_Calendar_t *p_Calendar = &p_Engine->p_Calendars[i];
+
+        if (Error == CALDAV_ERROR_OK) {
+            /* Every calendar is part of the snapshot, so each tag read before the refresh is current now */
+            if (p_Calendar->p_Pending != NULL) {
+                CUSTOM_FREE(p_Calendar->p_Tag);
+                p_Calendar->p_Tag = p_Calendar->p_Pending;
+                p_Calendar->p_Pending = NULL;
+            }
+
+            if (p_Calendar->IsChanged) {
+                p_Calendar->IntervalMs = p_Engine->IntervalMs;
+                _CalDAV_Sync_Engine_Schedule(p_Engine, p_Calendar, Now);
+            } else {
+                /* A new event may start before the next check, the check is then brought forward */
+                Due = p_Calendar->Due;
+                _CalDAV_Sync_Engine_Schedule(p_Engine, p_Calendar, Now);
+                if (Due < p_Calendar->Due) {
+                    p_Calendar->Due = Due;
+                }
+            }
+        } else if (p_Calendar->IsChanged) {
+            /* The tag is kept, so the calendar is found to be changed again */
+            CUSTOM_FREE(p_Calendar->p_Pending);
+            p_Calendar->p_Pending = NULL;
+            p_Calendar->Due = p_Engine->RefreshDue;
+        }
+
+        p_Calendar->IsChanged = false;
+    }
+}
+
+/** @brief          Sync task.
+ *  @param p_Arg    Engine
+ */
+static void _CalDAV_Sync_Engine_Task(void *p_Arg)
+{
+    CalDAV_Sync_Engine_t *p_Engine = (CalDAV_Sync_Engine_t *)p_Arg;
+
+    ESP_LOGD(TAG, "Sync task started");
+
+    while (p_Engine->IsStopping.load() == false) {
+        bool IsDue;
+        int64_t Now;
+        int64_t Wakeup;
+        CalDAV_Error_t Error = CALDAV_ERROR_OK;
+
+        Now = _CalDAV_Sync_Engine_Now();
+        IsDue = p_Engine->IsTriggered.exchange(false) || (Now >= p_Engine->RefreshDue);
+
+        if (p_Engine->p_Calendars != NULL) {
+            IsDue = _CalDAV_Sync_Engine_Check(p_Engine, Now, &Error) || IsDue;
+        }
+
+        if (IsDue) {
+            Error = _CalDAV_Sync_Engine_Refresh(p_Engine);
+            Now = _CalDAV_Sync_Engine_Now();
+
+            if (Error == CALDAV_ERROR_OK) {
+                p_Engine->Errors = 0;
+                p_Engine->RefreshDue = Now + ((p_Engine->p_Calendars != NULL) ? p_Engine->MaxIntervalMs :
+                                                                              p_Engine->IntervalMs);
+            } else {
+                ESP_LOGW(TAG, "Refresh failed: %d!", Error);
+                p_Engine->Errors++;
+                p_Engine->RefreshDue = Now + _CalDAV_Sync_Engine_Backoff(p_Engine, p_Engine->Errors);
+            }
+
+            if (p_Engine->p_Calendars != NULL) {
+                _CalDAV_Sync_Engine_Update(p_Engine, Error, Now);
+            }
+        }
+
+        if ((IsDue || (Error != CALDAV_ERROR_OK)) && (p_Engine->on_Update != NULL)) {
+            p_Engine->on_Update(Error, p_Engine->p_Arg);
+        }
+
+        Wakeup = p_Engine->RefreshDue;
+        if (p_Engine->p_Calendars != NULL) {
+            for (size_t i = 0; i < p_Engine->Count; i++) {
+                if (p_Engine->p_Calendars[i].Due < Wakeup) {
+                    Wakeup = p_Engine->p_Calendars[i].Due;
+                }
+            }
+        }
+
+        Now = _CalDAV_Sync_Engine_Now();
+
+        /* Woken up early by CalDAV_Sync_Engine_Trigger, CalDAV_Sync_Engine_Notify or CalDAV_Sync_Engine_Stop */
+        if (Wakeup > Now) {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(Wakeup - Now));
+        }
+    }
+
+    ESP_LOGD(TAG, "Sync task stopped");
+
+    xSemaphoreGive(p_Engine->Stopped);
+    vTaskDelete(NULL);
+}
+
+CalDAV_Error_t CalDAV_Sync_Engine_Start(CalDAV_Client_t *p_Client,
+                                        const CalDAV_Sync_Engine_Config_t *p_Config,
+                                        CalDAV_Sync_Engine_t **pp_Engine)
+{
+    CalDAV_Sync_Engine_t *p_Engine;
+
+    if ((p_Client == NULL) || (p_Client->IsInitialized == false) || (p_Config == NULL) ||
+        (p_Config->pp_CalendarPaths == NULL) || (p_Config->Count == 0) || (p_Config->IntervalMs == 0) ||
+        (p_Config->WindowLength == 0) || (pp_Engine == NULL)) {
+        return CALDAV_ERROR_INVALID_ARG;
+    }
+
+    /* A longest interval below the interval is a mistake in the configuration, not a request for a fixed interval */
+    if ((p_Config->MaxIntervalMs != 0) && (p_Config->MaxIntervalMs < p_Config->IntervalMs)) {
+        ESP_LOGE(TAG, "MaxIntervalMs (%u) is shorter than IntervalMs (%u)!", (unsigned int)p_Config->MaxIntervalMs,
+                 (unsigned int)p_Config->IntervalMs);
+
+        return CALDAV_ERROR_INVALID_ARG;
+    }
+
+    *pp_Engine = NULL;
+
+    p_Engine = new (std::nothrow) CalDAV_Sync_Engine_t();
+    if (p_Engine == NULL) {
+        return CALDAV_ERROR_NO_MEM;
+    }
+
+    p_Engine->p_Client = p_Client;
+    p_Engine->IntervalMs = p_Config->IntervalMs;
+    p_Engine->MaxIntervalMs = p_Config->MaxIntervalMs;
+    p_Engine->WindowStart = p_Config->WindowStart;
+    p_Engine->WindowLength = p_Config->WindowLength;
+    p_Engine->on_Update = p_Config->on_Update;
+    p_Engine->p_Arg = p_Config->p_Arg;
+    p_Engine->Published.store(CALDAV_SYNC_NO_SNAPSHOT);
+
+    p_Engine->pp_CalendarPaths = (char **)CUSTOM_MALLOC(p_Config->Count * sizeof(char *));
+    if (p_Engine->pp_CalendarPaths == NULL) {
+        _CalDAV_Sync_Engine_Free(p_Engine);
+
+        return CALDAV_ERROR_NO_MEM;
+    }
+    memset(p_Engine->pp_CalendarPaths, 0, p_Config->Count * sizeof(char *));
+
+    p_Engine->Count = p_Config->Count;
+    for (size_t i = 0; i < p_Config->Count; i++) {
+        p_Engine->pp_CalendarPaths[i] = _CalDAV_String_Duplicate(p_Config->pp_CalendarPaths[i]);
+        if (p_Engine->pp_CalendarPaths[i] == NULL) {
+            _CalDAV_Sync_Engine_Free(p_Engine);
+
+            return CALDAV_ERROR_NO_MEM;
+        }
+    }
+
+    /* The interval adapts to the changes only if it has room to grow */
+    if (p_Engine->MaxIntervalMs > p_Engine->IntervalMs) {
+        p_Engine->p_Calendars = new (std::nothrow) CalDAV_Sync_Calendar_t[p_Config->Count]();
+        if (p_Engine->p_Calendars == NULL) {
+            _CalDAV_Sync_Engine_Free(p_Engine);
+
+            return CALDAV_ERROR_NO_MEM;
+        }
+
+        for (size_t i = 0; i < p_Config->Count; i++) {
+            p_Engine->p_Calendars[i].IntervalMs = p_Engine->IntervalMs;
+        }
+    }
+
+    p_Engine->Stopped = xSemaphoreCreateBinary();
+    if (p_Engine->Stopped == NULL) {
+        _CalDAV_Sync_Engine_Free(p_Engine);
+
+        return CALDAV_ERROR_NO_MEM;
+    }
+
+    if (xTaskCreatePinnedToCore(_CalDAV_Sync_Engine_Task, "CalDAV-Sync", CONFIG_ESP32_CALDAV_SYNC_TASK_STACK,
+                                p_Engine, CONFIG_ESP32_CALDAV_SYNC_TASK_PRIORITY, &p_Engine->Task,
+                                CALDAV_SYNC_TASK_CORE) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create sync task!");
+        _CalDAV_Sync_Engine_Free(p_Engine);
+
+        return CALDAV_ERROR_NO_MEM;
+    }
+
+    *pp_Engine = p_Engine;
+
+    return CALDAV_ERROR_OK;
+}
+
+void CalDAV_Sync_Engine_Stop(CalDAV_Sync_Engine_t *p_Engine)
+{
+    if (p_Engine == NULL) {
+        return;
+    }
+
+    p_Engine->IsStopping.store(true);
+    xTaskNotifyGive(p_Engine->Task);
+    xSemaphoreTake(p_Engine->Stopped, portMAX_DELAY);
+
+    while ((p_Engine->Readers[0].load() > 0) || (p_Engine->Readers[1].load() > 0)) {
+        vTaskDelay(1);
+    }
+
+    _CalDAV_Sync_Engine_Free(p_Engine);
+}
+
+void CalDAV_Sync_Engine_Trigger(CalDAV_Sync_Engine_t *p_Engine)
+{
+    if (p_Engine == NULL) {
+        return;
+    }
+
+    p_Engine->IsTriggered.store(true);
+    xTaskNotifyGive(p_Engine->Task);
+}
+
+CalDAV_Error_t CalDAV_Sync_Engine_Notify(CalDAV_Sync_Engine_t *p_Engine, const char *p_CalendarPath)
+{
+    if ((p_Engine == NULL) || (p_CalendarPath == NULL)) {
+        return CALDAV_ERROR_INVALID_ARG;
+    }
+
+    for (size_t i = 0; i < p_Engine->Count; i++) {
+        if (strcmp(p_Engine->pp_CalendarPaths[i], p_CalendarPath) == 0) {
+            /* With a fixed interval every refresh covers all calendars */
+            if (p_Engine->p_Calendars != NULL) {
+                p_Engine->p_Calendars[i].IsNotified.store(true);
+            } else {
+                p_Engine->IsTriggered.store(true);
+            }
+
+            xTaskNotifyGive(p_Engine->Task);
+
+            return CALDAV_ERROR_OK;
+        }
+    }
+
+    return CALDAV_ERROR_NOT_FOUND;
+}
+
+const CalDAV_Sync_Snapshot_t *CalDAV_Sync_Engine_Acquire(CalDAV_Sync_Engine_t *p_Engine)
+{
+    int Index;
+
+    if (p_Engine == NULL) {
+        return NULL;
+    }
+
+    while (true) {
+        Index = p_Engine->Published.load();
+        if (Index == CALDAV_SYNC_NO_SNAPSHOT) {
+            return NULL;
+        }
+
+        p_Engine->Readers[Index]++;
+
+        /* The snapshot is only safe if it is still published after counting in */
+        if (p_Engine->Published.load() == Index) {
+            return &p_Engine->Snapshots[Index];
+        }
+
+        p_Engine->Readers[Index]--;
+    }
+}
+
+void CalDAV_Sync_Engine_Release(CalDAV_Sync_Engine_t *p_Engine, const CalDAV_Sync_Snapshot_t *p_Snapshot)
+{
+    if ((p_Engine == NULL) || (p_Snapshot == NULL)) {
+        return;
+    }
+
+    p_Engine->Readers[p_Snapshot - p_Engine->Snapshots]--;
+}
+
+#endif
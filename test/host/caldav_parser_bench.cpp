@@ -0,0 +1,377 @@
+/*
+ * caldav_parser_bench.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2026
+ *  Website: www.kampis-elektroecke.de
+ *  File info: Parse throughput and allocations of the parser for recorded server responses.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <dirent.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "caldav_parser.h"
+
+/* Working buffer and chunk size of a streamed response, like the client with the default configuration receives
+   it over a TCP connection */
+#define CALDAV_BENCH_BUFFER_LENGTH          4096
+#define CALDAV_BENCH_CHUNK_LENGTH           1460
+
+/** @brief Result of the callbacks of one parse.
+ */
+typedef struct {
+    size_t Responses;                       /**< Number of response blocks. */
+    size_t Events;                          /**< Number of events (recurring events once per instance). */
+    size_t Periods;                         /**< Number of busy periods. */
+} CalDAV_Bench_Count_t;
+
+/** @brief Measurement of one response in one parse mode.
+ */
+typedef struct {
+    double Throughput;                      /**< Parsed data in MB/s. */
+    double Allocations;                     /**< Heap allocations per parse. */
+    CalDAV_Bench_Count_t Count;             /**< Result of the last parse. */
+} CalDAV_Bench_Result_t;
+
+static bool _CalDAV_Bench_Is_Counting = false;
+static size_t _CalDAV_Bench_Allocations = 0;
+
+#if defined(__GLIBC__)
+/* All allocations of the process are counted while a parse runs. The parser itself should never allocate */
+extern "C" void *__libc_malloc(size_t Size);
+extern "C" void *__libc_calloc(size_t Count, size_t Size);
+extern "C" void *__libc_realloc(void *p_Memory, size_t Size);
+extern "C" void __libc_free(void *p_Memory);
+
+extern "C" void *malloc(size_t Size)
+{
+    if (_CalDAV_Bench_Is_Counting) {
+        _CalDAV_Bench_Allocations++;
+    }
+
+    return __libc_malloc(Size);
+}
+
+extern "C" void *calloc(size_t Count, size_t Size)
+{
+    if (_CalDAV_Bench_Is_Counting) {
+        _CalDAV_Bench_Allocations++;
+    }
+
+    return __libc_calloc(Count, Size);
+}
+
+extern "C" void *realloc(void *p_Memory, size_t Size)
+{
+    if (_CalDAV_Bench_Is_Counting) {
+        _CalDAV_Bench_Allocations++;
+    }
+
+    return __libc_realloc(p_Memory, Size);
+}
+
+extern "C" void free(void *p_Memory)
+{
+    __libc_free(p_Memory);
+}
+#endif
+
+static bool on_Response(const CalDAV_Parser_Response_t *p_Response, void *p_Arg)
+{
+    ((CalDAV_Bench_Count_t *)p_Arg)->Responses++;
+
+    return true;
+}
+
+static bool on_Event(const CalDAV_Calendar_Event_t *p_Event, void *p_Arg)
+{
+    ((CalDAV_Bench_Count_t *)p_Arg)->Events++;
+
+    return true;
+}
+
+static bool on_Period(time_t Start, time_t End, void *p_Arg)
+{
+    ((CalDAV_Bench_Count_t *)p_Arg)->Periods++;
+
+    return true;
+}
+
+/** @brief          Finds an element tag of a response block with any namespace prefix.
+ *  @param Data     Response
+ *  @param IsEnd    Search an end tag, otherwise a start tag
+ *  @param IsLast   Search the last tag, otherwise the first one
+ *  @return         Position of the '<' of the tag or std::string::npos
+ */
+static size_t _CalDAV_Bench_Find_Response(const std::string &Data, bool IsEnd, bool IsLast)
+{
+    size_t Found = std::string::npos;
+
+    for (size_t i = 0; i < Data.size(); i++) {
+        size_t Name = i + (IsEnd ? 2 : 1);
+        size_t Prefix;
+
+        if ((Data[i] != '<') || (IsEnd != (Data.compare(i, 2, "</") == 0))) {
+            continue;
+        }
+
+        /* Optional namespace prefix */
+        Prefix = Name;
+        while ((Prefix < Data.size()) && (isalnum((unsigned char)Data[Prefix]) || (Data[Prefix] == '_'))) {
+            Prefix++;
+        }
+
+        if ((Prefix < Data.size()) && (Data[Prefix] == ':')) {
+            Name = Prefix + 1;
+        }
+
+        if ((Data.compare(Name, 8, "response") == 0) && ((Data[Name + 8] == '>') || (Data[Name + 8] == ' '))) {
+            Found = i;
+
+            if (IsLast == false) {
+                break;
+            }
+        }
+    }
+
+    return Found;
+}
+
+/** @brief          Scales a multistatus to a size by repeating its response blocks, so the structure of the
+ *                  recorded response is kept. A plain iCalendar body is returned unchanged.
+ *  @param Data     Recorded response
+ *  @param Size     Requested size
+ *  @return         Scaled response
+ */
+static std::string _CalDAV_Bench_Scale(const std::string &Data, size_t Size)
+{
+    size_t First = _CalDAV_Bench_Find_Response(Data, false, false);
+    size_t Last = _CalDAV_Bench_Find_Response(Data, true, true);
+    std::string Blocks;
+    std::string Result;
+
+    if ((First == std::string::npos) || (Last == std::string::npos) || (Last < First)) {
+        return Data;
+    }
+
+    Last = Data.find('>', Last) + 1;
+    Blocks = Data.substr(First, Last - First);
+    Result = Data.substr(0, First);
+
+    do {
+        Result += Blocks;
+    } while ((Result.size() + Blocks.size() + (Data.size() - Last)) <= Size);
+
+    Result += Data.substr(Last);
+
+    return Result;
+}
+
+/** @brief              Parses a response once.
+ *  @param Data         Response
+ *  @param IsInPlace    Parse the complete response in place, otherwise feed it in chunks
+ *  @param IsICalendar  The response is a plain iCalendar body
+ *  @param p_Buffer     Working buffer for a streamed response or a copy of the response
+ *  @param p_Count      Pointer to store the result of the callbacks
+ */
+static void _CalDAV_Bench_Parse(const std::string &Data, bool IsInPlace, bool IsICalendar, char *p_Buffer,
+                                CalDAV_Bench_Count_t *p_Count)
+{
+    CalDAV_Parser_t Parser;
+
+    memset(p_Count, 0, sizeof(CalDAV_Bench_Count_t));
+
+    if (IsInPlace) {
+        memcpy(p_Buffer, Data.data(), Data.size());
+        CalDAV_Parser_Parse_In_Place(&Parser, p_Buffer, Data.size(), on_Response, on_Event, p_Count);
+
+        return;
+    }
+
+    CalDAV_Parser_Init(&Parser, p_Buffer, CALDAV_BENCH_BUFFER_LENGTH, on_Response, on_Event, p_Count);
+
+    if (IsICalendar) {
+        CalDAV_Parser_Set_Free_Busy(&Parser, on_Period);
+        CalDAV_Parser_iCalendar_Begin(&Parser);
+    }
+
+    for (size_t Offset = 0; Offset < Data.size(); Offset += CALDAV_BENCH_CHUNK_LENGTH) {
+        CalDAV_Parser_Feed(&Parser, Data.data() + Offset, std::min((size_t)CALDAV_BENCH_CHUNK_LENGTH,
+                                                                     Data.size() - Offset));
+    }
+
+    if (IsICalendar) {
+        CalDAV_Parser_iCalendar_End(&Parser);
+    }
+}
+
+/** @brief              Measures a response in one parse mode.
+ *  @param Data         Response
+ *  @param IsInPlace    Parse the complete response in place, otherwise feed it in chunks
+ *  @param IsICalendar  The response is a plain iCalendar body
+ *  @param Time         Minimum measurement time in seconds
+ *  @return             Measurement
+ */
+static CalDAV_Bench_Result_t _CalDAV_Bench_Measure(const std::string &Data, bool IsInPlace, bool IsICalendar,
+                                                   double Time)
+{
+    CalDAV_Bench_Result_t Result;
+    std::vector<char> Buffer(std::max(Data.size(), (size_t)CALDAV_BENCH_BUFFER_LENGTH));
+    size_t Runs = 0;
+    double Elapsed = 0;
+    std::chrono::steady_clock::time_point Start;
+
+    /* Warm up */
+    _CalDAV_Bench_Parse(Data, IsInPlace, IsICalendar, Buffer.data(), &Result.Count);
+
+    _CalDAV_Bench_Allocations = 0;
+    Start = std::chrono::steady_clock::now();
+
+    do {
+        _CalDAV_Bench_Is_Counting = true;
+        _CalDAV_Bench_Parse(Data, IsInPlace, IsICalendar, Buffer.data(), &Result.Count);
+        _CalDAV_Bench_Is_Counting = false;
+
+        Runs++;
+        Elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+    } while (Elapsed < Time);
+
+    Result.Throughput = ((double)Data.size() * Runs) / (Elapsed * 1024.0 * 1024.0);
+    Result.Allocations = (double)_CalDAV_Bench_Allocations / Runs;
+
+    return Result;
+}
+
+/** @brief          Reads a file.
+ *  @param Path     Path of the file
+ *  @param p_Data   Pointer to store the content
+ *  @return         true on success
+ */
+static bool _CalDAV_Bench_Read(const std::string &Path, std::string *p_Data)
+{
+    FILE *p_File = fopen(Path.c_str(), "rb");
+    char Chunk[4096];
+    size_t Length;
+
+    if (p_File == NULL) {
+        return false;
+    }
+
+    p_Data->clear();
+    while ((Length = fread(Chunk, 1, sizeof(Chunk), p_File)) > 0) {
+        p_Data->append(Chunk, Length);
+    }
+
+    fclose(p_File);
+
+    return true;
+}
+
+/* Replays every fixture from 1 KB to 1 MB:
+   caldav_parser_bench [--fixtures <directory>] [--max <bytes>] [--time <seconds>] */
+int main(int argc, char **argv)
+{
+    static const size_t Sizes[] = {1024, 16 * 1024, 64 * 1024, 256 * 1024, 1024 * 1024};
+    std::string Directory = CALDAV_FIXTURE_DIR;
+    size_t Max = 1024 * 1024;
+    double Time = 0.2;
+    std::vector<std::string> Names;
+    DIR *p_Directory;
+    struct dirent *p_Entry;
+
+    for (int i = 1; (i + 1) < argc; i += 2) {
+        if (strcmp(argv[i], "--fixtures") == 0) {
+            Directory = argv[i + 1];
+        } else if (strcmp(argv[i], "--max") == 0) {
+            Max = strtoul(argv[i + 1], NULL, 10);
+        } else if (strcmp(argv[i], "--time") == 0) {
+            Time = atof(argv[i + 1]);
+        }
+    }
+
+    p_Directory = opendir(Directory.c_str());
+    if (p_Directory == NULL) {
+        fprintf(stderr, "Can not open %s!\n", Directory.c_str());
+
+        return 1;
+    }
+
+    while ((p_Entry = readdir(p_Directory)) != NULL) {
+        if (p_Entry->d_name[0] != '.') {
+            Names.push_back(p_Entry->d_name);
+        }
+    }
+
+    closedir(p_Directory);
+    std::sort(Names.begin(), Names.end());
+
+    printf("%-34s %-8s %9s %10s %9s %9s %7s\n", "Fixture", "Mode", "Size", "MB/s", "Responses", "Events",
+           "Allocs");
+
+    for (const std::string &Name : Names) {
+        std::string Data;
+        bool IsICalendar = (Name.size() > 4) && (Name.compare(Name.size() - 4, 4, ".ics") == 0);
+
+        if (_CalDAV_Bench_Read(Directory + "/" + Name, &Data) == false) {
+            fprintf(stderr, "Can not read %s!\n", Name.c_str());
+
+            return 1;
+        }
+
+        for (size_t i = 0; i < (sizeof(Sizes) / sizeof(Sizes[0])); i++) {
+            std::string Scaled;
+
+            if ((Sizes[i] > Max) || (IsICalendar && (i > 0))) {
+                break;
+            }
+
+            Scaled = IsICalendar ? Data : _CalDAV_Bench_Scale(Data, Sizes[i]);
+
+            /* A plain iCalendar body is only streamed like the client does */
+            for (int IsInPlace = 0; IsInPlace < (IsICalendar ? 1 : 2); IsInPlace++) {
+                CalDAV_Bench_Result_t Result = _CalDAV_Bench_Measure(Scaled, IsInPlace, IsICalendar, Time);
+
+                printf("%-34s %-8s %9u %10.1f %9u %9u %7.1f\n", Name.c_str(), IsInPlace ? "in-place" : "stream",
+                       (unsigned int)Scaled.size(), Result.Throughput, (unsigned int)Result.Count.Responses,
+                       (unsigned int)(Result.Count.Events + Result.Count.Periods), Result.Allocations);
+
+                if (Result.Allocations > 0) {
+                    fprintf(stderr, "The parser has allocated memory!\n");
+
+                    return 1;
+                }
+
+                if ((Result.Count.Responses + Result.Count.Events + Result.Count.Periods) == 0) {
+                    fprintf(stderr, "Nothing parsed from %s!\n", Name.c_str());
+
+                    return 1;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
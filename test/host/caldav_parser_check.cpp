@@ -0,0 +1,349 @@
+/*
+ * caldav_parser_check.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2026
+ *  Website: www.kampis-elektroecke.de
+ *  File info: Expected parse results of the recorded server responses.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "caldav_parser.h"
+
+/* Working buffer of a streamed response, like CONFIG_ESP32_CALDAV_BUFFER_LENGTH by default */
+#define CALDAV_CHECK_BUFFER_LENGTH          4096
+
+/* Maximum number of events or busy periods of one case */
+#define CALDAV_CHECK_MAX_ITEMS              16
+
+/** @brief Expected event.
+ */
+typedef struct {
+    time_t Start;                           /**< Start in seconds since 1970 (UTC). */
+    time_t End;                             /**< End in seconds since 1970 (UTC). */
+    int32_t Offset;                         /**< UTC offset of the start in seconds. */
+    bool IsAllDay;                          /**< The event starts on a date. */
+} CalDAV_Check_Event_t;
+
+/** @brief Expected busy period.
+ */
+typedef struct {
+    time_t Start;                           /**< Start in seconds since 1970 (UTC). */
+    time_t End;                             /**< End in seconds since 1970 (UTC). */
+} CalDAV_Check_Period_t;
+
+/** @brief Expected result of one fixture, in the order the callbacks report it.
+ */
+typedef struct {
+    const char *Name;                       /**< File name of the fixture. */
+    int WindowStart[3];                     /**< Start of the recurrence window as year, month, day or all 0. */
+    int WindowEnd[3];                       /**< End of the recurrence window as year, month, day. */
+    size_t Responses;                       /**< Number of response blocks (including the multistatus block). */
+    size_t Events;                          /**< Number of events. */
+    CalDAV_Check_Event_t Event[CALDAV_CHECK_MAX_ITEMS];     /**< Expected events. */
+    size_t Periods;                         /**< Number of busy periods. */
+    CalDAV_Check_Period_t Period[CALDAV_CHECK_MAX_ITEMS];   /**< Expected busy periods. */
+} CalDAV_Check_Case_t;
+
+/** @brief Result of the callbacks of one parse.
+ */
+typedef struct {
+    size_t Responses;                       /**< Number of response blocks. */
+    std::vector<CalDAV_Check_Event_t> Events;       /**< Reported events. */
+    std::vector<CalDAV_Check_Period_t> Periods;     /**< Reported busy periods. */
+} CalDAV_Check_Result_t;
+
+static const CalDAV_Check_Case_t _CalDAV_Check_Cases[] = {
+    /* Event with an overridden instance, the override is a second VEVENT with the same UID */
+    {
+        "baikal_event_get.ics", {0, 0, 0}, {0, 0, 0}, 0,
+        2, {{1768834800, 1768838400, 0, false}, {1769443200, 1769446800, 0, false}},
+        0, {},
+    },
+    {
+        "baikal_sync_collection.xml", {0, 0, 0}, {0, 0, 0}, 3,
+        2, {{1768834800, 1768838400, 0, false}, {1769443200, 1769446800, 0, false}},
+        0, {},
+    },
+    /* America/New_York with its own VTIMEZONE */
+    {
+        "icloud_calendar_query.xml", {0, 0, 0}, {0, 0, 0}, 2,
+        2, {{1768320000, 1768323600, -18000, false}, {1768586400, 1768591800, 0, false}},
+        0, {},
+    },
+    /* Europe/Berlin, an all-day event and an end from DURATION:PT1H30M */
+    /* Durations with too many digits or above the longest duration are ignored, the events have no duration and the
+       busy periods are dropped */
+    {
+        "malformed_durations.ics", {0, 0, 0}, {0, 0, 0}, 0,
+        3, {{1767258000, 1767258000, 0, false}, {1767344400, 1767344400, 0, false},
+            {1767430800, 1768730400, 0, false}},
+        1, {{1767268800, 1767272400}},
+    },
+    {
+        "nextcloud_calendar_query.xml", {0, 0, 0}, {0, 0, 0}, 3,
+        3, {{1768206600, 1768208400, 3600, false}, {1768348800, 1768435200, 0, true},
+            {1768309200, 1768314600, 3600, false}},
+        0, {},
+    },
+    {
+        "nextcloud_free_busy.ics", {0, 0, 0}, {0, 0, 0}, 0,
+        0, {},
+        4, {{1768206600, 1768208400}, {1768293000, 1768294800}, {1768309200, 1768314600}, {1768384800, 1768388400}},
+    },
+    {
+        "nextcloud_propfind_calendars.xml", {0, 0, 0}, {0, 0, 0}, 5,
+        0, {},
+        0, {},
+    },
+    /* DAILY;COUNT=6 in Europe/Berlin across the start of the daylight saving time on 2026-03-29: 03-28 is an
+       EXDATE and 03-30 is moved to 11:00 by a RECURRENCE-ID, the override is reported first. Then
+       MONTHLY;BYDAY=-1FR;COUNT=4 from 2026-01-30, the last instance is in daylight saving time */
+    {
+        "nextcloud_recurring_query.xml", {2026, 1, 1}, {2027, 1, 1}, 2,
+        9, {{1774861200, 1774864800, 7200, false}, {1774512000, 1774515600, 3600, false},
+            {1774598400, 1774602000, 3600, false}, {1774767600, 1774771200, 7200, false},
+            {1774940400, 1774944000, 7200, false}, {1769785200, 1769788800, 3600, false},
+            {1772204400, 1772208000, 3600, false}, {1774623600, 1774627200, 3600, false},
+            {1777039200, 1777042800, 7200, false}},
+        0, {},
+    },
+    /* Without a window a recurring event is reported once, as written */
+    {
+        "radicale_calendar_query.xml", {0, 0, 0}, {0, 0, 0}, 2,
+        2, {{1768204800, 1768206600, 0, false}, {1768867200, 1768953600, 0, true}},
+        0, {},
+    },
+    /* WEEKLY;INTERVAL=2;BYDAY=MO and the all-day MONTHLY;BYMONTHDAY=20 within January and February */
+    {
+        "radicale_calendar_query.xml", {2026, 1, 1}, {2026, 3, 1}, 2,
+        6, {{1768204800, 1768206600, 0, false}, {1769414400, 1769416200, 0, false},
+            {1770624000, 1770625800, 0, false}, {1771833600, 1771835400, 0, false},
+            {1768867200, 1768953600, 0, true}, {1771545600, 1771632000, 0, true}},
+        0, {},
+    },
+};
+
+static bool on_Response(const CalDAV_Parser_Response_t *p_Response, void *p_Arg)
+{
+    ((CalDAV_Check_Result_t *)p_Arg)->Responses++;
+
+    return true;
+}
+
+static bool on_Event(const CalDAV_Calendar_Event_t *p_Event, void *p_Arg)
+{
+    ((CalDAV_Check_Result_t *)p_Arg)->Events.push_back({p_Event->Start, p_Event->End, p_Event->Offset,
+                                                        p_Event->IsAllDay});
+
+    return true;
+}
+
+static bool on_Period(time_t Start, time_t End, void *p_Arg)
+{
+    ((CalDAV_Check_Result_t *)p_Arg)->Periods.push_back({Start, End});
+
+    return true;
+}
+
+/** @brief          Sets the recurrence window of a case.
+ *  @param p_Parser Initialized parser
+ *  @param p_Case   Case
+ */
+static void _CalDAV_Check_Window(CalDAV_Parser_t *p_Parser, const CalDAV_Check_Case_t *p_Case)
+{
+    struct tm Start = {};
+    struct tm End = {};
+
+    if (p_Case->WindowStart[0] == 0) {
+        return;
+    }
+
+    Start.tm_year = p_Case->WindowStart[0] - 1900;
+    Start.tm_mon = p_Case->WindowStart[1] - 1;
+    Start.tm_mday = p_Case->WindowStart[2];
+    End.tm_year = p_Case->WindowEnd[0] - 1900;
+    End.tm_mon = p_Case->WindowEnd[1] - 1;
+    End.tm_mday = p_Case->WindowEnd[2];
+    CalDAV_Parser_Set_Window(p_Parser, &Start, &End);
+}
+
+/** @brief              Parses a fixture once.
+ *  @param p_Case       Case
+ *  @param Data         Response
+ *  @param Chunk        Chunk size of a streamed response or 0 to parse it in place
+ *  @param p_Result     Pointer to store the result of the callbacks
+ */
+static void _CalDAV_Check_Parse(const CalDAV_Check_Case_t *p_Case, const std::string &Data, size_t Chunk,
+                                CalDAV_Check_Result_t *p_Result)
+{
+    bool IsICalendar = (strstr(p_Case->Name, ".ics") != NULL);
+    std::vector<char> Buffer(std::max(Data.size(), (size_t)CALDAV_CHECK_BUFFER_LENGTH));
+    CalDAV_Parser_t Parser;
+
+    p_Result->Responses = 0;
+    p_Result->Events.clear();
+    p_Result->Periods.clear();
+
+    CalDAV_Parser_Init(&Parser, Buffer.data(), CALDAV_CHECK_BUFFER_LENGTH, on_Response, on_Event, p_Result);
+    _CalDAV_Check_Window(&Parser, p_Case);
+
+    if (Chunk == 0) {
+        memcpy(Buffer.data(), Data.data(), Data.size());
+        CalDAV_Parser_Parse_In_Place(&Parser, Buffer.data(), Data.size(), on_Response, on_Event, p_Result);
+
+        return;
+    }
+
+    if (IsICalendar) {
+        CalDAV_Parser_Set_Free_Busy(&Parser, on_Period);
+        CalDAV_Parser_iCalendar_Begin(&Parser);
+    }
+
+    for (size_t Offset = 0; Offset < Data.size(); Offset += Chunk) {
+        CalDAV_Parser_Feed(&Parser, Data.data() + Offset, std::min(Chunk, Data.size() - Offset));
+    }
+
+    if (IsICalendar) {
+        CalDAV_Parser_iCalendar_End(&Parser);
+    }
+}
+
+/** @brief              Compares the result of a parse with the expected values of a case.
+ *  @param p_Case       Case
+ *  @param p_Result     Result of the parse
+ *  @param p_Mode       Name of the parse mode for the messages
+ *  @return             Number of differences
+ */
+static int _CalDAV_Check_Compare(const CalDAV_Check_Case_t *p_Case, const CalDAV_Check_Result_t *p_Result,
+                                 const char *p_Mode)
+{
+    int Errors = 0;
+
+    if ((p_Result->Responses != p_Case->Responses) || (p_Result->Events.size() != p_Case->Events) ||
+        (p_Result->Periods.size() != p_Case->Periods)) {
+        fprintf(stderr, "%s (%s): %u responses, %u events, %u periods instead of %u, %u, %u!\n", p_Case->Name,
+                p_Mode, (unsigned int)p_Result->Responses, (unsigned int)p_Result->Events.size(),
+                (unsigned int)p_Result->Periods.size(), (unsigned int)p_Case->Responses,
+                (unsigned int)p_Case->Events, (unsigned int)p_Case->Periods);
+
+        return 1;
+    }
+
+    for (size_t i = 0; i < p_Case->Events; i++) {
+        const CalDAV_Check_Event_t *p_Expected = &p_Case->Event[i];
+        const CalDAV_Check_Event_t *p_Event = &p_Result->Events[i];
+
+        if ((p_Event->Start != p_Expected->Start) || (p_Event->End != p_Expected->End) ||
+            (p_Event->Offset != p_Expected->Offset) || (p_Event->IsAllDay != p_Expected->IsAllDay)) {
+            fprintf(stderr, "%s (%s): event %u is %lld - %lld, offset %d, all-day %d instead of %lld - %lld, "
+                    "offset %d, all-day %d!\n", p_Case->Name, p_Mode, (unsigned int)i, (long long)p_Event->Start,
+                    (long long)p_Event->End, (int)p_Event->Offset, p_Event->IsAllDay, (long long)p_Expected->Start,
+                    (long long)p_Expected->End, (int)p_Expected->Offset, p_Expected->IsAllDay);
+            Errors++;
+        }
+    }
+
+    for (size_t i = 0; i < p_Case->Periods; i++) {
+        const CalDAV_Check_Period_t *p_Expected = &p_Case->Period[i];
+        const CalDAV_Check_Period_t *p_Period = &p_Result->Periods[i];
+
+        if ((p_Period->Start != p_Expected->Start) || (p_Period->End != p_Expected->End)) {
+            fprintf(stderr, "%s (%s): period %u is %lld - %lld instead of %lld - %lld!\n", p_Case->Name, p_Mode,
+                    (unsigned int)i, (long long)p_Period->Start, (long long)p_Period->End,
+                    (long long)p_Expected->Start, (long long)p_Expected->End);
+            Errors++;
+        }
+    }
+
+    return Errors;
+}
+
+/** @brief          Reads a file.
+ *  @param Path     Path of the file
+ *  @param p_Data   Pointer to store the content
+ *  @return         true on success
+ */
+static bool _CalDAV_Check_Read(const std::string &Path, std::string *p_Data)
+{
+    FILE *p_File = fopen(Path.c_str(), "rb");
+    char Chunk[4096];
+    size_t Length;
+
+    if (p_File == NULL) {
+        return false;
+    }
+
+    p_Data->clear();
+    while ((Length = fread(Chunk, 1, sizeof(Chunk), p_File)) > 0) {
+        p_Data->append(Chunk, Length);
+    }
+
+    fclose(p_File);
+
+    return true;
+}
+
+/* Parses every case streamed in TCP sized and in single byte chunks and, for a multistatus, in place:
+   caldav_parser_check [--fixtures <directory>] */
+int main(int argc, char **argv)
+{
+    std::string Directory = CALDAV_FIXTURE_DIR;
+    CalDAV_Check_Result_t Result;
+    int Errors = 0;
+
+    if ((argc == 3) && (strcmp(argv[1], "--fixtures") == 0)) {
+        Directory = argv[2];
+    }
+
+    for (size_t i = 0; i < (sizeof(_CalDAV_Check_Cases) / sizeof(_CalDAV_Check_Cases[0])); i++) {
+        const CalDAV_Check_Case_t *p_Case = &_CalDAV_Check_Cases[i];
+        bool IsICalendar = (strstr(p_Case->Name, ".ics") != NULL);
+        std::string Data;
+
+        if (_CalDAV_Check_Read(Directory + "/" + p_Case->Name, &Data) == false) {
+            fprintf(stderr, "Can not read %s!\n", p_Case->Name);
+
+            return 1;
+        }
+
+        _CalDAV_Check_Parse(p_Case, Data, 1460, &Result);
+        Errors += _CalDAV_Check_Compare(p_Case, &Result, "stream");
+
+        _CalDAV_Check_Parse(p_Case, Data, 1, &Result);
+        Errors += _CalDAV_Check_Compare(p_Case, &Result, "bytes");
+
+        /* A plain iCalendar body is only streamed like the client does */
+        if (IsICalendar == false) {
+            _CalDAV_Check_Parse(p_Case, Data, 0, &Result);
+            Errors += _CalDAV_Check_Compare(p_Case, &Result, "in-place");
+        }
+    }
+
+    printf("%u cases, %d differences\n", (unsigned int)(sizeof(_CalDAV_Check_Cases) / sizeof(_CalDAV_Check_Cases[0])),
+           Errors);
+
+    return (Errors == 0) ? 0 : 1;
+}
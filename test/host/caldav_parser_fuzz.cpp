@@ -0,0 +1,342 @@
+/*
+ * caldav_parser_fuzz.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2026
+ *  Website: www.kampis-elektroecke.de
+ *  File info: Fuzz target for the multistatus and iCalendar parser.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "caldav_parser.h"
+
+/* The first two bytes of an input select how it is parsed, the rest is the response */
+#define CALDAV_FUZZ_HEADER                  2
+
+/** @brief Ways to pass a response to the parser.
+ */
+typedef enum {
+    CALDAV_FUZZ_MODE_FEED = 0,              /**< Multistatus in chunks with CalDAV_Parser_Feed. */
+    CALDAV_FUZZ_MODE_FEED_WINDOW,           /**< Like CALDAV_FUZZ_MODE_FEED with a recurrence window. */
+    CALDAV_FUZZ_MODE_IN_PLACE,              /**< Complete multistatus with CalDAV_Parser_Parse_In_Place. */
+    CALDAV_FUZZ_MODE_ICALENDAR,             /**< Plain iCalendar body in chunks with free busy periods. */
+    CALDAV_FUZZ_MODES,
+} CalDAV_Fuzz_Mode_t;
+
+/* Working buffer sizes, from values that barely fit to the default of CONFIG_ESP32_CALDAV_BUFFER_LENGTH */
+static const size_t _CalDAV_Fuzz_Buffer_Sizes[] = {48, 160, 512, 1552, 4096};
+
+/** @brief          Small deterministic generator for the chunk sizes, so every input is replayed exactly.
+ *  @param p_State  Generator state
+ *  @return         Next value
+ */
+static uint32_t _CalDAV_Fuzz_Random(uint32_t *p_State)
+{
+    *p_State ^= *p_State << 13;
+    *p_State ^= *p_State >> 17;
+    *p_State ^= *p_State << 5;
+
+    return *p_State;
+}
+
+/** @brief          Reads every byte of a string the parser has passed out, so ASan sees invalid pointers.
+ *  @param p_String String or NULL
+ *  @return         Length of the string
+ */
+static size_t _CalDAV_Fuzz_Touch(const char *p_String)
+{
+    return (p_String != NULL) ? strlen(p_String) : 0;
+}
+
+static bool on_Response(const CalDAV_Parser_Response_t *p_Response, void *p_Arg)
+{
+    size_t *p_Sum = (size_t *)p_Arg;
+
+    *p_Sum += _CalDAV_Fuzz_Touch(p_Response->Href) + _CalDAV_Fuzz_Touch(p_Response->DisplayName) +
+              _CalDAV_Fuzz_Touch(p_Response->Description) + _CalDAV_Fuzz_Touch(p_Response->CTag) +
+              _CalDAV_Fuzz_Touch(p_Response->SyncToken) + _CalDAV_Fuzz_Touch(p_Response->ETag) +
+              _CalDAV_Fuzz_Touch(p_Response->CurrentUserPrincipal) + _CalDAV_Fuzz_Touch(p_Response->CalendarHome);
+
+    return true;
+}
+
+static bool on_Event(const CalDAV_Calendar_Event_t *p_Event, void *p_Arg)
+{
+    size_t *p_Sum = (size_t *)p_Arg;
+
+    *p_Sum += _CalDAV_Fuzz_Touch(p_Event->UID) + _CalDAV_Fuzz_Touch(p_Event->Summary) +
+              _CalDAV_Fuzz_Touch(p_Event->Description) + _CalDAV_Fuzz_Touch(p_Event->StartTime) +
+              _CalDAV_Fuzz_Touch(p_Event->EndTime) + _CalDAV_Fuzz_Touch(p_Event->Location);
+
+    return true;
+}
+
+static bool on_Period(time_t Start, time_t End, void *p_Arg)
+{
+    size_t *p_Sum = (size_t *)p_Arg;
+
+    if (End <= Start) {
+        fprintf(stderr, "Empty busy period reported!\n");
+        abort();
+    }
+
+    (*p_Sum)++;
+
+    return true;
+}
+
+/** @brief          Feeds a response in chunks of random size.
+ *  @param p_Parser Initialized parser
+ *  @param p_Data   Response
+ *  @param Size     Length of the response
+ *  @param Seed     Seed for the chunk sizes
+ */
+static void _CalDAV_Fuzz_Feed(CalDAV_Parser_t *p_Parser, const char *p_Data, size_t Size, uint32_t Seed)
+{
+    uint32_t State = Seed | 1;
+    size_t Offset = 0;
+
+    while (Offset < Size) {
+        size_t Chunk = 1 + (_CalDAV_Fuzz_Random(&State) % 1460);
+
+        if (Chunk > (Size - Offset)) {
+            Chunk = Size - Offset;
+        }
+
+        CalDAV_Parser_Feed(p_Parser, p_Data + Offset, Chunk);
+        Offset += Chunk;
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *p_Data, size_t Size)
+{
+    CalDAV_Parser_t Parser;
+    CalDAV_Fuzz_Mode_t Mode;
+    size_t BufferSize;
+    size_t Sum = 0;
+    char *p_Buffer;
+    const char *p_Response = (const char *)p_Data + CALDAV_FUZZ_HEADER;
+    size_t Length;
+    struct tm Start = {};
+    struct tm End = {};
+
+    if (Size < CALDAV_FUZZ_HEADER) {
+        return 0;
+    }
+
+    Mode = (CalDAV_Fuzz_Mode_t)(p_Data[0] % CALDAV_FUZZ_MODES);
+    BufferSize = _CalDAV_Fuzz_Buffer_Sizes[(p_Data[0] / CALDAV_FUZZ_MODES) %
+                                           (sizeof(_CalDAV_Fuzz_Buffer_Sizes) / sizeof(_CalDAV_Fuzz_Buffer_Sizes[0]))];
+    Length = Size - CALDAV_FUZZ_HEADER;
+
+    /* Exactly sized heap copies, so every access behind them is reported */
+    if (Mode == CALDAV_FUZZ_MODE_IN_PLACE) {
+        /* Parse_In_Place keeps the window of the parser, so it must not be read uninitialized */
+        memset(&Parser, 0, sizeof(Parser));
+
+        p_Buffer = (char *)malloc((Length > 0) ? Length : 1);
+        memcpy(p_Buffer, p_Response, Length);
+
+        CalDAV_Parser_Parse_In_Place(&Parser, p_Buffer, Length, on_Response, on_Event, &Sum);
+        free(p_Buffer);
+
+        return 0;
+    }
+
+    p_Buffer = (char *)malloc(BufferSize);
+    CalDAV_Parser_Init(&Parser, p_Buffer, BufferSize, on_Response, on_Event, &Sum);
+
+    if (Mode == CALDAV_FUZZ_MODE_FEED_WINDOW) {
+        Start.tm_year = 126;
+        Start.tm_mday = 1;
+        End.tm_year = 126;
+        End.tm_mon = 2;
+        End.tm_mday = 1;
+        CalDAV_Parser_Set_Window(&Parser, &Start, &End);
+    }
+
+    if (Mode == CALDAV_FUZZ_MODE_ICALENDAR) {
+        CalDAV_Parser_Set_Free_Busy(&Parser, on_Period);
+        CalDAV_Parser_iCalendar_Begin(&Parser);
+    }
+
+    _CalDAV_Fuzz_Feed(&Parser, p_Response, Length, p_Data[1] * 2654435761u);
+
+    if (Mode == CALDAV_FUZZ_MODE_ICALENDAR) {
+        CalDAV_Parser_iCalendar_End(&Parser);
+    }
+
+    free(p_Buffer);
+
+    return 0;
+}
+
+#if CALDAV_FUZZ_STANDALONE
+/* Number of inputs the mutation driver keeps */
+#define CALDAV_FUZZ_MAX_CORPUS              256
+
+/* Fragments that change the structure of a response more than random bytes do */
+static const char *_CalDAV_Fuzz_Tokens[] = {
+    "<d:response>", "</d:response>", "<response>", "</response>", "<cal:calendar-data>", "</cal:calendar-data>",
+    "<d:href>", "</d:href>", "<d:prop>", "<![CDATA[", "]]>", "<!--", "-->", "&amp;", "&#13;", "&#x1F600;", "&",
+    "<", ">", "\r\n", "\r\n ", "\n\t", "BEGIN:VEVENT\r\n", "END:VEVENT\r\n", "BEGIN:VCALENDAR\r\n",
+    "END:VCALENDAR\r\n", "BEGIN:VTIMEZONE\r\n", "BEGIN:VFREEBUSY\r\n", "END:VFREEBUSY\r\n", "BEGIN:VALARM\r\n",
+    "RRULE:FREQ=DAILY;COUNT=400\r\n", "RRULE:FREQ=MONTHLY;BYDAY=-1FR\r\n", "EXDATE:20260105T100000Z\r\n",
+    "RECURRENCE-ID:20260106T100000Z\r\n", "DTSTART;TZID=\"Europe/Berlin\":20260101T100000\r\n",
+    "DURATION:PT1H\r\n", "FREEBUSY:20260101T100000Z/PT1H,20260101T120000Z/20260101T123000Z\r\n",
+    "SUMMARY:", ";VALUE=DATE:20260101", ":", ";", "\"", "\\",
+};
+
+/** @brief              Changes an input with a few random operations.
+ *  @param p_Input      Input to change
+ *  @param p_Corpus     Inputs to splice from
+ *  @param p_State      Generator state
+ */
+static void _CalDAV_Fuzz_Mutate(std::string *p_Input, const std::vector<std::string> *p_Corpus, uint32_t *p_State)
+{
+    size_t Count = 1 + (_CalDAV_Fuzz_Random(p_State) % 8);
+
+    for (size_t i = 0; i < Count; i++) {
+        size_t Position = (p_Input->size() > CALDAV_FUZZ_HEADER) ?
+                          (CALDAV_FUZZ_HEADER + (_CalDAV_Fuzz_Random(p_State) % (p_Input->size() -
+                                                                                 CALDAV_FUZZ_HEADER))) :
+                          p_Input->size();
+
+        switch (_CalDAV_Fuzz_Random(p_State) % 5) {
+            case 0: {
+                size_t Token = _CalDAV_Fuzz_Random(p_State) %
+                               (sizeof(_CalDAV_Fuzz_Tokens) / sizeof(_CalDAV_Fuzz_Tokens[0]));
+
+                p_Input->insert(Position, _CalDAV_Fuzz_Tokens[Token]);
+                break;
+            }
+            case 1: {
+                p_Input->erase(Position, 1 + (_CalDAV_Fuzz_Random(p_State) % 64));
+                break;
+            }
+            case 2: {
+                if (Position < p_Input->size()) {
+                    (*p_Input)[Position] = (char)_CalDAV_Fuzz_Random(p_State);
+                }
+                break;
+            }
+            case 3: {
+                const std::string &Other = (*p_Corpus)[_CalDAV_Fuzz_Random(p_State) % p_Corpus->size()];
+                size_t From = _CalDAV_Fuzz_Random(p_State) % (Other.size() + 1);
+
+                p_Input->insert(Position, Other, From, _CalDAV_Fuzz_Random(p_State) % 256);
+                break;
+            }
+            default: {
+                p_Input->resize(Position);
+                break;
+            }
+        }
+    }
+
+    /* A new way to parse the result */
+    (*p_Input)[0] = (char)_CalDAV_Fuzz_Random(p_State);
+    (*p_Input)[1] = (char)_CalDAV_Fuzz_Random(p_State);
+}
+
+/* Replays the given files in every parse mode, then runs mutations of them:
+   caldav_parser_fuzz [-runs=N] [-seed=S] <files...> */
+int main(int argc, char **argv)
+{
+    unsigned long Runs = 10000;
+    uint32_t State = 0x12345678;
+    std::vector<std::string> Corpus;
+    size_t Files;
+
+    for (int i = 1; i < argc; i++) {
+        FILE *p_File;
+        std::string Input(CALDAV_FUZZ_HEADER, '\0');
+        char Chunk[4096];
+        size_t Length;
+
+        if (strncmp(argv[i], "-runs=", 6) == 0) {
+            Runs = strtoul(argv[i] + 6, NULL, 10);
+
+            continue;
+        } else if (strncmp(argv[i], "-seed=", 6) == 0) {
+            State = (uint32_t)strtoul(argv[i] + 6, NULL, 10) | 1;
+
+            continue;
+        }
+
+        p_File = fopen(argv[i], "rb");
+        if (p_File == NULL) {
+            fprintf(stderr, "Can not open %s!\n", argv[i]);
+
+            return 1;
+        }
+
+        while ((Length = fread(Chunk, 1, sizeof(Chunk), p_File)) > 0) {
+            Input.append(Chunk, Length);
+        }
+
+        fclose(p_File);
+
+        Corpus.push_back(Input);
+    }
+
+    if (Corpus.empty()) {
+        fprintf(stderr, "Usage: %s [-runs=N] [-seed=S] <files...>\n", argv[0]);
+
+        return 1;
+    }
+
+    Files = Corpus.size();
+
+    for (const std::string &Input : Corpus) {
+        for (size_t Mode = 0; Mode < (CALDAV_FUZZ_MODES * 5); Mode++) {
+            std::string Copy = Input;
+
+            Copy[0] = (char)Mode;
+            Copy[1] = (char)Mode;
+            LLVMFuzzerTestOneInput((const uint8_t *)Copy.data(), Copy.size());
+        }
+    }
+
+    for (unsigned long i = 0; i < Runs; i++) {
+        std::string Input = Corpus[_CalDAV_Fuzz_Random(&State) % Corpus.size()];
+
+        _CalDAV_Fuzz_Mutate(&Input, &Corpus, &State);
+        LLVMFuzzerTestOneInput((const uint8_t *)Input.data(), Input.size());
+
+        /* Mutations of mutations reach deeper, some results replace earlier ones and the files are kept */
+        if ((_CalDAV_Fuzz_Random(&State) % 16) == 0) {
+            if (Corpus.size() < CALDAV_FUZZ_MAX_CORPUS) {
+                Corpus.push_back(Input);
+            } else {
+                Corpus[Files + (_CalDAV_Fuzz_Random(&State) % (Corpus.size() - Files))] = Input;
+            }
+        }
+    }
+
+    printf("%lu runs on %u inputs finished\n", Runs, (unsigned int)Corpus.size());
+
+    return 0;
+}
+#endif
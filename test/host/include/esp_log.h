@@ -0,0 +1,39 @@
+/*
+ * esp_log.h
+ *
+ *  Copyright (C) Daniel Kampert, 2026
+ *  Website: www.kampis-elektroecke.de
+ *  File info: Minimal ESP-IDF log replacement for host builds of the parser.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#ifndef ESP32_CALDAV_HOST_ESP_LOG_H_
+#define ESP32_CALDAV_HOST_ESP_LOG_H_
+
+#include <stdio.h>
+
+/* Log output would dominate the benchmark and the fuzzer, so only errors are printed. The arguments are still
+   checked by the compiler */
+#define CALDAV_HOST_LOG_NONE(Tag, Format, ...)  do { if (0) { printf("%s" Format, Tag, ##__VA_ARGS__); } } while (0)
+
+#define ESP_LOGE(Tag, Format, ...)  fprintf(stderr, "E %s: " Format "\n", Tag, ##__VA_ARGS__)
+#define ESP_LOGW(Tag, Format, ...)  CALDAV_HOST_LOG_NONE(Tag, Format, ##__VA_ARGS__)
+#define ESP_LOGI(Tag, Format, ...)  CALDAV_HOST_LOG_NONE(Tag, Format, ##__VA_ARGS__)
+#define ESP_LOGD(Tag, Format, ...)  CALDAV_HOST_LOG_NONE(Tag, Format, ##__VA_ARGS__)
+#define ESP_LOGV(Tag, Format, ...)  CALDAV_HOST_LOG_NONE(Tag, Format, ##__VA_ARGS__)
+
+#endif /* ESP32_CALDAV_HOST_ESP_LOG_H_ */